@@ -0,0 +1,223 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+
+#include "FlatScene.h"
+#include "Sphere.h"
+#include "Cube.h"
+#include "Plane.h"
+#include "Transformations.h"
+#include "SphereBatch.h"
+
+//Build and trace times of the acceleration structures against the linear scan (Acceleration::None),
+//on a particle cloud of spheres and a block of voxel cubes, each over a ground plane. Then the BVH
+//leaves of the particles, without the plane, one sphere at a time as FlatScene does them against a
+//SphereBatch per leaf.
+//Usage: AccelerationBenchmark [objects] [rays]
+
+static double secondsFor(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+};
+
+class TestScene {
+public:
+    std::string name;
+    std::vector<std::unique_ptr<Object>> storage;
+    std::vector<Object*> objects;
+
+    void add(Object* object) {
+        storage.emplace_back(object);
+        objects.push_back(object);
+    };
+};
+
+static void particles(TestScene &scene, int count, std::mt19937 &random) {
+    std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> radius(0.05f, 0.15f);
+    scene.name = "particles";
+    scene.add(new Plane());
+    for (int i = 0; i < count; i++) {
+        Sphere* sphere = new Sphere();
+        float r = radius(random);
+        sphere->setTransformation(translation(coordinate(random), coordinate(random) + 10.5f, coordinate(random)) * scaling(r, r, r));
+        scene.add(sphere);
+    }
+};
+
+static void voxels(TestScene &scene, int count) {
+    int side = std::max(1, (int)std::cbrt((float)count));
+    scene.name = "voxels";
+    scene.add(new Plane());
+    for (int z = 0; z < side; z++) {
+        for (int y = 0; y < side; y++) {
+            for (int x = 0; x < side; x++) {
+                Cube* cube = new Cube();
+                float step = 20.0f / side;
+                cube->setTransformation(translation(-10.0f + x*step, 0.5f + y*step, -10.0f + z*step) * scaling(0.3f*step, 0.3f*step, 0.3f*step));
+                scene.add(cube);
+            }
+        }
+    }
+};
+
+class Timing {
+public:
+    double build;
+    double trace;
+    int hits;
+    std::vector<float> nearest;
+};
+
+static Timing run(TestScene const &scene, Acceleration acceleration, std::vector<Ray> const &rays, int builds) {
+    Timing timing;
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<FlatScene> flat;
+    for (int i = 0; i < builds; i++) {
+        flat.reset(new FlatScene(scene.objects, PowMode::Exact, acceleration));
+    }
+    timing.build = secondsFor(start) / builds;
+
+    timing.nearest.resize(rays.size());
+    start = std::chrono::steady_clock::now();
+    for (std::vector<Ray>::size_type i = 0; i < rays.size(); i++) {
+        timing.nearest[i] = flat->nearestHit(rays[i]);
+    }
+    timing.trace = secondsFor(start);
+
+    timing.hits = 0;
+    for (float t : timing.nearest) {
+        timing.hits += std::isfinite(t);
+    }
+    return timing;
+};
+
+//the BVH of a FlatScene walked like BVH::traverse, with each leaf's spheres in a SphereBatch
+class BatchedLeaves {
+public:
+    BVH const &bvh;
+    std::vector<SphereBatch> leaves;    //by node, empty for interior nodes
+
+    BatchedLeaves(FlatScene const &flat) : bvh(flat.bvh), leaves(flat.bvh.nodes.size()) {
+        for (std::vector<BVHNode>::size_type node = 0; node < bvh.nodes.size(); node++) {
+            for (int i = bvh.nodes[node].first; i < bvh.nodes[node].first + bvh.nodes[node].count; i++) {
+                FlatShape const &shape = flat.spheres[flat.bounded[bvh.primitives[i]].index];
+                Matrix inverse(4);
+                for (int j = 0; j < 16; j++) {
+                    inverse.array[j] = shape.inverse.m[j];
+                }
+                leaves[node].add(shape.object, inverse);
+            }
+        }
+    };
+
+    float nearest(Ray ray) const {
+        int stack[BVH::maxDepth];
+        int top = 0;
+        int index = 0;
+        while (true) {
+            BVHNode const &node = bvh.nodes[index];
+            float near, far;
+            if (slabIntersect(node.bounds, ray, near, far) && far > ray.tMin && near < ray.tMax) {
+                if (node.count == 0) {
+                    int nearChild = index + 1;
+                    int farChild = node.first;
+                    if (ray.sign[node.axis]) {
+                        std::swap(nearChild, farChild);
+                    }
+                    stack[top++] = farChild;
+                    index = nearChild;
+                    continue;
+                }
+                ray.tMax = leaves[index].nearest(ray);
+            }
+            if (top == 0) {
+                return ray.tMax;
+            }
+            index = stack[--top];
+        }
+    };
+};
+
+//scalar leaves against batched ones on the same BVH, returns the rays whose nearest hits differ
+static int compareLeaves(std::vector<Object*> const &spheres, std::vector<Ray> const &rays) {
+    FlatScene flat(spheres);
+    BatchedLeaves batched(flat);
+
+    std::vector<float> scalar(rays.size()), grouped(rays.size());
+    auto start = std::chrono::steady_clock::now();
+    for (std::vector<Ray>::size_type i = 0; i < rays.size(); i++) {
+        scalar[i] = flat.nearestHit(rays[i]);
+    }
+    double scalarTime = secondsFor(start);
+    start = std::chrono::steady_clock::now();
+    for (std::vector<Ray>::size_type i = 0; i < rays.size(); i++) {
+        grouped[i] = batched.nearest(rays[i]);
+    }
+    double batchedTime = secondsFor(start);
+
+    int mismatches = 0;
+    for (std::vector<Ray>::size_type i = 0; i < rays.size(); i++) {
+        mismatches += scalar[i] != grouped[i];
+    }
+    std::cout << "  bvh leaves of " << spheres.size() << " spheres (up to " << BVH::leafSize << " per leaf, "
+        << (SphereBatch::usingAVX() ? "AVX" : "no AVX") << ")\n"
+        << "    scalar   trace " << std::setw(9) << scalarTime / rays.size() * 1e9 << " ns/ray\n"
+        << "    batched  trace " << std::setw(9) << batchedTime / rays.size() * 1e9 << " ns/ray"
+        << "  " << std::setw(7) << scalarTime / batchedTime << "x\n";
+    return mismatches;
+};
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int rayCount = argc > 2 ? std::atoi(argv[2]) : 100000;
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> spread(-12.0f, 12.0f);
+    std::vector<Ray> rays;
+    for (int i = 0; i < rayCount; i++) {
+        Tuple origin = Tuple::Point(spread(random), 12.0f + spread(random)*0.5f, -30.0f);
+        Tuple target = Tuple::Point(spread(random), spread(random) + 10.0f, spread(random));
+        rays.push_back(Ray(origin, normalize(target - origin)));
+    }
+
+    TestScene scenes[2];
+    particles(scenes[0], count, random);
+    voxels(scenes[1], count);
+
+    char const* names[] = {"linear", "bvh", "grid"};
+    Acceleration modes[] = {Acceleration::None, Acceleration::BVH, Acceleration::Grid};
+    int mismatches = 0;
+
+    std::cout << std::fixed << std::setprecision(2) << rayCount << " rays\n";
+    for (TestScene const &scene : scenes) {
+        std::cout << "  " << scene.name << ", " << scene.objects.size() << " objects\n";
+        Timing linear;
+        for (int mode = 0; mode < 3; mode++) {
+            //building for the linear scan only groups the shapes, repeat it for a measurable time
+            Timing timing = run(scene, modes[mode], rays, mode == 0 ? 10 : 3);
+            if (mode == 0) {
+                linear = timing;
+            }
+            for (std::vector<Ray>::size_type i = 0; i < rays.size(); i++) {
+                mismatches += timing.nearest[i] != linear.nearest[i];
+            }
+            std::cout << "    " << std::setw(6) << names[mode]
+                << "  build " << std::setw(9) << timing.build * 1e3 << " ms"
+                << "  trace " << std::setw(9) << timing.trace / rays.size() * 1e9 << " ns/ray"
+                << "  " << std::setw(7) << linear.trace / timing.trace << "x"
+                << "  " << timing.hits << " hits\n";
+        }
+    }
+    std::cout << "  " << mismatches << " nearest hits differ from the linear scan\n";
+
+    std::vector<Object*> spheres(scenes[0].objects.begin() + 1, scenes[0].objects.end());
+    int leafMismatches = compareLeaves(spheres, rays);
+    std::cout << "  " << leafMismatches << " nearest hits differ between the leaf paths\n";
+    mismatches += leafMismatches;
+    return mismatches == 0 ? 0 : 1;
+}
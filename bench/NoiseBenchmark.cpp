@@ -0,0 +1,82 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdlib>
+
+#include "Noise.h"
+
+//Perlin noise and fBm over a block of random points, the scalar reference against the AVX2 path.
+//Usage: NoiseBenchmark [points] [repeats]
+
+static double secondsFor(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+};
+
+class Timing {
+public:
+    double perlin;
+    double fbm;
+};
+
+static Timing run(std::vector<float> const &x, std::vector<float> const &y, std::vector<float> const &z,
+                  std::vector<Tuple> const &points, std::vector<float> &values, int repeats) {
+    int count = x.size();
+    Timing timing;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        perlin(x.data(), y.data(), z.data(), values.data(), count);
+    }
+    timing.perlin = secondsFor(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        fbm(points.data(), values.data(), count, 4);
+    }
+    timing.fbm = secondsFor(start);
+    return timing;
+};
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> coordinate(-64.0f, 64.0f);
+    std::vector<float> x(count), y(count), z(count);
+    std::vector<Tuple> points(count);
+    for (int i = 0; i < count; i++) {
+        x[i] = coordinate(random);
+        y[i] = coordinate(random);
+        z[i] = coordinate(random);
+        points[i] = Tuple::Point(x[i], y[i], z[i]);
+    }
+
+    std::vector<float> scalarValues(count), simdValues(count);
+    enableNoiseAVX2(false);
+    Timing scalar = run(x, y, z, points, scalarValues, repeats);
+    enableNoiseAVX2(true);
+    if (!usingNoiseAVX2()) {
+        std::cout << "no AVX2 on this CPU, only the scalar path ran\n";
+    }
+    Timing simd = run(x, y, z, points, simdValues, repeats);
+
+    int mismatches = 0;
+    for (int i = 0; i < count; i++) {
+        mismatches += scalarValues[i] != simdValues[i];
+    }
+
+    double evaluations = (double)count * repeats;
+    std::cout << std::fixed << std::setprecision(2)
+        << count << " points x " << repeats << "\n"
+        << "  perlin  scalar " << std::setw(8) << scalar.perlin / evaluations * 1e9 << " ns/point"
+        << "  avx2 " << std::setw(8) << simd.perlin / evaluations * 1e9 << " ns/point"
+        << "  " << scalar.perlin / simd.perlin << "x\n"
+        << "  fbm x4  scalar " << std::setw(8) << scalar.fbm / evaluations * 1e9 << " ns/point"
+        << "  avx2 " << std::setw(8) << simd.fbm / evaluations * 1e9 << " ns/point"
+        << "  " << scalar.fbm / simd.fbm << "x\n"
+        << "  " << mismatches << " values differ between the paths\n";
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+#include "BVH.h"
+
+#include <algorithm>
+#include <numeric>
+
+const int BVH::leafSize;
+const int BVH::maxDepth;
+
+static float component(Tuple const &tuple, int axis) {
+    return axis == 0 ? tuple.x : (axis == 1 ? tuple.y : tuple.z);
+};
+
+static float surfaceArea(Bounds const &box) {
+    if (box.empty()) {
+        return 0.0f;
+    }
+    Tuple size = box.max - box.min;
+    return 2.0f*(size.x*size.y + size.y*size.z + size.z*size.x);
+};
+
+void BVH::build(std::vector<Bounds> const &boxes) {
+    nodes.clear();
+    primitives.resize(boxes.size());
+    std::iota(primitives.begin(), primitives.end(), 0);
+    if (boxes.empty()) {
+        return;
+    }
+
+    std::vector<Bounds> padded(boxes);
+    std::vector<Tuple> centroids(boxes.size());
+    Tuple pad = Tuple::Vector(EPSILON, EPSILON, EPSILON);
+    for (std::vector<Bounds>::size_type i = 0; i < boxes.size(); i++) {
+        padded[i].min = padded[i].min - pad;
+        padded[i].max = padded[i].max + pad;
+        centroids[i] = (padded[i].min + padded[i].max) * 0.5f;
+    }
+
+    nodes.reserve(2*boxes.size());
+    buildNode(padded, centroids, 0, boxes.size(), 1);
+};
+
+int BVH::buildNode(std::vector<Bounds> const &boxes, std::vector<Tuple> const &centroids, int begin, int end, int depth) {
+    int index = nodes.size();
+    nodes.push_back(BVHNode());
+
+    Bounds box;
+    Bounds centroidBox;
+    for (int i = begin; i < end; i++) {
+        box.add(boxes[primitives[i]]);
+        centroidBox.add(centroids[primitives[i]]);
+    }
+    nodes[index].bounds = box;
+    nodes[index].first = begin;
+    nodes[index].count = end - begin;
+    nodes[index].axis = 0;
+
+    int count = end - begin;
+    if (count <= leafSize) {
+        return index;
+    }
+
+    Tuple extent = centroidBox.max - centroidBox.min;
+    int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    float low = component(centroidBox.min, axis);
+    float high = component(centroidBox.max, axis);
+    if (high <= low) {
+        //every centroid in the same place, no split separates them
+        return index;
+    }
+
+    //sort the centroids into bins along the axis and pick the boundary with the lowest SAH cost
+    const int bins = 12;
+    Bounds binBounds[bins];
+    int binCount[bins] = {0};
+    float scale = bins / (high - low);
+    auto binOf = [&](int primitive) {
+        return std::min(bins - 1, (int)((component(centroids[primitive], axis) - low) * scale));
+    };
+    for (int i = begin; i < end; i++) {
+        int bin = binOf(primitives[i]);
+        binBounds[bin].add(boxes[primitives[i]]);
+        binCount[bin]++;
+    }
+
+    float rightArea[bins];
+    int rightCount[bins];
+    Bounds right;
+    int inRight = 0;
+    for (int bin = bins - 1; bin > 0; bin--) {
+        right.add(binBounds[bin]);
+        inRight += binCount[bin];
+        rightArea[bin] = surfaceArea(right);
+        rightCount[bin] = inRight;
+    }
+
+    int bestSplit = -1;
+    float bestCost = 0.0f;
+    Bounds left;
+    int inLeft = 0;
+    for (int bin = 0; bin < bins - 1; bin++) {
+        left.add(binBounds[bin]);
+        inLeft += binCount[bin];
+        if (inLeft == 0 || rightCount[bin + 1] == 0) {
+            continue;
+        }
+        float cost = surfaceArea(left)*inLeft + rightArea[bin + 1]*rightCount[bin + 1];
+        if (bestSplit < 0 || cost < bestCost) {
+            bestSplit = bin;
+            bestCost = cost;
+        }
+    }
+
+    int* first = primitives.data() + begin;
+    int* last = primitives.data() + end;
+    int* middle;
+    if (bestSplit >= 0 && depth < maxDepth/2) {
+        middle = std::partition(first, last, [&](int primitive) {
+            return binOf(primitive) <= bestSplit;
+        });
+    } else {
+        //deep trees split at the median, which bounds the depth the traversal stack has to hold
+        middle = first + count/2;
+        std::nth_element(first, middle, last, [&](int a, int b) {
+            return component(centroids[a], axis) < component(centroids[b], axis);
+        });
+    }
+    int split = middle - primitives.data();
+
+    nodes[index].count = 0;
+    nodes[index].axis = axis;
+    buildNode(boxes, centroids, begin, split, depth + 1);
+    int second = buildNode(boxes, centroids, split, end, depth + 1);
+    nodes[index].first = second;
+    return index;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "Bounds.h"
+#include "Ray.h"
+
+class BVHNode {
+public:
+    Bounds bounds;
+    int first;      //leaf: first of its entries in BVH::primitives, interior: index of the second child
+    int count;      //primitives in a leaf, 0 for interior nodes, whose first child follows them
+    int axis;       //split axis of an interior node, its first child is on the low side
+};
+
+//Bounding volume hierarchy over boxes the caller numbers 0..n-1, built with a binned surface area
+//heuristic. Nodes are stored depth first in one array and walked with a fixed stack, nearer child
+//first, so finding hits along a ray allocates nothing.
+class BVH {
+public:
+    static const int leafSize = 4;
+    static const int maxDepth = 64;
+
+    std::vector<BVHNode> nodes;
+    std::vector<int> primitives;    //leaf ranges, indices of the boxes given to build()
+
+    //boxes are padded by EPSILON, so flat ones such as disks keep some volume
+    void build(std::vector<Bounds> const &boxes);
+
+    //calls visit(primitive) for every primitive in a leaf whose box the ray passes through within
+    //(tMin, tMax). `tMax` is read again after each leaf, a visitor looking for the nearest hit
+    //shrinks it to skip what lies behind.
+    template <class Visit>
+    void traverse(Ray const &ray, float tMin, float const &tMax, Visit &&visit) const {
+        if (nodes.empty()) {
+            return;
+        }
+        int stack[maxDepth];
+        int top = 0;
+        int index = 0;
+        while (true) {
+            BVHNode const &node = nodes[index];
+            float near, far;
+            if (slabIntersect(node.bounds, ray, near, far) && far > tMin && near < tMax) {
+                if (node.count == 0) {
+                    int nearChild = index + 1;
+                    int farChild = node.first;
+                    if (ray.sign[node.axis]) {
+                        std::swap(nearChild, farChild);
+                    }
+                    stack[top++] = farChild;
+                    index = nearChild;
+                    continue;
+                }
+                for (int i = node.first; i < node.first + node.count; i++) {
+                    visit(primitives[i]);
+                }
+            }
+            if (top == 0) {
+                return;
+            }
+            index = stack[--top];
+        }
+    };
+
+private:
+    int buildNode(std::vector<Bounds> const &boxes, std::vector<Tuple> const &centroids, int begin, int end, int depth);
+};
@@ -0,0 +1,100 @@
+#include "Bounds.h"
+#include "Ray.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE__) || defined(_M_X64)
+#define BOUNDS_SSE
+#include <xmmintrin.h>
+#endif
+
+static const float infinity = std::numeric_limits<float>::infinity();
+
+Bounds::Bounds() : min(Tuple::Point(infinity, infinity, infinity)), max(Tuple::Point(-infinity, -infinity, -infinity)) {};
+
+Bounds::Bounds(Tuple const &min, Tuple const &max) : min(min), max(max) {};
+
+Bounds Bounds::Infinite() {
+    return {Tuple::Point(-infinity, -infinity, -infinity), Tuple::Point(infinity, infinity, infinity)};
+};
+
+bool Bounds::empty() const {
+    return min.x > max.x || min.y > max.y || min.z > max.z;
+};
+
+bool Bounds::finite() const {
+    return std::isfinite(min.x) && std::isfinite(min.y) && std::isfinite(min.z) &&
+           std::isfinite(max.x) && std::isfinite(max.y) && std::isfinite(max.z);
+};
+
+void Bounds::add(Tuple const &point) {
+    min = Tuple::Point(std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z));
+    max = Tuple::Point(std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z));
+};
+
+void Bounds::add(Bounds const &other) {
+    if (!other.empty()) {
+        add(other.min);
+        add(other.max);
+    }
+};
+
+Bounds Bounds::transform(Matrix const &transform) const {
+    if (empty()) {
+        return *this;
+    }
+    if (!finite()) {
+        //a corner at infinity times a zero matrix entry has no meaningful image
+        return Infinite();
+    }
+
+    Bounds result;
+    for (int corner = 0; corner < 8; corner++) {
+        Tuple point = Tuple::Point(corner & 1 ? max.x : min.x, corner & 2 ? max.y : min.y, corner & 4 ? max.z : min.z);
+        result.add(transform * point);
+    }
+    return result;
+};
+
+
+//Out of class
+
+bool slabIntersect(Bounds const &box, Tuple const &origin, Tuple const &invDirection, float &tmin, float &tmax) {
+#ifdef BOUNDS_SSE
+    //the fourth lane repeats x so it never changes the reductions below
+    __m128 o = _mm_set_ps(origin.x, origin.z, origin.y, origin.x);
+    __m128 inv = _mm_set_ps(invDirection.x, invDirection.z, invDirection.y, invDirection.x);
+    __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set_ps(box.min.x, box.min.z, box.min.y, box.min.x), o), inv);
+    __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set_ps(box.max.x, box.max.z, box.max.y, box.max.x), o), inv);
+
+    __m128 near = _mm_min_ps(t0, t1);
+    __m128 far = _mm_max_ps(t0, t1);
+
+    //horizontal max of near and min of far
+    near = _mm_max_ps(near, _mm_shuffle_ps(near, near, _MM_SHUFFLE(2, 3, 0, 1)));
+    near = _mm_max_ps(near, _mm_shuffle_ps(near, near, _MM_SHUFFLE(1, 0, 3, 2)));
+    far = _mm_min_ps(far, _mm_shuffle_ps(far, far, _MM_SHUFFLE(2, 3, 0, 1)));
+    far = _mm_min_ps(far, _mm_shuffle_ps(far, far, _MM_SHUFFLE(1, 0, 3, 2)));
+
+    tmin = _mm_cvtss_f32(near);
+    tmax = _mm_cvtss_f32(far);
+#else
+    float tx0 = (box.min.x - origin.x) * invDirection.x, tx1 = (box.max.x - origin.x) * invDirection.x;
+    float ty0 = (box.min.y - origin.y) * invDirection.y, ty1 = (box.max.y - origin.y) * invDirection.y;
+    float tz0 = (box.min.z - origin.z) * invDirection.z, tz1 = (box.max.z - origin.z) * invDirection.z;
+
+    tmin = std::max({std::min(tx0, tx1), std::min(ty0, ty1), std::min(tz0, tz1)});
+    tmax = std::min({std::max(tx0, tx1), std::max(ty0, ty1), std::max(tz0, tz1)});
+#endif
+    return tmin < tmax;
+};
+
+bool slabIntersect(Bounds const &box, Ray const &ray, float &tmin, float &tmax) {
+    return slabIntersect(box, ray.origin, ray.invDirection, tmin, tmax);
+};
+
+Tuple reciprocal(Tuple const &direction) {
+    return {1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z, 0.0f};
+};
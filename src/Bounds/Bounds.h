@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Tuple.h"
+#include "Matrix.h"
+
+class Ray;
+
+//axis-aligned box, `min` and `max` are points. Unbounded axes use infinities.
+class Bounds {
+public:
+    Tuple min;
+    Tuple max;
+
+    //empty box, adding anything to it gives that thing's bounds
+    Bounds();
+    Bounds(Tuple const &min, Tuple const &max);
+
+    static Bounds Infinite();
+
+    bool empty() const;
+    bool finite() const;
+
+    void add(Tuple const &point);
+    void add(Bounds const &other);
+
+    //bounds of the box's 8 corners after `transform`, infinite boxes stay infinite
+    Bounds transform(Matrix const &transform) const;
+};
+
+//Slab test against `box` for a ray given by its origin and per axis reciprocal direction (1/0 gives
+//the infinities the test expects). Branchless, SSE on x86. Writes where the ray enters and leaves the
+//box and returns tmin < tmax; both may be negative. Serves shapes and acceleration structure nodes alike.
+bool slabIntersect(Bounds const &box, Tuple const &origin, Tuple const &invDirection, float &tmin, float &tmax);
+
+//the same with the reciprocal the ray carries, not clipped to the ray's t range
+bool slabIntersect(Bounds const &box, Ray const &ray, float &tmin, float &tmax);
+
+//component-wise 1/direction
+Tuple reciprocal(Tuple const &direction);
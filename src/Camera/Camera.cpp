@@ -1,8 +1,30 @@
 #include <cmath>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <stdexcept>
 
 #include "Camera.h"
+#include "Stats.h"
+#include "Trace.h"
+#include "Checkpoint.h"
 
-#define MAX_BOUNCES 3
+RenderRegion::RenderRegion(int x, int y, int width, int height) : x(x), y(y), width(width), height(height) {};
+
+bool RenderRegion::empty() const {
+    return width <= 0 || height <= 0;
+};
+
+bool RenderRegion::operator== (RenderRegion const &other) const {
+    return x == other.x && y == other.y && width == other.width && height == other.height;
+};
+
+RenderSettings::RenderSettings(int threads, int samples, int maxBounces, int tileSize) :
+    threads(threads), samples(samples), maxBounces(maxBounces), tileSize(tileSize), resume(false), sceneHash(0),
+    layout(CanvasLayout::Tiled), specular(PowMode::Exact), acceleration(Acceleration::BVH) {};
 
 Camera::Camera(int hsize, int vsize, float fieldOfView) : 
     hsize(hsize), vsize(vsize), fieldOfView(fieldOfView), transform(Matrix::Identity(4)) {
@@ -25,13 +47,16 @@ void Camera::calculateSizes() {
 };
 
 Ray Camera::rayForPixel(int x, int y) const {
-    float xOffset = (x + 0.5f) * pixelSize;
-    float yOffset = (y + 0.5f) * pixelSize;
+    return rayForPixel(x, y, 0.5f, 0.5f, inverse(transform));
+};
+
+Ray Camera::rayForPixel(int x, int y, float offsetX, float offsetY, Matrix const &invTransform) const {
+    float xOffset = (x + offsetX) * pixelSize;
+    float yOffset = (y + offsetY) * pixelSize;
 
     float worldX = halfWidth - xOffset;
     float worldY = halfHeight - yOffset;
 
-    Matrix invTransform = inverse(transform);
     Tuple rayOrigin = invTransform * Tuple::Point(0.0f, 0.0f, 0.0f);
     Tuple pixel = invTransform * Tuple::Point(worldX, worldY, -1);
     Tuple rayDirection = normalize(pixel - rayOrigin);
@@ -40,15 +65,197 @@ Ray Camera::rayForPixel(int x, int y) const {
 };
 
 Canvas render(Camera const &camera, World const &world) {
-	Canvas canvas(camera.hsize, camera.vsize);
-
-	//compute color for each pixel
-	for(int y = 0; y < camera.vsize; y++) {
-		for(int x = 0; x < camera.hsize; x++) {
-			Ray ray = camera.rayForPixel(x, y);
-            Color color = colorAt(world, ray, MAX_BOUNCES);
-            canvas.writePixel(x, y, color);
+    return render(camera, world, RenderSettings());
+};
+
+Canvas render(Camera const &camera, World const &world, RenderSettings const &settings) {
+    RenderRegion frame = boundingRegion(renderRegions(camera, settings));
+    Canvas canvas(frame.width, frame.height, settings.layout);
+    renderInto(camera, world, settings, canvas);
+    return canvas;
+};
+
+void renderInto(Camera const &camera, World const &world, RenderSettings const &settings, Framebuffer &canvas) {
+    TraceSpan span("render");
+    resetRenderStats();
+
+    std::vector<RenderRegion> regions = renderRegions(camera, settings);
+    RenderRegion frame = boundingRegion(regions);
+    if (canvas.width != frame.width || canvas.height != frame.height) {
+        throw std::invalid_argument("framebuffer is " + std::to_string(canvas.width) + "x" + std::to_string(canvas.height) + 
+                                    ", the render needs " + std::to_string(frame.width) + "x" + std::to_string(frame.height));
+    }
+
+    std::vector<RenderRegion> tiles = makeTiles(regions, settings.tileSize);
+
+    //the caller's world stays as authored, the threads share a compiled copy
+    World compiled = world;
+    {
+        TraceSpan span("acceleration build");
+        compiled.compile(settings.specular, settings.acceleration);
+    }
+
+    std::unique_ptr<CheckpointWriter> checkpoint;
+    if (!settings.checkpointPath.empty()) {
+        CheckpointHeader header(camera, frame, settings);
+
+        if (settings.resume) {
+            std::map<std::pair<int, int>, RenderRegion> remaining;
+            for (RenderRegion const &tile : tiles) {
+                remaining[{tile.x, tile.y}] = tile;
+            }
+            for (CheckpointTile const &done : loadCheckpoint(settings.checkpointPath, header)) {
+                auto tile = remaining.find({done.region.x, done.region.y});
+                if (tile != remaining.end() && tile->second == done.region) {
+                    restoreTile(done, canvas, frame.x, frame.y);
+                    canvas.regionDone(done.region.x - frame.x, done.region.y - frame.y, done.region.width, done.region.height);
+                    remaining.erase(tile);
+                }
+            }
+            tiles.clear();
+            for (auto const &tile : remaining) {
+                tiles.push_back(tile.second);
+            }
+            std::sort(tiles.begin(), tiles.end(), [](RenderRegion const &a, RenderRegion const &b) {
+                return a.y < b.y || (a.y == b.y && a.x < b.x);
+            });
+        }
+
+        checkpoint.reset(new CheckpointWriter(settings.checkpointPath, header, settings.resume));
+    }
+    int tileCount = tiles.size();
+
+    //threads pull tiles from a shared counter until none are left
+    std::atomic<int> nextTile(0);
+    auto worker = [&](int index) {
+        if (index > 0) {
+            nameTraceThread("render thread " + std::to_string(index));
+        }
+
+        for (int tile = nextTile++; tile < tileCount; tile = nextTile++) {
+            //a render that can no longer be checkpointed stops, see below
+            if (checkpoint && !checkpoint->error().empty()) {
+                break;
+            }
+            renderTile(camera, compiled, tiles[tile], settings, canvas, frame.x, frame.y);
+            if (checkpoint) {
+                checkpoint->push(tiles[tile], settings.samples, canvas, frame.x, frame.y);
+            }
+            canvas.regionDone(tiles[tile].x - frame.x, tiles[tile].y - frame.y, tiles[tile].width, tiles[tile].height);
+        }
+        flushThreadStats();
+    };
+
+    int threads = settings.threads > 0 ? settings.threads : (int)std::thread::hardware_concurrency();
+    threads = std::max(1, std::min(threads, tileCount));
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; i++) {
+        pool.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto &thread : pool) {
+        thread.join();
+    }
+
+    //the writer thread cannot throw to the caller itself
+    if (checkpoint) {
+        checkpoint->flush();
+        std::string error = checkpoint->error();
+        if (!error.empty()) {
+            throw std::runtime_error(error);
+        }
+    }
+};
+
+void renderTile(Camera const &camera, World const &world, RenderRegion const &tile, RenderSettings const &settings, 
+                Framebuffer &canvas, int originX, int originY) {
+    TraceSpan span("tile", "render", tracingEnabled() ? "\"x\": " + std::to_string(tile.x) + ", \"y\": " + std::to_string(tile.y) : "");
+
+    Matrix invTransform = inverse(camera.transform);
+    int samples = std::max(1, settings.samples);
+
+    for (int y = tile.y; y < tile.y + tile.height; y++) {
+        for (int x = tile.x; x < tile.x + tile.width; x++) {
+            Color color(0.0f, 0.0f, 0.0f);
+            for (int s = 0; s < samples; s++) {
+                float offsetX, offsetY;
+                sampleOffset(s, samples, offsetX, offsetY);
+                Ray ray = camera.rayForPixel(x, y, offsetX, offsetY, invTransform);
+                STATS_COUNT(PrimaryRays);
+                color = color + colorAt(world, ray, settings.maxBounces);
+            }
+            canvas.writePixel(x - originX, y - originY, color * (1.0f / samples));
+        }
+    }
+};
+
+std::vector<RenderRegion> renderRegions(Camera const &camera, RenderSettings const &settings) {
+    if (settings.regions.empty()) {
+        return {RenderRegion(0, 0, camera.hsize, camera.vsize)};
+    }
+
+    std::vector<RenderRegion> regions;
+    for (RenderRegion const &region : settings.regions) {
+        int x0 = std::max(region.x, 0);
+        int y0 = std::max(region.y, 0);
+        int x1 = std::min(region.x + region.width, camera.hsize);
+        int y1 = std::min(region.y + region.height, camera.vsize);
+        RenderRegion clipped(x0, y0, x1 - x0, y1 - y0);
+        if (!clipped.empty()) {
+            regions.push_back(clipped);
+        }
+    }
+    return regions;
+};
+
+RenderRegion boundingRegion(std::vector<RenderRegion> const &regions) {
+    if (regions.empty()) {
+        return {};
+    }
+
+    int x0 = regions[0].x, y0 = regions[0].y;
+    int x1 = x0 + regions[0].width, y1 = y0 + regions[0].height;
+    for (RenderRegion const &region : regions) {
+        x0 = std::min(x0, region.x);
+        y0 = std::min(y0, region.y);
+        x1 = std::max(x1, region.x + region.width);
+        y1 = std::max(y1, region.y + region.height);
+    }
+    return {x0, y0, x1 - x0, y1 - y0};
+};
+
+std::vector<RenderRegion> makeTiles(std::vector<RenderRegion> const &regions, int tileSize) {
+    tileSize = std::max(1, tileSize);
+
+    std::vector<RenderRegion> tiles;
+    for (RenderRegion const &region : regions) {
+        for (int y = region.y; y < region.y + region.height; y += tileSize) {
+            for (int x = region.x; x < region.x + region.width; x += tileSize) {
+                int width = std::min(tileSize, region.x + region.width - x);
+                int height = std::min(tileSize, region.y + region.height - y);
+                tiles.push_back({x, y, width, height});
+            }
         }
-	}
-    return canvas; 
-};
\ No newline at end of file
+    }
+    return tiles;
+};
+
+void sampleOffset(int index, int samples, float &offsetX, float &offsetY) {
+    if (samples <= 1) {
+        offsetX = 0.5f;
+        offsetY = 0.5f;
+        return;
+    }
+
+    //Hammersley point set: stratified in x, base-2 radical inverse in y
+    unsigned int bits = index;
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+
+    offsetX = (index + 0.5f) / samples;
+    offsetY = (float)(bits * 2.3283064365386963e-10);
+};
@@ -5,6 +5,44 @@
 #include "Canvas.h"
 #include "World.h"
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//rectangle of pixels, in frame coordinates
+class RenderRegion {
+public:
+    int x, y;
+    int width, height;
+
+    RenderRegion(int x = 0, int y = 0, int width = 0, int height = 0);
+
+    bool empty() const;
+    bool operator== (RenderRegion const &other) const;
+};
+
+class RenderSettings {
+public:
+    int threads;    //0 -> one per hardware thread
+    int samples;    //samples per pixel
+    int maxBounces;
+    int tileSize;   //edge of the square tiles handed to the render threads
+
+    //crop window or bucket list, empty -> full frame. The canvas covers their bounding box
+    //and pixels of the box outside every region stay black.
+    std::vector<RenderRegion> regions;
+
+    std::string checkpointPath; //non-empty -> append finished tiles to this file while rendering
+    bool resume;                //skip the tiles already in checkpointPath
+    std::uint64_t sceneHash;    //identifies the scene, so checkpoints of another one are not resumed (0: unknown)
+
+    CanvasLayout layout;        //of the canvas render() returns, tiled keeps threads off each other's cache lines
+    PowMode specular;           //speed/accuracy of the specular highlights, Exact for final renders
+    Acceleration acceleration;  //how rays find the shapes they hit, None only to compare against
+
+    RenderSettings(int threads = 0, int samples = 1, int maxBounces = 3, int tileSize = 32);
+};
+
 class Camera {
 public:
     int hsize;
@@ -19,8 +57,33 @@ public:
 
     Ray rayForPixel(int x, int y) const;
 
+    //offsets are the sub-pixel position of the sample, (0.5, 0.5) being the pixel center
+    Ray rayForPixel(int x, int y, float offsetX, float offsetY, Matrix const &invTransform) const;
+
 private:
     void calculateSizes();
 };
 
-Canvas render(Camera const &camera, World const &world);
\ No newline at end of file
+Canvas render(Camera const &camera, World const &world);
+
+//throws std::runtime_error when the checkpoint file cannot be written, stopping at the next tile
+Canvas render(Camera const &camera, World const &world, RenderSettings const &settings);
+
+//same as render() but into any framebuffer the size of the regions' bounding box
+void renderInto(Camera const &camera, World const &world, RenderSettings const &settings, Framebuffer &target);
+
+//renders the pixels of `tile` into `target`, whose pixel (0, 0) is frame pixel (originX, originY).
+//Works on any world, render() hands it a compiled one (see World::compile).
+void renderTile(Camera const &camera, World const &world, RenderRegion const &tile, RenderSettings const &settings, 
+                Framebuffer &target, int originX, int originY);
+
+//settings.regions clipped to the frame, or the full frame when there are none
+std::vector<RenderRegion> renderRegions(Camera const &camera, RenderSettings const &settings);
+
+RenderRegion boundingRegion(std::vector<RenderRegion> const &regions);
+
+//splits each region into row-major tiles of at most tileSize x tileSize
+std::vector<RenderRegion> makeTiles(std::vector<RenderRegion> const &regions, int tileSize);
+
+//sub-pixel offset of sample `index` out of `samples`, in [0, 1)
+void sampleOffset(int index, int samples, float &offsetX, float &offsetY);
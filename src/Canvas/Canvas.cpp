@@ -1,22 +1,87 @@
 #include <cmath>
+#include <cstdint>
+#include <new>
 #include <iostream>
 #include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
 
 #include "Canvas.h"
 #include "Color.h"
+#include "PNG.h"
+#include "Trace.h"
 
-Canvas::Canvas(int width, int height) : width(width), height(height), arrayOfPixels(new Color[width*height]){}
+const int Canvas::tileEdge;
+
+static const std::align_val_t cacheLine{64};
+
+Canvas::Canvas(int width, int height, CanvasLayout layout) : Framebuffer(width, height), layout(layout),
+    tilesPerRow((width + tileEdge - 1) / tileEdge) {
+    pixels = new (cacheLine) float[channelCount()]();
+}
+
+Canvas::Canvas(Canvas &&other) : Framebuffer(other.width, other.height), layout(other.layout), pixels(other.pixels),
+    tilesPerRow(other.tilesPerRow) {
+    other.width = 0;
+    other.height = 0;
+    other.pixels = nullptr;
+}
 
 Canvas::~Canvas() {
-    delete[] arrayOfPixels;
+    ::operator delete[](pixels, cacheLine);
 }
 
+std::size_t Canvas::channelCount() const {
+    if (layout == CanvasLayout::Tiled) {
+        int tileRows = (height + tileEdge - 1) / tileEdge;
+        return (std::size_t)tilesPerRow*tileRows*tileEdge*tileEdge*3;
+    }
+    return (std::size_t)width*height*3;
+};
+
+std::size_t Canvas::offset(int x, int y) const {
+    if (layout == CanvasLayout::Tiled) {
+        //8*8*3 floats per tile = 12 cache lines, so tiles never share one
+        std::size_t tile = (std::size_t)(y / tileEdge)*tilesPerRow + x / tileEdge;
+        return (tile*tileEdge*tileEdge + (y % tileEdge)*tileEdge + x % tileEdge)*3;
+    }
+    return ((std::size_t)width*y + x)*3;
+};
+
 Color Canvas::pixelAt(int x, int y) const {
-    return arrayOfPixels[width*y + x];
+    float const *p = &pixels[offset(x, y)];
+    return {p[0], p[1], p[2]};
 }
 
 void Canvas::writePixel(int x, int y, Color const& color){
-    arrayOfPixels[width*y + x] = color;
+    float *p = &pixels[offset(x, y)];
+    p[0] = color.red;
+    p[1] = color.green;
+    p[2] = color.blue;
+};
+
+void Canvas::readRow(int y, float* rgb) const {
+    if (layout == CanvasLayout::RowMajor) {
+        std::copy(pixels + offset(0, y), pixels + offset(0, y) + width*3, rgb);
+        return;
+    }
+    //a tile row at a time
+    for (int x = 0; x < width; x += tileEdge) {
+        int count = std::min(tileEdge, width - x)*3;
+        std::copy(pixels + offset(x, y), pixels + offset(x, y) + count, rgb + x*3);
+    }
+};
+
+void Canvas::writeRow(int y, float const* rgb) {
+    if (layout == CanvasLayout::RowMajor) {
+        std::copy(rgb, rgb + width*3, pixels + offset(0, y));
+        return;
+    }
+    for (int x = 0; x < width; x += tileEdge) {
+        int count = std::min(tileEdge, width - x)*3;
+        std::copy(rgb + x*3, rgb + x*3 + count, pixels + offset(x, y));
+    }
 };
 
 void Canvas::fill(Color const& color){
@@ -32,18 +97,20 @@ void Canvas::fill(Color const& color){
 
 std::stringstream canvasToPPM(Canvas const &canvas) {
     std::stringstream ppm;
-
-    writeHeader(ppm, canvas.width, canvas.height);
-    writeBody(ppm, canvas);
-
+    writePPM(ppm, canvas);
     return ppm;
 };
 
-static void writeHeader(std::stringstream &ss, int width, int height){
+void writePPM(std::ostream &out, Canvas const &canvas) {
+    writeHeader(out, canvas.width, canvas.height);
+    writeBody(out, canvas);
+};
+
+static void writeHeader(std::ostream &ss, int width, int height){
     ss << "P3\n" << width << " " << height << "\n" << 255 << "\n";   
 };
 
-static void writeBody(std::stringstream &ss, Canvas const &canvas){
+static void writeBody(std::ostream &ss, Canvas const &canvas){
     for(int j = 0; j < canvas.height; j++){
         std::stringstream tmp;
         
@@ -102,10 +169,320 @@ int clamp(float number) {
 
 
 void writeFile(Canvas const &canvas, std::string const &title) {
+    TraceSpan span("encode", "io");
     std::ofstream file(title + ".ppm");
     std::stringstream ppm = canvasToPPM(canvas);
 
     file << ppm.rdbuf();
 
     file.close();
+};
+
+void writeImage(Canvas const &canvas, std::string const &path, ImageFormat format) {
+    TraceSpan span("encode", "io");
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("cannot open " + path + " for writing");
+    }
+
+    switch (format) {
+        case ImageFormat::PPM:
+            writePPM(file, canvas);
+            break;
+        case ImageFormat::PPMBinary:
+            writeBinaryPPM(file, canvas);
+            break;
+        case ImageFormat::PFM:
+            writePFM(file, canvas);
+            break;
+        case ImageFormat::PNG:
+            writePNG(file, canvas);
+            break;
+    }
+};
+
+void writeBinaryPPM(std::ostream &out, Canvas const &canvas) {
+    out << "P6\n" << canvas.width << " " << canvas.height << "\n" << 255 << "\n";
+
+    std::vector<float> linear(canvas.width*3);
+    std::vector<unsigned char> row(canvas.width*3);
+    for(int j = 0; j < canvas.height; j++){
+        canvas.readRow(j, linear.data());
+        for(int i = 0; i < canvas.width*3; i++){
+            row[i] = clamp(linear[i]*255.0f);
+        }
+        out.write(reinterpret_cast<char const*>(row.data()), row.size());
+    }
+};
+
+void writePFM(std::ostream &out, Canvas const &canvas) {
+    //negative scale -> little endian samples
+    out << "PF\n" << canvas.width << " " << canvas.height << "\n" << "-1.0\n";
+
+    std::vector<float> row(canvas.width*3);
+    for(int j = canvas.height - 1; j >= 0; j--){
+        canvas.readRow(j, row.data());
+        out.write(reinterpret_cast<char const*>(row.data()), row.size()*sizeof(float));
+    }
+};
+
+ImageFormat imageFormatFromName(std::string const &name) {
+    if (name == "ppm") {
+        return ImageFormat::PPM;
+    }
+    if (name == "ppm-binary") {
+        return ImageFormat::PPMBinary;
+    }
+    if (name == "pfm") {
+        return ImageFormat::PFM;
+    }
+    if (name == "png") {
+        return ImageFormat::PNG;
+    }
+    throw std::invalid_argument("unknown image format: " + name);
+};
+
+std::string imageFormatExtension(ImageFormat format) {
+    switch (format) {
+        case ImageFormat::PPM:
+        case ImageFormat::PPMBinary:
+            return ".ppm";
+        case ImageFormat::PFM:
+            return ".pfm";
+        case ImageFormat::PNG:
+            return ".png";
+    }
+    return "";
+};
+
+//images read from files are refused past these before anything is allocated, which also keeps
+//width*height*3 within an int
+static const int maxImageEdge = 1 << 16;
+static const std::int64_t maxImagePixels = (std::int64_t)1 << 28;
+
+//ImageRows keeps a single row in memory, so only the edges are limited
+static const int maxStreamedEdge = 1 << 20;
+
+static void throwTooLarge(int width, int height, std::string const &format) {
+    throw std::runtime_error(format + " image of " + std::to_string(width) + "x" + std::to_string(height) + " is too large");
+};
+
+//throws when a stream that knows its length holds fewer than `bytesPerPixel` bytes per pixel after
+//the header
+static void checkPayload(std::istream &in, std::int64_t pixels, int bytesPerPixel, std::string const &format) {
+    std::streampos start = in.tellg();
+    if (start == std::streampos(-1)) {
+        return;
+    }
+    in.seekg(0, std::ios::end);
+    std::streampos end = in.tellg();
+    in.seekg(start);
+    if (end != std::streampos(-1) && (std::int64_t)(end - start) < pixels*bytesPerPixel) {
+        throw std::runtime_error("truncated " + format + " image");
+    }
+};
+
+//throws when the header's size is too large or the stream too short for it
+static void checkImageSize(std::istream &in, int width, int height, int bytesPerPixel, std::string const &format) {
+    std::int64_t pixels = (std::int64_t)width*height;
+    if (width > maxImageEdge || height > maxImageEdge || pixels > maxImagePixels) {
+        throwTooLarge(width, height, format);
+    }
+    checkPayload(in, pixels, bytesPerPixel, format);
+};
+
+static int readHeaderValue(std::istream &in) {
+    in >> std::ws;
+    while (in.peek() == '#') {
+        std::string comment;
+        std::getline(in, comment);
+        in >> std::ws;
+    }
+
+    int value;
+    if (!(in >> value)) {
+        throw std::runtime_error("malformed PPM header");
+    }
+    return value;
+};
+
+Canvas readPPM(std::istream &in) {
+    std::string magic;
+    in >> magic;
+    if (magic != "P3" && magic != "P6") {
+        throw std::runtime_error("not a PPM image");
+    }
+
+    int width = readHeaderValue(in);
+    int height = readHeaderValue(in);
+    int maxValue = readHeaderValue(in);
+    if (width < 0 || height < 0 || maxValue <= 0 || (magic == "P6" && maxValue > 255)) {
+        throw std::runtime_error("unsupported PPM header");
+    }
+    //a plain sample takes at least one digit
+    checkImageSize(in, width, height, 3, "PPM");
+    float scale = 1.0f / maxValue;
+
+    Canvas canvas(width, height);
+    if (magic == "P3") {
+        for (int i = 0; i < width*height; i++) {
+            int red, green, blue;
+            if (!(in >> red >> green >> blue)) {
+                throw std::runtime_error("truncated PPM image");
+            }
+            canvas.writePixel(i % width, i / width, Color(red*scale, green*scale, blue*scale));
+        }
+    } else {
+        in.get(); //single whitespace after the header
+        std::vector<unsigned char> row(width*3);
+        for (int j = 0; j < height; j++) {
+            if (!in.read(reinterpret_cast<char*>(row.data()), row.size())) {
+                throw std::runtime_error("truncated PPM image");
+            }
+            for (int i = 0; i < width; i++) {
+                canvas.writePixel(i, j, Color(row[i*3]*scale, row[i*3 + 1]*scale, row[i*3 + 2]*scale));
+            }
+        }
+    }
+    return canvas;
+};
+
+Canvas readPFM(std::istream &in) {
+    std::string magic;
+    in >> magic;
+    if (magic != "PF") {
+        throw std::runtime_error("not a PFM colour image");
+    }
+
+    int width, height;
+    float scale;
+    if (!(in >> width >> height >> scale) || width < 0 || height < 0 || scale == 0.0f) {
+        throw std::runtime_error("malformed PFM header");
+    }
+    in.get(); //single whitespace after the header
+    checkImageSize(in, width, height, 3*sizeof(float), "PFM");
+
+    //the sign of the scale gives the byte order of the samples
+    std::uint16_t probe = 1;
+    bool littleEndianHost = *reinterpret_cast<unsigned char*>(&probe) == 1;
+    bool swap = (scale < 0.0f) != littleEndianHost;
+
+    Canvas canvas(width, height);
+    std::vector<float> row(width*3);
+    for (int j = height - 1; j >= 0; j--) {
+        if (!in.read(reinterpret_cast<char*>(row.data()), row.size()*sizeof(float))) {
+            throw std::runtime_error("truncated PFM image");
+        }
+        if (swap) {
+            for (float &value : row) {
+                unsigned char *bytes = reinterpret_cast<unsigned char*>(&value);
+                std::swap(bytes[0], bytes[3]);
+                std::swap(bytes[1], bytes[2]);
+            }
+        }
+        canvas.writeRow(j, row.data());
+    }
+    return canvas;
+};
+
+Canvas readImage(std::string const &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    char magic[2] = {0, 0};
+    file.read(magic, 2);
+    file.seekg(0);
+    if (magic[0] == 'P' && magic[1] == 'F') {
+        return readPFM(file);
+    }
+    return readPPM(file);
+};
+
+ImageRows::ImageRows(std::string const &path) : file(path, std::ios::binary), row(0) {
+    if (!file) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    std::string magic;
+    file >> magic;
+    pfm = magic == "PF";
+    plain = magic == "P3";
+    swap = false;
+    scale = 1.0f;
+    std::string format = pfm ? "PFM" : "PPM";
+
+    int bytesPerPixel;
+    if (pfm) {
+        float endian;
+        if (!(file >> width >> height >> endian) || width < 0 || height < 0 || endian == 0.0f) {
+            throw std::runtime_error("malformed PFM header");
+        }
+        std::uint16_t probe = 1;
+        bool littleEndianHost = *reinterpret_cast<unsigned char*>(&probe) == 1;
+        swap = (endian < 0.0f) != littleEndianHost;
+        bytesPerPixel = 3*sizeof(float);
+    } else if (plain || magic == "P6") {
+        width = readHeaderValue(file);
+        height = readHeaderValue(file);
+        int maxValue = readHeaderValue(file);
+        if (width < 0 || height < 0 || maxValue <= 0 || (!plain && maxValue > 255)) {
+            throw std::runtime_error("unsupported PPM header");
+        }
+        scale = 1.0f / maxValue;
+        bytesPerPixel = 3;
+    } else {
+        throw std::runtime_error("not a PPM or PFM image");
+    }
+    if (!plain) {
+        file.get(); //single whitespace after the header
+    }
+    if (width > maxStreamedEdge || height > maxStreamedEdge) {
+        throwTooLarge(width, height, format);
+    }
+    checkPayload(file, (std::int64_t)width*height, bytesPerPixel, format);
+    data = file.tellg();
+    bytes.resize(plain ? 0 : (std::size_t)width*bytesPerPixel);
+};
+
+void ImageRows::readRow(float* rgb) {
+    if (row >= height) {
+        throw std::runtime_error("read past the last image row");
+    }
+    if (plain) {
+        for (int i = 0; i < width*3; i++) {
+            int sample;
+            if (!(file >> sample)) {
+                throw std::runtime_error("truncated PPM image");
+            }
+            rgb[i] = sample*scale;
+        }
+    } else if (pfm) {
+        file.seekg(data + std::streamoff((std::int64_t)(height - 1 - row)*bytes.size()));
+        if (!file.read(reinterpret_cast<char*>(rgb), bytes.size())) {
+            throw std::runtime_error("truncated PFM image");
+        }
+        if (swap) {
+            unsigned char *sample = reinterpret_cast<unsigned char*>(rgb);
+            for (std::size_t i = 0; i < bytes.size(); i += 4) {
+                std::swap(sample[i], sample[i + 3]);
+                std::swap(sample[i + 1], sample[i + 2]);
+            }
+        }
+    } else {
+        if (!file.read(reinterpret_cast<char*>(bytes.data()), bytes.size())) {
+            throw std::runtime_error("truncated PPM image");
+        }
+        for (int i = 0; i < width*3; i++) {
+            rgb[i] = bytes[i]*scale;
+        }
+    }
+    row++;
+};
+
+void pasteCanvas(Canvas &canvas, Canvas const &piece, int x, int y) {
+    for (int j = std::max(0, -y); j < piece.height && y + j < canvas.height; j++) {
+        for (int i = std::max(0, -x); i < piece.width && x + i < canvas.width; i++) {
+            canvas.writePixel(x + i, y + j, piece.pixelAt(i, j));
+        }
+    }
 };
\ No newline at end of file
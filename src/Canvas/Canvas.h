@@ -1,29 +1,114 @@
 #pragma once
 
+#include <fstream>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "Color.h"
+#include "Framebuffer.h"
 
-class Canvas {
+enum class ImageFormat {
+    PPM,        //plain text P3
+    PPMBinary,  //binary P6
+    PFM,        //32-bit float RGB, rows stored bottom to top
+    PNG         //8-bit RGB, deflated on all cores
+};
+
+enum class CanvasLayout {
+    RowMajor,   //pixels row by row, `pixels` can be read as the image
+    Tiled       //8x8 pixel tiles, each starting on its own cache line
+};
+
+class Canvas : public Framebuffer {
 public:
-    int width, height;
-    Color* arrayOfPixels;
+    static const int tileEdge = 8;
+
+    CanvasLayout layout;
+    float* pixels;  //linear RGB floats in `layout` order, never clamped
 
-    Canvas(int width, int height);
+    Canvas(int width, int height, CanvasLayout layout = CanvasLayout::RowMajor);
+    Canvas(Canvas &&other);
+    Canvas(Canvas const &other) = delete;
     ~Canvas();
     
-    Color pixelAt(int x, int y) const;
+    Color pixelAt(int x, int y) const override;
 
-    void writePixel(int x, int y, Color const& color);
+    void writePixel(int x, int y, Color const& color) override;
     void fill(Color const& color);
+
+    //row-major view for encoders, whatever the layout: width*3 floats
+    void readRow(int y, float* rgb) const;
+    void writeRow(int y, float const* rgb);
+
+    //floats allocated for `pixels`, tiled canvases are padded to whole tiles
+    std::size_t channelCount() const;
+
+private:
+    int tilesPerRow;
+
+    std::size_t offset(int x, int y) const;
 };
 
 std::stringstream canvasToPPM(Canvas const &canvas);
 
-static void writeHeader(std::stringstream &ss, int width, int height);
+//streams the plain PPM row by row, without building it in memory first
+void writePPM(std::ostream &out, Canvas const &canvas);
+
+static void writeHeader(std::ostream &ss, int width, int height);
 
-static void writeBody(std::stringstream &ss, Canvas const &canvas);
+static void writeBody(std::ostream &ss, Canvas const &canvas);
 
 static int clamp(float number);
 
-void writeFile(Canvas const &canvas, std::string const &title);
\ No newline at end of file
+void writeFile(Canvas const &canvas, std::string const &title);
+
+//writes the canvas to `path` as is, no extension is appended
+void writeImage(Canvas const &canvas, std::string const &path, ImageFormat format);
+
+void writeBinaryPPM(std::ostream &out, Canvas const &canvas);
+
+void writePFM(std::ostream &out, Canvas const &canvas);
+
+//accepts the names used on the command line: "ppm", "ppm-binary", "pfm", "png"
+ImageFormat imageFormatFromName(std::string const &name);
+
+std::string imageFormatExtension(ImageFormat format);
+
+//Readers throw std::runtime_error for images over 65536 pixels on a side or 2^28 pixels in all, and
+//for streams that are too short for the size in the header, before allocating the canvas
+
+//reads plain (P3) and binary (P6) PPM, throws std::runtime_error on anything else
+Canvas readPPM(std::istream &in);
+
+//reads little and big endian PFM colour images, throws std::runtime_error on anything else
+Canvas readPFM(std::istream &in);
+
+//PPM or PFM, told apart by the magic number
+Canvas readImage(std::string const &path);
+
+//Reads a PPM or PFM file one row at a time, top to bottom, so images too large to decode whole can
+//be processed in bands. The header is checked as above, except that only the edges are limited
+//(to 2^20) and not the pixel count. Throws std::runtime_error.
+class ImageRows {
+public:
+    int width, height;
+
+    ImageRows(std::string const &path);
+
+    //the next row as width*3 floats
+    void readRow(float* rgb);
+
+private:
+    std::ifstream file;
+    bool plain;             //P3
+    bool pfm;               //rows stored bottom to top, read with a seek each
+    bool swap;              //PFM samples in the other byte order
+    float scale;            //of PPM samples
+    std::streampos data;    //the first sample
+    int row;
+    std::vector<unsigned char> bytes;
+};
+
+//copies `piece` into `canvas` with its top left corner at (x, y), clipping what falls outside
+void pasteCanvas(Canvas &canvas, Canvas const &piece, int x, int y);
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "Checkpoint.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+static const char magic[8] = "RTCKPT3";
+
+CheckpointHeader::CheckpointHeader(Camera const &camera, RenderRegion const &frame, RenderSettings const &settings) :
+    hsize(camera.hsize), vsize(camera.vsize), frame(frame), tileSize(settings.tileSize),
+    samples(settings.samples), maxBounces(settings.maxBounces), specular(settings.specular), fieldOfView(camera.fieldOfView), sceneHash(settings.sceneHash) {
+    for (int i = 0; i < 16; i++) {
+        transform[i] = camera.transform.array[i];
+    }
+};
+
+//floats compared exactly, a resumed render has to be set up from the same numbers
+bool CheckpointHeader::operator== (CheckpointHeader const &other) const {
+    return hsize == other.hsize && vsize == other.vsize && frame == other.frame && tileSize == other.tileSize &&
+           samples == other.samples && maxBounces == other.maxBounces && specular == other.specular && fieldOfView == other.fieldOfView &&
+           std::equal(transform, transform + 16, other.transform) && sceneHash == other.sceneHash;
+};
+
+//false when the header did not make it to the file
+static bool writeHeader(std::FILE *file, CheckpointHeader const &header) {
+    std::int32_t values[10] = {header.hsize, header.vsize, header.frame.x, header.frame.y, header.frame.width,
+                               header.frame.height, header.tileSize, header.samples, header.maxBounces,
+                               static_cast<std::int32_t>(header.specular)};
+    return std::fwrite(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+           std::fwrite(values, sizeof(std::int32_t), 10, file) == 10 &&
+           std::fwrite(&header.fieldOfView, sizeof(float), 1, file) == 1 &&
+           std::fwrite(header.transform, sizeof(float), 16, file) == 16 &&
+           std::fwrite(&header.sceneHash, sizeof(std::uint64_t), 1, file) == 1 &&
+           std::fflush(file) == 0;
+};
+
+static bool readHeader(std::FILE *file, CheckpointHeader &header) {
+    char fileMagic[8];
+    std::int32_t values[10];
+    if (std::fread(fileMagic, 1, sizeof(fileMagic), file) != sizeof(fileMagic) || std::memcmp(fileMagic, magic, sizeof(magic)) != 0 ||
+        std::fread(values, sizeof(std::int32_t), 10, file) != 10 ||
+        std::fread(&header.fieldOfView, sizeof(float), 1, file) != 1 ||
+        std::fread(header.transform, sizeof(float), 16, file) != 16 ||
+        std::fread(&header.sceneHash, sizeof(std::uint64_t), 1, file) != 1) {
+        return false;
+    }
+    header.hsize = values[0];
+    header.vsize = values[1];
+    header.frame = RenderRegion(values[2], values[3], values[4], values[5]);
+    header.tileSize = values[6];
+    header.samples = values[7];
+    header.maxBounces = values[8];
+    header.specular = static_cast<PowMode>(values[9]);
+    return true;
+};
+
+//reads the records of a checkpoint written for `header` into `tiles` (when given) and returns
+//the size of the file up to the last complete record, 0 if there is no file
+static long scanCheckpoint(std::string const &path, CheckpointHeader const &header, std::vector<CheckpointTile> *tiles) {
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return 0;
+    }
+
+    CheckpointHeader stored = header;
+    if (!readHeader(file, stored) || !(stored == header)) {
+        std::fclose(file);
+        throw std::runtime_error("checkpoint " + path + " was written for a different render");
+    }
+
+    long valid = std::ftell(file);
+    std::int32_t record[5];
+    while (std::fread(record, sizeof(std::int32_t), 5, file) == 5) {
+        CheckpointTile tile;
+        tile.region = RenderRegion(record[0], record[1], record[2], record[3]);
+        tile.samples = record[4];
+        RenderRegion const &frame = header.frame;
+        if (tile.region.empty() || tile.region.x < frame.x || tile.region.y < frame.y ||
+            tile.region.x + tile.region.width > frame.x + frame.width || tile.region.y + tile.region.height > frame.y + frame.height) {
+            break;
+        }
+        tile.pixels.resize(tile.region.width*tile.region.height*3);
+        if (std::fread(tile.pixels.data(), sizeof(float), tile.pixels.size(), file) != tile.pixels.size()) {
+            break;
+        }
+        valid = std::ftell(file);
+        if (tiles != nullptr) {
+            tiles->push_back(std::move(tile));
+        }
+    }
+
+    std::fclose(file);
+    return valid;
+};
+
+CheckpointWriter::CheckpointWriter(std::string const &path, CheckpointHeader const &header, bool append) :
+    path(path), file(nullptr), writing(false), stopping(false) {
+    long valid = append ? scanCheckpoint(path, header, nullptr) : 0;
+
+    if (valid > 0) {
+        //drop a record torn by the crash so new ones start on a record boundary
+        std::filesystem::resize_file(path, valid);
+        file = std::fopen(path.c_str(), "ab");
+    } else {
+        file = std::fopen(path.c_str(), "wb");
+        if (file != nullptr && !writeHeader(file, header)) {
+            std::string reason = std::strerror(errno);
+            std::fclose(file);
+            throw std::runtime_error("cannot write checkpoint " + path + ": " + reason);
+        }
+    }
+    if (file == nullptr) {
+        throw std::runtime_error("cannot open checkpoint " + path);
+    }
+
+    thread = std::thread(&CheckpointWriter::run, this);
+};
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+    std::fclose(file);
+};
+
+void CheckpointWriter::push(RenderRegion const &tile, int samples, Framebuffer const &canvas, int originX, int originY) {
+    if (!error().empty()) {
+        return;
+    }
+
+    CheckpointTile record;
+    record.region = tile;
+    record.samples = samples;
+    record.pixels.resize(tile.width*tile.height*3);
+    for (int y = 0; y < tile.height; y++) {
+        for (int x = 0; x < tile.width; x++) {
+            Color color = canvas.pixelAt(tile.x + x - originX, tile.y + y - originY);
+            float *p = &record.pixels[(y*tile.width + x)*3];
+            p[0] = color.red;
+            p[1] = color.green;
+            p[2] = color.blue;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!failure.empty()) {
+            return;
+        }
+        queue.push_back(std::move(record));
+    }
+    wake.notify_one();
+};
+
+void CheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [this]() { return queue.empty() && !writing; });
+};
+
+std::string CheckpointWriter::error() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return failure;
+};
+
+void CheckpointWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+        if (queue.empty()) {
+            return;
+        }
+
+        std::deque<CheckpointTile> batch;
+        batch.swap(queue);
+        writing = true;
+        lock.unlock();
+
+        bool written = true;
+        for (CheckpointTile const &tile : batch) {
+            std::int32_t record[5] = {tile.region.x, tile.region.y, tile.region.width, tile.region.height, tile.samples};
+            written = std::fwrite(record, sizeof(std::int32_t), 5, file) == 5 &&
+                      std::fwrite(tile.pixels.data(), sizeof(float), tile.pixels.size(), file) == tile.pixels.size();
+            if (!written) {
+                break;
+            }
+        }
+        written = written && std::fflush(file) == 0;
+        std::string reason = written ? "" : std::strerror(errno);
+
+        lock.lock();
+        if (!written) {
+            //a torn record at the end is dropped on resume, the records before it stay usable
+            failure = "cannot write checkpoint " + path + ": " + reason;
+            queue.clear();
+        }
+        writing = false;
+        drained.notify_all();
+    }
+};
+
+
+//Out of class
+
+std::vector<CheckpointTile> loadCheckpoint(std::string const &path, CheckpointHeader const &header) {
+    std::vector<CheckpointTile> tiles;
+    scanCheckpoint(path, header, &tiles);
+    return tiles;
+};
+
+void restoreTile(CheckpointTile const &tile, Framebuffer &canvas, int originX, int originY) {
+    for (int y = 0; y < tile.region.height; y++) {
+        for (int x = 0; x < tile.region.width; x++) {
+            float const *p = &tile.pixels[(y*tile.region.width + x)*3];
+            canvas.writePixel(tile.region.x + x - originX, tile.region.y + y - originY, Color(p[0], p[1], p[2]));
+        }
+    }
+};
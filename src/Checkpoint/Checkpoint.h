@@ -0,0 +1,89 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Camera.h"
+#include "Canvas.h"
+
+/*
+Checkpoint file: a header describing the render, then one record per finished tile, appended as
+tiles complete. A record written halfway through a crash is ignored when loading.
+    header:  char[8] "RTCKPT3", int32 hsize, vsize, frameX, frameY, frameWidth, frameHeight, tileSize, samples, maxBounces,
+             specular, float fieldOfView, float[16] camera transform, uint64 sceneHash
+    record:  int32 x, y, width, height, samples, float[width*height*3] mean RGB of the samples, row by row
+*/
+
+class CheckpointTile {
+public:
+    RenderRegion region;
+    int samples;
+    std::vector<float> pixels;
+};
+
+//render parameters a checkpoint is only valid for
+class CheckpointHeader {
+public:
+    int hsize, vsize;
+    RenderRegion frame;
+    int tileSize;
+    int samples;
+    int maxBounces;
+    PowMode specular;       //the highlights differ between modes
+    float fieldOfView;
+    float transform[16];
+    std::uint64_t sceneHash;
+
+    CheckpointHeader(Camera const &camera, RenderRegion const &frame, RenderSettings const &settings);
+
+    bool operator== (CheckpointHeader const &other) const;
+};
+
+//Appends finished tiles to the checkpoint file from its own thread, so render threads only pay for
+//copying the tile pixels into the queue. After a failed write nothing more is written, see error().
+class CheckpointWriter {
+public:
+    //append -> keep the records already in the file (resume), otherwise start a new file.
+    //Throws std::runtime_error when the file cannot be opened or the header written
+    CheckpointWriter(std::string const &path, CheckpointHeader const &header, bool append);
+    ~CheckpointWriter();
+
+    CheckpointWriter(CheckpointWriter const &other) = delete;
+    void operator=(CheckpointWriter const &other) = delete;
+
+    //copies the tile out of `canvas`, whose pixel (0, 0) is frame pixel (originX, originY)
+    void push(RenderRegion const &tile, int samples, Framebuffer const &canvas, int originX, int originY);
+
+    //blocks until everything pushed so far is in the file, or dropped after a failed write
+    void flush();
+
+    //empty while every record made it to the file, otherwise why writing stopped
+    std::string error();
+
+private:
+    std::string path;
+    std::FILE *file;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable drained;
+    std::deque<CheckpointTile> queue;
+    bool writing;
+    bool stopping;
+    std::string failure;
+    std::thread thread;
+
+    void run();
+};
+
+//tiles of a checkpoint written for `header`; empty if the file does not exist.
+//Throws std::runtime_error if it belongs to a different render.
+std::vector<CheckpointTile> loadCheckpoint(std::string const &path, CheckpointHeader const &header);
+
+//copies a checkpointed tile into `canvas`, whose pixel (0, 0) is frame pixel (originX, originY)
+void restoreTile(CheckpointTile const &tile, Framebuffer &canvas, int originX, int originY);
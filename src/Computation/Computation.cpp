@@ -4,46 +4,21 @@
 #include <algorithm>
 #include <cmath>
 
-Computation prepareComputation(Intersection const &hit, Ray const &r,  std::vector<Intersection> intersections) {
-    Computation comp; 
-
-    comp.t = hit.t; 
-    comp.object = hit.object;
-
-    comp.point = position(r, hit.t);
-    comp.eyeDirection = -r.direction;
-    comp.normal = hit.object->normalAt(comp.point);
-    comp.reflectv = reflect(r.direction, comp.normal);
-
-    float* n = calculateN1andN2(hit, r, intersections);
-    comp.n1 = n[0];
-    comp.n2 = n[1];
-    delete[] n;
-
-    if(comp.normal * comp.eyeDirection < 0) {
-        comp.inside = true;
-        comp.normal = -comp.normal;
-    }
-    else {
-        comp.inside = false; 
-    }
-
-    comp.overPoint = comp.point + comp.normal * EPSILON;
-    comp.underPoint = comp.point - comp.normal * EPSILON;
+#include "FlatScene.h"
 
-    return comp; 
-};
+static void calculateN1andN2(Intersection const &hit, std::vector<Intersection> const &intersections, FlatScene const *flat, float &n1, float &n2) {
+    auto refractiveIndex = [flat](Object const* object) {
+        return flat != nullptr ? flat->material(object).refractive_index : object->material.refractive_index;
+    };
 
-float* calculateN1andN2(Intersection const &hit, Ray const &r, std::vector<Intersection> intersections) {
-    float n1, n2;
     std::vector<Object*> container;
 
-    for(Intersection i : intersections) {
+    for(Intersection const &i : intersections) {
         if (i.t == hit.t) {
             if (container.empty()){
                 n1 = 1.0f;
             } else {
-                n1 = container.back()->material.refractive_index;
+                n1 = refractiveIndex(container.back());
             }
         }
 
@@ -57,17 +32,55 @@ float* calculateN1andN2(Intersection const &hit, Ray const &r, std::vector<Inter
             if (container.empty()){
                 n2 = 1.0f;
             } else {
-                n2 = container.back()->material.refractive_index;
+                n2 = refractiveIndex(container.back());
             }
             break;
         }
 
     }
-    
-    float* ns = new float[2];
-    ns[0] = n1;
-    ns[1] = n2;
-    return ns;
+};
+
+static Computation prepare(Intersection const &hit, Ray const &r, std::vector<Intersection> const &intersections, FlatScene const *flat,
+                           bool reflection, bool refraction) {
+    Computation comp; 
+
+    comp.t = hit.t; 
+    comp.object = hit.object;
+    comp.material = flat != nullptr ? &flat->material(hit.object) : &hit.object->material;
+    comp.depth = r.depth;
+
+    comp.point = position(r, hit.t);
+    comp.eyeDirection = -r.direction;
+    comp.normal = flat != nullptr ? flat->normalAt(hit.object, comp.point) : hit.object->normalAt(comp.point);
+    comp.reflectv = reflection ? reflect(r.direction, comp.normal) : Tuple::Vector(0.0f, 0.0f, 0.0f);
+
+    comp.n1 = 1.0f;
+    comp.n2 = 1.0f;
+    if (refraction) {
+        calculateN1andN2(hit, intersections, flat, comp.n1, comp.n2);
+    }
+
+    if(comp.normal * comp.eyeDirection < 0) {
+        comp.inside = true;
+        comp.normal = -comp.normal;
+    }
+    else {
+        comp.inside = false; 
+    }
+
+    comp.overPoint = comp.point + comp.normal * EPSILON;
+    comp.underPoint = refraction ? comp.point - comp.normal * EPSILON : comp.point;
+
+    return comp; 
+};
+
+Computation prepareComputation(Intersection const &hit, Ray const &r, std::vector<Intersection> const &intersections, FlatScene const *flat) {
+    return prepare(hit, r, intersections, flat, true, true);
+};
+
+Computation prepareShading(Intersection const &hit, Ray const &r, std::vector<Intersection> const &intersections, FlatScene const *flat) {
+    Material const &material = flat != nullptr ? flat->material(hit.object) : hit.object->material;
+    return prepare(hit, r, intersections, flat, material.reflective > 0.0f, material.transparency > 0.0f);
 };
 
 
@@ -86,6 +99,10 @@ float shlick(Computation const &comp) {
         cos = sqrt(1.0 - sin2_t);
     }
 
-    float r0 = pow(((comp.n1 - comp.n2) / (comp.n1 + comp.n2)), 2.0f);
-    return r0 + (1-r0)*pow((1-cos), 5.0f);
+    //whole powers, multiplied out
+    float ratio = (comp.n1 - comp.n2) / (comp.n1 + comp.n2);
+    float r0 = ratio*ratio;
+    float c = 1 - cos;
+    float c2 = c*c;
+    return r0 + (1-r0)*(c2*c2*c);
 };
\ No newline at end of file
@@ -11,6 +11,7 @@ public:
     float t;
     float n1, n2;
     Object* object;
+    Material const* material;   //the object's, or its interned copy when prepared with a FlatScene
     Tuple point;
     Tuple overPoint;
     Tuple underPoint; 
@@ -18,12 +19,19 @@ public:
     Tuple normal;
     Tuple reflectv;
     bool inside;
+    int depth;      //of the ray that made the hit
 
 };
 
 
-Computation prepareComputation(Intersection const &hit, Ray const &r, std::vector<Intersection> intersections);
+class FlatScene;
 
-static float* calculateN1andN2(Intersection const &hit, Ray const &r, std::vector<Intersection> intersections);
+//`flat`, when given, computes the normal instead of the object's virtual normalAt
+Computation prepareComputation(Intersection const &hit, Ray const &r, std::vector<Intersection> const &intersections, FlatScene const *flat = nullptr);
+
+//what shadeHit needs for the hit object's material: reflectv only for reflective materials, and
+//underPoint, n1 and n2 (the containment walk over `intersections`) only for transparent ones.
+//The fields left out keep reflectv = 0 and n1 = n2 = 1.
+Computation prepareShading(Intersection const &hit, Ray const &r, std::vector<Intersection> const &intersections, FlatScene const *flat = nullptr);
 
 float shlick(Computation const &comp);
\ No newline at end of file
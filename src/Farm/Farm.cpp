@@ -0,0 +1,408 @@
+#include "Farm.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+
+#include "Stats.h"
+#include "Trace.h"
+
+FarmSettings::FarmSettings(int workers, std::string const &socketPath, int maxRetries, int tileTimeout) :
+    workers(workers), socketPath(socketPath), maxRetries(maxRetries), tileTimeout(tileTimeout) {};
+
+#ifdef _WIN32
+
+Canvas renderFarm(Camera const &camera, World const &world, RenderSettings const &settings, FarmSettings const &farm) {
+    return render(camera, world, settings);
+};
+
+void runFarmWorker(std::string const &socketPath, World const &world, std::uint64_t sceneHash) {
+    throw std::runtime_error("render farm workers need Unix sockets");
+};
+
+#else
+
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+/*
+Wire protocol, native byte order since both ends run on the same machine:
+    coordinator -> worker   job:     FarmJob (once, on connect)
+    worker -> coordinator   accept:  int32 1 when the worker renders the same scene, 0 before it hangs up
+    coordinator -> worker   tile:    int32 x, y, width, height (width 0 ends the job)
+    worker -> coordinator   result:  int32 x, y, width, height, RenderStats, width*height*3 float rows
+*/
+
+class FarmJob {
+public:
+    std::uint64_t sceneHash;    //0 when unknown
+    std::int32_t hsize, vsize, samples, maxBounces, specular, acceleration;
+    float fieldOfView;
+    float transform[16];        //camera transform, row-major
+    std::int32_t unused;        //keeps the size a multiple of 8 without padding
+};
+static_assert(sizeof(FarmJob) == 104, "FarmJob is sent as is and must have no padding");
+
+static const int idle = -1;
+static const int awaitingAccept = -2;
+
+class FarmWorker {
+public:
+    int fd;
+    pid_t pid;      //-1 for workers that connected over the socket
+    int tile;       //index of the tile in flight, idle, or awaitingAccept until the worker took the job
+    std::chrono::steady_clock::time_point since;     //when `tile` was handed out or the job sent
+};
+
+static bool writeAll(int fd, void const *data, std::size_t size) {
+    char const *bytes = static_cast<char const*>(data);
+    while (size > 0) {
+        ssize_t written = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+};
+
+static bool readAll(int fd, void *data, std::size_t size) {
+    char *bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t got = read(fd, bytes, size);
+        if (got <= 0) {
+            return false;
+        }
+        bytes += got;
+        size -= got;
+    }
+    return true;
+};
+
+static void serveTiles(int fd, World const &world, std::uint64_t sceneHash) {
+    FarmJob job;
+    if (!readAll(fd, &job, sizeof(job))) {
+        return;
+    }
+    std::int32_t accepted = job.sceneHash == 0 || sceneHash == 0 || job.sceneHash == sceneHash;
+    if (!writeAll(fd, &accepted, sizeof(accepted))) {
+        return;
+    }
+    if (!accepted) {
+        throw std::runtime_error("the coordinator renders a different scene");
+    }
+
+    Camera jobCamera(job.hsize, job.vsize, job.fieldOfView);
+    std::copy(job.transform, job.transform + 16, jobCamera.transform.array);
+    RenderSettings settings(1, job.samples, job.maxBounces);
+    settings.specular = static_cast<PowMode>(job.specular);
+    settings.acceleration = static_cast<Acceleration>(job.acceleration);
+    World compiled = world;
+    compiled.compile(settings.specular, settings.acceleration);
+
+    std::int32_t tile[4];
+    while (readAll(fd, tile, sizeof(tile)) && tile[2] > 0) {
+        RenderRegion region(tile[0], tile[1], tile[2], tile[3]);
+        Canvas canvas(region.width, region.height, CanvasLayout::RowMajor);
+        renderTile(jobCamera, compiled, region, settings, canvas, region.x, region.y);
+
+        RenderStats stats;
+        stats.reset();
+#ifdef RAYTRACER_STATS
+        stats = threadStats;
+        threadStats.reset();
+#endif
+
+        if (!writeAll(fd, tile, sizeof(tile)) ||
+            !writeAll(fd, &stats, sizeof(stats)) ||
+            !writeAll(fd, canvas.pixels, region.width*region.height*3*sizeof(float))) {
+            return;
+        }
+    }
+};
+
+static int listenOn(std::string const &path) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("socket path too long: " + path);
+    }
+    std::strcpy(address.sun_path, path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path.c_str());
+    if (fd < 0 || bind(fd, (sockaddr*)&address, sizeof(address)) != 0 || listen(fd, 16) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        throw std::runtime_error("cannot listen on " + path);
+    }
+    return fd;
+};
+
+Canvas renderFarm(Camera const &camera, World const &world, RenderSettings const &settings, FarmSettings const &farm) {
+    if (farm.workers <= 0 && farm.socketPath.empty()) {
+        return render(camera, world, settings);
+    }
+
+    TraceSpan span("render farm");
+    resetRenderStats();
+
+    std::vector<RenderRegion> regions = renderRegions(camera, settings);
+    RenderRegion frame = boundingRegion(regions);
+    Canvas canvas(frame.width, frame.height, settings.layout);
+
+    std::vector<RenderRegion> tiles = makeTiles(regions, settings.tileSize);
+    std::deque<int> pending;
+    for (std::vector<RenderRegion>::size_type i = 0; i < tiles.size(); i++) {
+        pending.push_back(i);
+    }
+    std::vector<int> retries(tiles.size(), 0);
+    std::size_t done = 0;
+
+    FarmJob job = {settings.sceneHash, camera.hsize, camera.vsize, std::max(1, settings.samples), settings.maxBounces,
+                   static_cast<std::int32_t>(settings.specular), static_cast<std::int32_t>(settings.acceleration),
+                   camera.fieldOfView, {}, 0};
+    std::copy(camera.transform.array, camera.transform.array + 16, job.transform);
+    std::vector<FarmWorker> workers;
+
+    //a worker that stops in the middle of a message fails the read instead of blocking it
+    timeval readTimeout = {farm.tileTimeout / 1000, (farm.tileTimeout % 1000) * 1000};
+    auto addWorker = [&](int fd, pid_t pid) {
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &readTimeout, sizeof(readTimeout));
+        workers.push_back({fd, pid, awaitingAccept, std::chrono::steady_clock::now()});
+        return writeAll(fd, &job, sizeof(job));
+    };
+
+    for (int i = 0; i < farm.workers; i++) {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+            throw std::runtime_error("cannot create worker socket");
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            //never returns: unwinding into the caller would run the parent's destructors (removing
+            //its texture cache files) and flush its stdio buffers a second time
+            try {
+                close(fds[0]);
+                for (FarmWorker const &worker : workers) {
+                    close(worker.fd);
+                }
+                serveTiles(fds[1], world, settings.sceneHash);
+            } catch (std::exception const &e) {
+                std::string message = std::string("render worker: ") + e.what() + "\n";
+                ssize_t written = write(STDERR_FILENO, message.data(), message.size());
+                (void)written;
+                _exit(1);
+            } catch (...) {
+                _exit(1);
+            }
+            _exit(0);
+        }
+        close(fds[1]);
+        if (pid < 0) {
+            close(fds[0]);
+            throw std::runtime_error("cannot fork render worker");
+        }
+        addWorker(fds[0], pid);
+    }
+
+    int listener = farm.socketPath.empty() ? -1 : listenOn(farm.socketPath);
+
+    auto dismiss = [&](FarmWorker &worker) {
+        if (worker.tile >= 0) {
+            if (++retries[worker.tile] > farm.maxRetries) {
+                throw std::runtime_error("tile at " + std::to_string(tiles[worker.tile].x) + "," +
+                                         std::to_string(tiles[worker.tile].y) + " failed on every worker");
+            }
+            pending.push_front(worker.tile);
+        }
+        worker.tile = idle;
+        close(worker.fd);
+        worker.fd = -1;
+        if (worker.pid > 0) {
+            waitpid(worker.pid, nullptr, 0);
+        }
+    };
+
+    auto assign = [&](FarmWorker &worker) {
+        if (pending.empty()) {
+            return;
+        }
+        worker.tile = pending.front();
+        worker.since = std::chrono::steady_clock::now();
+        pending.pop_front();
+        RenderRegion const &tile = tiles[worker.tile];
+        std::int32_t request[4] = {tile.x, tile.y, tile.width, tile.height};
+        if (!writeAll(worker.fd, request, sizeof(request))) {
+            dismiss(worker);
+        }
+    };
+
+    std::vector<float> pixels;
+    try {
+        while (done < tiles.size()) {
+            //includes tiles re-queued from dead workers
+            for (FarmWorker &worker : workers) {
+                if (worker.fd >= 0 && worker.tile == idle) {
+                    assign(worker);
+                }
+            }
+
+            //wait for the first result, or until the oldest tile in flight runs out of time
+            auto now = std::chrono::steady_clock::now();
+            auto timeout = std::chrono::milliseconds(farm.tileTimeout);
+            int wait = -1;
+            std::vector<pollfd> fds;
+            std::vector<FarmWorker*> polled;
+            for (FarmWorker &worker : workers) {
+                if (worker.fd >= 0 && worker.tile != idle) {
+                    fds.push_back({worker.fd, POLLIN, 0});
+                    polled.push_back(&worker);
+                    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(worker.since + timeout - now).count();
+                    wait = std::max(0, wait < 0 ? (int)left : std::min(wait, (int)left));
+                }
+            }
+            if (listener >= 0) {
+                fds.push_back({listener, POLLIN, 0});
+            }
+            if (fds.empty()) {
+                throw std::runtime_error("every render worker died");
+            }
+
+            if (poll(fds.data(), fds.size(), wait) < 0) {
+                continue;
+            }
+
+            now = std::chrono::steady_clock::now();
+            for (std::vector<FarmWorker*>::size_type i = 0; i < polled.size(); i++) {
+                FarmWorker &worker = *polled[i];
+                if (fds[i].revents == 0) {
+                    if (now - worker.since >= timeout) {
+                        //hung, a forked one has to go before dismiss() waits for it
+                        if (worker.pid > 0) {
+                            kill(worker.pid, SIGKILL);
+                        }
+                        dismiss(worker);
+                    }
+                    continue;
+                }
+
+                if (worker.tile == awaitingAccept) {
+                    std::int32_t accepted;
+                    if (!readAll(worker.fd, &accepted, sizeof(accepted)) || accepted != 1) {
+                        dismiss(worker);
+                    } else {
+                        worker.tile = idle;
+                    }
+                    continue;
+                }
+
+                //pixels of another tile than the one handed out cannot be placed, drop the worker
+                std::int32_t header[4];
+                RenderStats stats;
+                RenderRegion const &tile = tiles[worker.tile];
+                pixels.resize(tile.width*tile.height*3);
+                if (!readAll(worker.fd, header, sizeof(header)) ||
+                    header[0] != tile.x || header[1] != tile.y || header[2] != tile.width || header[3] != tile.height ||
+                    !readAll(worker.fd, &stats, sizeof(stats)) ||
+                    !readAll(worker.fd, pixels.data(), pixels.size()*sizeof(float))) {
+                    dismiss(worker);
+                    continue;
+                }
+
+                for (int y = 0; y < tile.height; y++) {
+                    for (int x = 0; x < tile.width; x++) {
+                        float const *p = &pixels[(y*tile.width + x)*3];
+                        canvas.writePixel(tile.x + x - frame.x, tile.y + y - frame.y, Color(p[0], p[1], p[2]));
+                    }
+                }
+#ifdef RAYTRACER_STATS
+                threadStats.merge(stats);
+#endif
+                worker.tile = idle;
+                done++;
+            }
+
+            if (listener >= 0 && fds.back().revents != 0) {
+                int fd = accept(listener, nullptr, nullptr);
+                if (fd >= 0 && !addWorker(fd, -1)) {
+                    dismiss(workers.back());
+                }
+            }
+        }
+    } catch (...) {
+        for (FarmWorker &worker : workers) {
+            if (worker.fd >= 0) {
+                worker.tile = idle;
+                if (worker.pid > 0) {
+                    kill(worker.pid, SIGTERM);
+                }
+                dismiss(worker);
+            }
+        }
+        if (listener >= 0) {
+            close(listener);
+            unlink(farm.socketPath.c_str());
+        }
+        throw;
+    }
+
+    std::int32_t stop[4] = {0, 0, 0, 0};
+    for (FarmWorker &worker : workers) {
+        if (worker.fd >= 0) {
+            writeAll(worker.fd, stop, sizeof(stop));
+            dismiss(worker);
+        }
+    }
+    if (listener >= 0) {
+        close(listener);
+        unlink(farm.socketPath.c_str());
+    }
+
+    flushThreadStats();
+    return canvas;
+};
+
+void runFarmWorker(std::string const &socketPath, World const &world, std::uint64_t sceneHash) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("socket path too long: " + socketPath);
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    //the coordinator may still be loading its scene, give it a few seconds to start listening
+    for (int attempt = 0; attempt < 100; attempt++) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            break;
+        }
+        if (connect(fd, (sockaddr*)&address, sizeof(address)) == 0) {
+            try {
+                serveTiles(fd, world, sceneHash);
+            } catch (...) {
+                close(fd);
+                throw;
+            }
+            close(fd);
+            return;
+        }
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    throw std::runtime_error("cannot connect to coordinator at " + socketPath);
+};
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Camera.h"
+#include "Canvas.h"
+#include "World.h"
+
+class FarmSettings {
+public:
+    int workers;                //processes forked from the coordinator, they share its loaded scene
+    std::string socketPath;     //non-empty -> also accept workers started with runFarmWorker() on this Unix socket
+    int maxRetries;             //times a tile is handed out again after its worker died
+    int tileTimeout;            //milliseconds a worker gets per tile before it counts as dead
+
+    FarmSettings(int workers = 0, std::string const &socketPath = "", int maxRetries = 3, int tileTimeout = 600000);
+};
+
+//Coordinator: hands the tiles of `settings` to worker processes one at a time, assembles their pixel
+//rows into the canvas and re-queues the tile of any worker that disconnects, sends back another tile
+//than the one it was given or takes longer than `tileTimeout` on it. Forked workers inherit
+//the already loaded scene, so it is loaded once per job and not once per tile.
+//Throws std::runtime_error when every worker is gone and no more can connect.
+Canvas renderFarm(Camera const &camera, World const &world, RenderSettings const &settings, FarmSettings const &farm);
+
+//Worker: connects to a coordinator listening on `socketPath` and renders the tiles it is given until
+//the coordinator ends the job. The camera, samples and bounces come from the coordinator's job.
+//Throws std::runtime_error, and the coordinator drops the worker, when both know their scene's hash
+//(see Scene::hash, 0 for unknown) and the two differ.
+void runFarmWorker(std::string const &socketPath, World const &world, std::uint64_t sceneHash = 0);
@@ -0,0 +1,105 @@
+#include "FastPow.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+const int SpecularPower::tableSize;
+
+SpecularPower::SpecularPower(float exponent, PowMode mode) : mode(mode), exponent(exponent), integer(-1) {
+    if (exponent >= 0.0f && exponent <= 1e6f && std::floor(exponent) == exponent) {
+        integer = (int)exponent;
+    }
+    if (mode == PowMode::Table) {
+        table.resize(tableSize);
+        for (int i = 0; i < tableSize; i++) {
+            table[i] = std::pow((double)i / (tableSize - 1), (double)exponent);
+        }
+    }
+};
+
+float SpecularPower::operator()(float x) const {
+    switch (mode) {
+        case PowMode::Integer:
+            if (integer >= 0) {
+                return integerPow(x, integer);
+            }
+            break;
+        case PowMode::Table: {
+            float position = std::min(std::max(x, 0.0f), 1.0f) * (tableSize - 1);
+            int i = std::min((int)position, tableSize - 2);
+            float fraction = position - i;
+            return table[i] + (table[i + 1] - table[i]) * fraction;
+        }
+        case PowMode::Approximate:
+            return approximatePow(x, exponent);
+        case PowMode::Exact:
+            break;
+    }
+    //in float, like the lighting without a SpecularPower
+    return std::pow(x, exponent);
+};
+
+
+//Out of class
+
+PowMode powModeFromName(std::string const &name) {
+    if (name == "exact") {
+        return PowMode::Exact;
+    }
+    if (name == "integer") {
+        return PowMode::Integer;
+    }
+    if (name == "table") {
+        return PowMode::Table;
+    }
+    if (name == "approx") {
+        return PowMode::Approximate;
+    }
+    throw std::invalid_argument("unknown pow mode: " + name);
+};
+
+float integerPow(float x, int n) {
+    double base = x;
+    double result = 1.0;
+    while (n > 0) {
+        if (n & 1) {
+            result *= base;
+        }
+        base *= base;
+        n >>= 1;
+    }
+    return (float)result;
+};
+
+float approximatePow(float x, float y) {
+    //log2(x) = e + log2(m) with m in [sqrt(1/2), sqrt(2)), from the float's bits
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    int e = (int)((bits >> 23) & 0xff) - 127;
+    bits = (bits & 0x007fffffu) | 0x3f800000u;
+    float m;
+    std::memcpy(&m, &bits, sizeof(m));
+    bool high = m > 1.41421356f;
+    m = high ? m*0.5f : m;
+    e += high;
+
+    //log2(m) = 2/ln2 * atanh(t), t = (m - 1)/(m + 1), |t| < 0.172 so five terms of the series suffice
+    float t = (m - 1.0f) / (m + 1.0f);
+    float t2 = t*t;
+    float log2m = t*(2.88539008f + t2*(0.961796694f + t2*(0.577078016f + t2*(0.412198583f + t2*0.320598898f))));
+
+    //2^z = 2^i * 2^f with f in [-0.5, 0.5], 2^f from its Taylor series
+    float z = y*((float)e + log2m);
+    z = std::min(std::max(z, -126.0f), 127.0f);
+    float i = std::floor(z + 0.5f);
+    float f = z - i;
+    float p = 1.0f + f*(0.693147181f + f*(0.240226507f + f*(0.0555041087f + f*(0.00961812911f + f*(0.00133335581f + f*0.000154035304f)))));
+
+    std::uint32_t scaleBits = (std::uint32_t)((int)i + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &scaleBits, sizeof(scale));
+    return p*scale;
+};
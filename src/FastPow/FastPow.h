@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+//how the specular highlight raises cos(angle) to the material's shininess
+enum class PowMode {
+    Exact,          //std::pow, the reference
+    Integer,        //repeated squaring for whole-number exponents (most scene files), std::pow otherwise
+    Table,          //per-material table over [0, 1] with linear interpolation, for previews
+    Approximate     //branch-free polynomial log2/exp2, see approximatePow
+};
+
+PowMode powModeFromName(std::string const &name);
+
+//x^n by repeated squaring in double, within an ulp of std::pow once rounded to float
+float integerPow(float x, int n);
+
+//x^y for x in [0, 1] and y >= 0 from polynomial log2 and exp2, no branches or tables. Relative error
+//below 2e-5 for y up to 1000 (for results above 1e-30), absolute error below 1e-6.
+float approximatePow(float x, float y);
+
+//x^exponent for x in [0, 1] as one material's specular term, set up once per render for a PowMode
+class SpecularPower {
+public:
+    //entries of the Table mode. Linear interpolation is off by at most e*(e-1)/(8*(tableSize-1)^2)
+    //for exponent e: about 1e-3 at shininess 200
+    static const int tableSize = 2048;
+
+    PowMode mode;
+    float exponent;
+
+    SpecularPower(float exponent = 1.0f, PowMode mode = PowMode::Exact);
+
+    float operator()(float x) const;
+
+private:
+    int integer;                //the exponent when it is a whole number, -1 otherwise
+    std::vector<float> table;
+};
@@ -0,0 +1,821 @@
+#include "FlatScene.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <typeinfo>
+
+#include "Sphere.h"
+#include "Cube.h"
+#include "Plane.h"
+#include "Cylinder.h"
+#include "Cone.h"
+#include "Disk.h"
+#include "CSG.h"
+#include "Stripe.h"
+#include "Ring.h"
+#include "Gradient.h"
+#include "Grid.h"
+#include "Solid.h"
+#include "NoisePattern.h"
+#include "Perturb.h"
+#include "Stats.h"
+
+FlatTransform::FlatTransform() : m{1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  0, 0, 0, 1} {};
+
+FlatTransform::FlatTransform(Matrix const &matrix) {
+    for (int i = 0; i < 16; i++) {
+        m[i] = matrix.array[i];
+    }
+};
+
+//same order of operations as Matrix * Tuple, so both give the same floats
+Tuple FlatTransform::operator* (Tuple const &tuple) const {
+    return {m[0]*tuple.x + m[1]*tuple.y + m[2]*tuple.z + m[3]*tuple.w,
+            m[4]*tuple.x + m[5]*tuple.y + m[6]*tuple.z + m[7]*tuple.w,
+            m[8]*tuple.x + m[9]*tuple.y + m[10]*tuple.z + m[11]*tuple.w,
+            m[12]*tuple.x + m[13]*tuple.y + m[14]*tuple.z + m[15]*tuple.w};
+};
+
+bool FlatTransform::identity() const {
+    for (int i = 0; i < 16; i++) {
+        if (m[i] != (i % 5 == 0 ? 1.0f : 0.0f)) {
+            return false;
+        }
+    }
+    return true;
+};
+
+Ray FlatTransform::operator* (Ray const &ray) const {
+    return ray.reframed((*this) * ray.origin, (*this) * ray.direction);
+};
+
+Acceleration accelerationFromName(std::string const &name) {
+    if (name == "none") {
+        return Acceleration::None;
+    }
+    if (name == "bvh") {
+        return Acceleration::BVH;
+    }
+    if (name == "grid") {
+        return Acceleration::Grid;
+    }
+    throw std::invalid_argument("unknown acceleration: " + name);
+};
+
+//exact types only, a subclass may override the shape's functions
+static ShapeType exactType(Object const* object) {
+    if (typeid(*object) == typeid(Sphere)) {
+        return ShapeType::Sphere;
+    }
+    if (typeid(*object) == typeid(Cube)) {
+        return ShapeType::Cube;
+    }
+    if (typeid(*object) == typeid(Plane)) {
+        return ShapeType::Plane;
+    }
+    if (typeid(*object) == typeid(Cylinder)) {
+        return ShapeType::Cylinder;
+    }
+    if (typeid(*object) == typeid(Cone)) {
+        return ShapeType::Cone;
+    }
+    if (typeid(*object) == typeid(Disk)) {
+        return ShapeType::Disk;
+    }
+    return ShapeType::Other;
+};
+
+FlatScene::FlatScene(std::vector<Object*> const &objects, PowMode specular, Acceleration acceleration) : acceleration(acceleration) {
+    std::vector<Bounds> boxes;
+    for (Object* object : objects) {
+        Matrix inverseTransform = inverse(object->transform);
+        FlatShape shape = makeShape(object, inverseTransform);
+
+        ShapeRef ref;
+        ref.type = exactType(object);
+        std::vector<FlatShape>* list;
+        switch (ref.type) {
+            case ShapeType::Sphere:
+                list = &spheres;
+                break;
+            case ShapeType::Cube:
+                list = &cubes;
+                break;
+            case ShapeType::Plane:
+                list = &planes;
+                break;
+            case ShapeType::Cylinder:
+                list = &cylinders;
+                break;
+            case ShapeType::Cone:
+                list = &cones;
+                break;
+            case ShapeType::Disk:
+                list = &disks;
+                break;
+            default:
+                list = &others;
+                break;
+        }
+        ref.index = list->size();
+        ref.order = lookup.size();
+        list->push_back(shape);
+        //BVH and grid leaves hold a few spheres, fewer than one 8 wide pass, and go one at a time
+        if (ref.type == ShapeType::Sphere && acceleration == Acceleration::None) {
+            sphereBatch.add(object, inverseTransform);
+        }
+        lookup[object] = ref;
+
+        if (acceleration != Acceleration::None) {
+            Bounds box = object->worldBounds();
+            if (box.finite()) {
+                bounded.push_back(ref);
+                boxes.push_back(box);
+            } else {
+                unbounded.push_back(ref);
+            }
+        }
+
+        if (typeid(*object) == typeid(CSG)) {
+            int csg = addMembers(object, inverseTransform);
+            (*list)[ref.index].csg = csg;
+        }
+    }
+    if (acceleration == Acceleration::Grid) {
+        grid.build(boxes);
+    } else {
+        bvh.build(boxes);
+    }
+
+    for (int i = 0; i < materials.size(); i++) {
+        specularPowers.push_back(SpecularPower(materials[i].shininess, specular));
+    }
+};
+
+FlatShape FlatScene::makeShape(Object* object, Matrix const &inverseTransform) {
+    FlatShape shape;
+    shape.object = object;
+    shape.inverse = inverseTransform;
+    shape.normalTransform = transpose(inverseTransform);
+    shape.pattern = object->material.pattern == nullptr ? -1 : addPattern(object->material.pattern);
+    shape.material = materials.intern(object->material);
+    shape.csg = -1;
+    return shape;
+};
+
+//the children of a CSG are shaded like any object but only intersected through it, returns the node
+//in `csgs`
+int FlatScene::addMembers(Object* csg, Matrix const &inverseTransform) {
+    FlatCSG node;
+    node.object = static_cast<CSG*>(csg);
+    int index = csgs.size();
+    csgs.push_back(node);
+
+    Object* children[2] = {node.object->left, node.object->right};
+    for (int i = 0; i < 2; i++) {
+        Object* child = children[i];
+        Matrix localInverse = inverse(child->transform);
+        Matrix childInverse = localInverse * inverseTransform;
+        ShapeRef ref;
+        ref.type = ShapeType::Member;
+        ref.index = members.size();
+        ref.order = lookup.size();
+        members.push_back(makeShape(child, childInverse));
+        lookup[child] = ref;
+
+        FlatShape local;
+        local.object = child;
+        local.inverse = localInverse;
+        local.normalTransform = transpose(localInverse);
+        local.pattern = -1;
+        local.material = -1;
+        local.csg = typeid(*child) == typeid(CSG) ? addMembers(child, childInverse) : -1;
+
+        Bounds box = child->worldBounds();
+        if (!box.empty() && box.finite()) {
+            box.min = box.min - Tuple::Vector(EPSILON, EPSILON, EPSILON);
+            box.max = box.max + Tuple::Vector(EPSILON, EPSILON, EPSILON);
+        }
+        csgs[index].children[i] = local;
+        csgs[index].types[i] = exactType(child);
+        csgs[index].bounds[i] = box;
+    }
+    return index;
+};
+
+int FlatScene::addPattern(Pattern* pattern) {
+    auto known = patternNodes.find(pattern);
+    if (known != patternNodes.end()) {
+        return known->second;
+    }
+
+    FlatPattern node;
+    node.inverse = inverse(pattern->transform);
+    node.childA = -1;
+    node.childB = -1;
+    node.source = pattern;
+
+    Pattern* childA = nullptr;
+    Pattern* childB = nullptr;
+    std::type_info const &type = typeid(*pattern);
+    if (type == typeid(Solid)) {
+        node.type = PatternType::Solid;
+        node.colorA = static_cast<Solid*>(pattern)->color;
+    } else if (type == typeid(Gradient)) {
+        node.type = PatternType::Gradient;
+        node.colorA = static_cast<Gradient*>(pattern)->colorA;
+        node.colorB = static_cast<Gradient*>(pattern)->colorB;
+    } else if (type == typeid(Stripe)) {
+        node.type = PatternType::Stripe;
+        childA = static_cast<Stripe*>(pattern)->patternA;
+        childB = static_cast<Stripe*>(pattern)->patternB;
+    } else if (type == typeid(Ring)) {
+        node.type = PatternType::Ring;
+        childA = static_cast<Ring*>(pattern)->patternA;
+        childB = static_cast<Ring*>(pattern)->patternB;
+    } else if (type == typeid(Grid)) {
+        node.type = PatternType::Grid;
+        childA = static_cast<Grid*>(pattern)->patternA;
+        childB = static_cast<Grid*>(pattern)->patternB;
+    } else if (type == typeid(NoisePattern)) {
+        node.type = PatternType::Noise;
+    } else if (type == typeid(Perturb)) {
+        node.type = PatternType::Perturb;
+        childA = static_cast<Perturb*>(pattern)->pattern;
+    } else {
+        node.type = PatternType::Other;
+    }
+    //multiplying by the identity gives back the same floats, so skipping it changes nothing
+    node.transformed = node.type != PatternType::Solid && !node.inverse.identity();
+
+    int index = patterns.size();
+    patterns.push_back(node);
+    patternNodes[pattern] = index;
+
+    //children go after the parent, so `node` may have moved by now
+    if (childA != nullptr) {
+        int a = addPattern(childA);
+        int b = childB == nullptr ? -1 : addPattern(childB);
+        patterns[index].childA = a;
+        patterns[index].childB = b;
+    }
+    return index;
+};
+
+
+//Intersection, same arithmetic as the localIntersects of each shape
+
+static const Bounds unitCube(Tuple::Point(-1.0f, -1.0f, -1.0f), Tuple::Point(1.0f, 1.0f, 1.0f));
+
+static bool intersectCube(FlatShape const &shape, Ray const &ray, float &tmin, float &tmax) {
+    return slabIntersect(unitCube, shape.inverse * ray, tmin, tmax);
+};
+
+//a plane only needs the y of the local ray, so only that row of the inverse is applied and no Ray
+//is built: six multiplies and one divide
+static bool intersectPlane(FlatShape const &shape, Ray const &ray, float &t) {
+    float const* m = shape.inverse.m;
+    float directionY = m[4]*ray.direction.x + m[5]*ray.direction.y + m[6]*ray.direction.z + m[7]*ray.direction.w;
+    if (directionY > EPSILON || directionY < -EPSILON) {
+        float originY = m[4]*ray.origin.x + m[5]*ray.origin.y + m[6]*ray.origin.z + m[7]*ray.origin.w;
+        t = -originY / directionY;
+        return true;
+    }
+    return false;
+};
+
+//one sphere at a time, for the BVH leaves; SphereBatch does the same for all of them at once
+static bool intersectSphere(FlatShape const &shape, Ray const &ray, float &t1, float &t2) {
+    Tuple origin = shape.inverse * ray.origin;
+    Tuple direction = shape.inverse * ray.direction;
+    Tuple sphereToRay = origin - Tuple::Point(0.0f, 0.0f, 0.0f);
+
+    float a = direction * direction;
+    float b = 2 * (direction * sphereToRay);
+    float c = (sphereToRay*sphereToRay) - 1.0f;
+
+    float det = (b*b) - (4*a*c);
+    if (det < 0) {
+        return false;
+    }
+    t1 = (-b - sqrt(det)) / (2*a);
+    t2 = (-b + sqrt(det)) / (2*a);
+    return true;
+};
+
+//shapes whose hits() writes to a fixed size array, called without the virtual localIntersects
+//and its vector
+template <class Shape>
+static void appendHits(std::vector<FlatShape> const &shapes, Ray const &ray, std::vector<Intersection> &intersections) {
+    for (FlatShape const &shape : shapes) {
+        STATS_COUNT(IntersectionTests);
+        float t[Shape::maxHits];
+        int count = static_cast<Shape const*>(shape.object)->hits(shape.inverse * ray, t);
+        for (int i = 0; i < count; i++) {
+            intersections.push_back(Intersection(*shape.object, t[i]));
+        }
+    }
+};
+
+template <class Shape, class Consider>
+static void considerHits(std::vector<FlatShape> const &shapes, Ray const &ray, Consider &consider) {
+    for (FlatShape const &shape : shapes) {
+        STATS_COUNT(IntersectionTests);
+        float t[Shape::maxHits];
+        int count = static_cast<Shape const*>(shape.object)->hits(shape.inverse * ray, t);
+        for (int i = 0; i < count; i++) {
+            consider(t[i]);
+        }
+    }
+};
+
+template <class Shape, class Emit>
+static void emitHits(FlatShape const &shape, Ray const &ray, Emit &emit) {
+    float t[Shape::maxHits];
+    int count = static_cast<Shape const*>(shape.object)->hits(shape.inverse * ray, t);
+    for (int i = 0; i < count; i++) {
+        emit(*shape.object, t[i]);
+    }
+};
+
+//one child of a CSG, appended for CSG::combine; `ray` is in the node's space
+void FlatScene::childHits(FlatShape const &child, ShapeType type, Ray const &ray, std::vector<Intersection> &intersections) const {
+    auto append = [&intersections](Object &object, float t) {
+        intersections.push_back(Intersection(object, t));
+    };
+    switch (type) {
+        case ShapeType::Sphere: {
+            float t1, t2;
+            if (intersectSphere(child, ray, t1, t2)) {
+                append(*child.object, t1);
+                append(*child.object, t2);
+            }
+            break;
+        }
+        case ShapeType::Cube: {
+            float tmin, tmax;
+            if (intersectCube(child, ray, tmin, tmax)) {
+                append(*child.object, tmin);
+                append(*child.object, tmax);
+            }
+            break;
+        }
+        case ShapeType::Plane: {
+            float t;
+            if (intersectPlane(child, ray, t)) {
+                append(*child.object, t);
+            }
+            break;
+        }
+        case ShapeType::Cylinder:
+            emitHits<Cylinder>(child, ray, append);
+            break;
+        case ShapeType::Cone:
+            emitHits<Cone>(child, ray, append);
+            break;
+        case ShapeType::Disk:
+            emitHits<Disk>(child, ray, append);
+            break;
+        default:
+            if (child.csg >= 0) {
+                csgHits(child.csg, child.inverse * ray, intersections);
+            } else {
+                for (Intersection const &intersection : child.object->localIntersects(child.inverse * ray)) {
+                    intersections.push_back(intersection);
+                }
+            }
+            break;
+    }
+};
+
+//CSG::intersect on the compiled children, `ray` in the node's space: appends the hits on the surface
+//of the result
+void FlatScene::csgHits(int csg, Ray const &ray, std::vector<Intersection> &intersections) const {
+    FlatCSG const &node = csgs[csg];
+    std::vector<Intersection>::size_type first = intersections.size();
+    for (int i = 0; i < 2; i++) {
+        //unbounded children are always tested, their slabs could come out NaN
+        float tmin, tmax;
+        if (!node.bounds[i].finite() || slabIntersect(node.bounds[i], ray, tmin, tmax)) {
+            STATS_COUNT(IntersectionTests);
+            childHits(node.children[i], node.types[i], ray, intersections);
+        }
+        if (i == 0 && intersections.size() == first && node.object->operation != CSGOperation::Union) {
+            //nothing is left of an intersection or difference where the left child is missed
+            return;
+        }
+    }
+    node.object->combine(intersections, first);
+};
+
+//a shape of the `others` list: a CSG through csgHits, anything else through localIntersects
+template <class Emit>
+void FlatScene::otherHits(FlatShape const &shape, Ray const &ray, Emit &emit) const {
+    if (shape.csg < 0) {
+        for (Intersection const &intersection : shape.object->localIntersects(shape.inverse * ray)) {
+            emit(*intersection.object, intersection.t);
+        }
+        return;
+    }
+    //reused by every CSG the thread meets, so once it has grown no ray allocates
+    thread_local std::vector<Intersection> scratch;
+    scratch.clear();
+    csgHits(shape.csg, shape.inverse * ray, scratch);
+    for (Intersection const &intersection : scratch) {
+        emit(*intersection.object, intersection.t);
+    }
+};
+
+//calls emit(object, t) for every hit of one shape along the whole line of the ray
+template <class Emit>
+void FlatScene::shapeHits(ShapeRef const &ref, Ray const &ray, Emit &emit) const {
+    STATS_COUNT(IntersectionTests);
+    switch (ref.type) {
+        case ShapeType::Sphere: {
+            float t1, t2;
+            if (intersectSphere(spheres[ref.index], ray, t1, t2)) {
+                emit(*spheres[ref.index].object, t1);
+                emit(*spheres[ref.index].object, t2);
+            }
+            break;
+        }
+        case ShapeType::Cube: {
+            float tmin, tmax;
+            if (intersectCube(cubes[ref.index], ray, tmin, tmax)) {
+                emit(*cubes[ref.index].object, tmin);
+                emit(*cubes[ref.index].object, tmax);
+            }
+            break;
+        }
+        case ShapeType::Plane: {
+            float t;
+            if (intersectPlane(planes[ref.index], ray, t)) {
+                emit(*planes[ref.index].object, t);
+            }
+            break;
+        }
+        case ShapeType::Cylinder:
+            emitHits<Cylinder>(cylinders[ref.index], ray, emit);
+            break;
+        case ShapeType::Cone:
+            emitHits<Cone>(cones[ref.index], ray, emit);
+            break;
+        case ShapeType::Disk:
+            emitHits<Disk>(disks[ref.index], ray, emit);
+            break;
+        case ShapeType::Other:
+            //a CSG reports its children's hits
+            otherHits(others[ref.index], ray, emit);
+            break;
+        case ShapeType::Member:
+            break;
+    }
+};
+
+//shapeHits() of every bounded shape the acceleration structure finds along the ray
+template <class Emit>
+void FlatScene::boundedHits(Ray const &ray, float tMin, float const &tMax, Emit &emit) const {
+    auto visit = [&](int primitive) {
+        shapeHits(bounded[primitive], ray, emit);
+    };
+    if (acceleration == Acceleration::Grid) {
+        grid.traverse(ray, tMin, tMax, visit);
+    } else {
+        bvh.traverse(ray, tMin, tMax, visit);
+    }
+};
+
+void FlatScene::intersect(Ray const &ray, std::vector<Intersection> &intersections) const {
+    if (acceleration != Acceleration::None) {
+        auto append = [&intersections](Object &object, float t) {
+            intersections.push_back(Intersection(object, t));
+        };
+        for (ShapeRef const &ref : unbounded) {
+            shapeHits(ref, ray, append);
+        }
+        //intersect() reports hits behind the origin too, so the walk covers the whole line
+        float const infinity = std::numeric_limits<float>::infinity();
+        boundedHits(ray, -infinity, infinity, append);
+        return;
+    }
+
+    //one tight loop per shape type
+    STATS_ADD(IntersectionTests, sphereBatch.size());
+    sphereBatch.intersect(ray, intersections);
+
+    for (FlatShape const &shape : cubes) {
+        STATS_COUNT(IntersectionTests);
+        float tmin, tmax;
+        if (intersectCube(shape, ray, tmin, tmax)) {
+            intersections.push_back(Intersection(*shape.object, tmin));
+            intersections.push_back(Intersection(*shape.object, tmax));
+        }
+    }
+    for (FlatShape const &shape : planes) {
+        STATS_COUNT(IntersectionTests);
+        float t;
+        if (intersectPlane(shape, ray, t)) {
+            intersections.push_back(Intersection(*shape.object, t));
+        }
+    }
+    appendHits<Cylinder>(cylinders, ray, intersections);
+    appendHits<Cone>(cones, ray, intersections);
+    appendHits<Disk>(disks, ray, intersections);
+    for (FlatShape const &shape : others) {
+        STATS_COUNT(IntersectionTests);
+        if (shape.csg >= 0) {
+            //straight into the caller's vector
+            csgHits(shape.csg, shape.inverse * ray, intersections);
+        } else {
+            std::vector<Intersection> local = shape.object->localIntersects(shape.inverse * ray);
+            intersections.insert(intersections.end(), local.begin(), local.end());
+        }
+    }
+};
+
+float FlatScene::nearestHit(Ray const &ray) const {
+    if (acceleration != Acceleration::None) {
+        float nearest = ray.tMax;
+        auto consider = [&nearest, &ray](Object &, float t) {
+            if (t > ray.tMin && t < nearest) {
+                nearest = t;
+            }
+        };
+        //a ground plane hit first shortens the walk below it
+        for (ShapeRef const &ref : unbounded) {
+            shapeHits(ref, ray, consider);
+        }
+        boundedHits(ray, ray.tMin, nearest, consider);
+        return nearest;
+    }
+
+    STATS_ADD(IntersectionTests, sphereBatch.size());
+    float nearest = sphereBatch.nearest(ray);
+
+    auto consider = [&nearest, &ray](float t) {
+        if (t > ray.tMin && t < nearest) {
+            nearest = t;
+        }
+    };
+    for (FlatShape const &shape : cubes) {
+        STATS_COUNT(IntersectionTests);
+        float tmin, tmax;
+        if (intersectCube(shape, ray, tmin, tmax)) {
+            consider(tmin);
+            consider(tmax);
+        }
+    }
+    for (FlatShape const &shape : planes) {
+        STATS_COUNT(IntersectionTests);
+        float t;
+        if (intersectPlane(shape, ray, t)) {
+            consider(t);
+        }
+    }
+    considerHits<Cylinder>(cylinders, ray, consider);
+    considerHits<Cone>(cones, ray, consider);
+    considerHits<Disk>(disks, ray, consider);
+    auto considerObject = [&consider](Object &, float t) {
+        consider(t);
+    };
+    for (FlatShape const &shape : others) {
+        STATS_COUNT(IntersectionTests);
+        otherHits(shape, ray, considerObject);
+    }
+    return nearest;
+};
+
+FlatShape const& FlatScene::shape(Object const* object, ShapeType &type) const {
+    ShapeRef const &ref = lookup.at(object);
+    type = ref.type;
+    switch (ref.type) {
+        case ShapeType::Sphere:
+            return spheres[ref.index];
+        case ShapeType::Cube:
+            return cubes[ref.index];
+        case ShapeType::Plane:
+            return planes[ref.index];
+        case ShapeType::Cylinder:
+            return cylinders[ref.index];
+        case ShapeType::Cone:
+            return cones[ref.index];
+        case ShapeType::Disk:
+            return disks[ref.index];
+        case ShapeType::Member:
+            return members[ref.index];
+        default:
+            return others[ref.index];
+    }
+};
+
+int FlatScene::order(Object const* object) const {
+    return lookup.at(object).order;
+};
+
+Tuple FlatScene::normalAt(Object const* object, Tuple const &point) const {
+    ShapeType type;
+    FlatShape const &flat = shape(object, type);
+    Tuple localPoint = flat.inverse * point;
+
+    Tuple localNormal;
+    switch (type) {
+        case ShapeType::Sphere:
+            localNormal = localPoint - Tuple::Point(0.0f, 0.0f, 0.0f);
+            break;
+        case ShapeType::Cube:
+            localNormal = cubeNormal(localPoint);
+            break;
+        case ShapeType::Plane:
+        case ShapeType::Disk:
+            localNormal = Tuple::Vector(0.0f, 1.0f, 0.0f);
+            break;
+        case ShapeType::Cylinder:
+            localNormal = static_cast<Cylinder const*>(flat.object)->normal(localPoint);
+            break;
+        case ShapeType::Cone:
+            localNormal = static_cast<Cone const*>(flat.object)->normal(localPoint);
+            break;
+        case ShapeType::Other:
+        case ShapeType::Member:
+            localNormal = flat.object->localNormalAt(localPoint);
+            break;
+    }
+
+    Tuple worldNormal = flat.normalTransform * localNormal;
+    worldNormal.w = 0;
+    return normalize(worldNormal);
+};
+
+SpecularPower const& FlatScene::specularPower(Object const* object) const {
+    ShapeType type;
+    return specularPowers[shape(object, type).material];
+};
+
+Material const& FlatScene::material(Object const* object) const {
+    ShapeType type;
+    return materials[shape(object, type).material];
+};
+
+Color FlatScene::colorAt(Object const* object, Tuple const &point) const {
+    ShapeType type;
+    FlatShape const &flat = shape(object, type);
+    if (flat.pattern < 0) {
+        return materials[flat.material].color;
+    }
+    STATS_COUNT(PatternEvaluations);
+    return patternColor(flat.pattern, flat.inverse * point);
+};
+
+//the interpreter: `point` starts in the space of the root's parent, each jump carries it into the child
+Color FlatScene::patternColor(int index, Tuple point) const {
+    while (true) {
+        FlatPattern const &node = patterns[index];
+        if (node.transformed) {
+            point = node.inverse * point;
+        }
+
+        switch (node.type) {
+            case PatternType::Solid:
+                return node.colorA;
+            case PatternType::Gradient: {
+                Color distance = node.colorB - node.colorA;
+                float fraction = point.x - floor(point.x);
+                return node.colorA + distance*fraction;
+            }
+            case PatternType::Stripe:
+                index = (int)std::floor(point.x) % 2 == 0 ? node.childA : node.childB;
+                break;
+            case PatternType::Ring:
+                index = (int)sqrt((point.x*point.x) + (point.z*point.z)) % 2 == 0 ? node.childA : node.childB;
+                break;
+            case PatternType::Grid:
+                index = ((int)(floor(point.x) + floor(point.y) + floor(point.z)) % 2) == 0 ? node.childA : node.childB;
+                break;
+            case PatternType::Noise: {
+                NoisePattern const* noise = static_cast<NoisePattern const*>(node.source);
+                return noise->color(noise->value(point));
+            }
+            case PatternType::Perturb:
+                point = Perturb::jitter(point, static_cast<Perturb const*>(node.source)->amount);
+                index = node.childA;
+                break;
+            case PatternType::Other:
+                return node.source->colorAt(point);
+        }
+    }
+};
+
+void FlatScene::colorsAt(Object const* object, std::vector<Tuple> const &worldPoints, std::vector<Color> &colors) const {
+    ShapeType type;
+    FlatShape const &flat = shape(object, type);
+    colors.resize(worldPoints.size());
+    if (flat.pattern < 0) {
+        std::fill(colors.begin(), colors.end(), materials[flat.material].color);
+        return;
+    }
+    STATS_ADD(PatternEvaluations, worldPoints.size());
+
+    std::vector<Tuple> points(worldPoints.size());
+    std::vector<int> order(worldPoints.size());
+    for (std::vector<Tuple>::size_type i = 0; i < points.size(); i++) {
+        points[i] = flat.inverse * worldPoints[i];
+        order[i] = i;
+    }
+
+    //the points in order[begin, end) are all at instruction `node`
+    class Group {
+    public:
+        int node;
+        int begin, end;
+    };
+    std::vector<Group> work = {{flat.pattern, 0, (int)order.size()}};
+
+    //the points of one group packed together, for the noise instructions
+    std::vector<Tuple> gathered;
+    std::vector<float> values;
+
+    while (!work.empty()) {
+        Group group = work.back();
+        work.pop_back();
+        FlatPattern const &node = patterns[group.node];
+        int* first = order.data() + group.begin;
+        int* last = order.data() + group.end;
+
+        if (node.transformed) {
+            for (int* i = first; i != last; i++) {
+                points[*i] = node.inverse * points[*i];
+            }
+        }
+
+        int* split = first;
+        switch (node.type) {
+            case PatternType::Solid:
+                for (int* i = first; i != last; i++) {
+                    colors[*i] = node.colorA;
+                }
+                continue;
+            case PatternType::Gradient: {
+                Color distance = node.colorB - node.colorA;
+                for (int* i = first; i != last; i++) {
+                    float fraction = points[*i].x - floor(points[*i].x);
+                    colors[*i] = node.colorA + distance*fraction;
+                }
+                continue;
+            }
+            case PatternType::Noise: {
+                NoisePattern const* noise = static_cast<NoisePattern const*>(node.source);
+                gathered.clear();
+                for (int* i = first; i != last; i++) {
+                    gathered.push_back(points[*i]);
+                }
+                values.resize(gathered.size());
+                noise->values(gathered.data(), values.data(), gathered.size());
+                for (int* i = first; i != last; i++) {
+                    colors[*i] = noise->color(values[i - first]);
+                }
+                continue;
+            }
+            case PatternType::Perturb:
+                gathered.clear();
+                for (int* i = first; i != last; i++) {
+                    gathered.push_back(points[*i]);
+                }
+                Perturb::jitter(gathered.data(), gathered.size(), static_cast<Perturb const*>(node.source)->amount);
+                for (int* i = first; i != last; i++) {
+                    points[*i] = gathered[i - first];
+                }
+                work.push_back({node.childA, group.begin, group.end});
+                continue;
+            case PatternType::Other:
+                for (int* i = first; i != last; i++) {
+                    colors[*i] = node.source->colorAt(points[*i]);
+                }
+                continue;
+            case PatternType::Stripe:
+                split = std::partition(first, last, [&points](int i) {
+                    return (int)std::floor(points[i].x) % 2 == 0;
+                });
+                break;
+            case PatternType::Ring:
+                split = std::partition(first, last, [&points](int i) {
+                    return (int)sqrt((points[i].x*points[i].x) + (points[i].z*points[i].z)) % 2 == 0;
+                });
+                break;
+            case PatternType::Grid:
+                split = std::partition(first, last, [&points](int i) {
+                    return ((int)(floor(points[i].x) + floor(points[i].y) + floor(points[i].z)) % 2) == 0;
+                });
+                break;
+        }
+
+        int middle = split - order.data();
+        if (middle > group.begin) {
+            work.push_back({node.childA, group.begin, middle});
+        }
+        if (middle < group.end) {
+            work.push_back({node.childB, middle, group.end});
+        }
+    }
+};
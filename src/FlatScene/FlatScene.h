@@ -0,0 +1,178 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Matrix.h"
+#include "Object.h"
+#include "Pattern.h"
+#include "Intersection.h"
+#include "CSG.h"
+#include "Ray.h"
+#include "SphereBatch.h"
+#include "BVH.h"
+#include "UniformGrid.h"
+
+//4x4 matrix held by value, row-major, for transforms that are inverted once per render
+class FlatTransform {
+public:
+    float m[16];
+
+    FlatTransform();
+    FlatTransform(Matrix const &matrix);
+
+    Tuple operator* (Tuple const &tuple) const;
+    Ray operator* (Ray const &ray) const;
+
+    bool identity() const;
+};
+
+enum class ShapeType {
+    Sphere,
+    Cube,
+    Plane,
+    Cylinder,
+    Cone,
+    Disk,
+    Other,      //any other Object subclass, dispatched through its virtual functions
+    Member      //part of a CSG, only intersected through it
+};
+
+//how FlatScene finds the shapes a ray meets
+enum class Acceleration {
+    None,       //tests every shape, one loop per type
+    BVH,        //shapes with finite bounds in a BVH, planes and other unbounded shapes tested on their own
+    Grid        //the same split with a UniformGrid instead, for many objects of about the same size
+};
+
+//"none", "bvh" or "grid", throws std::invalid_argument for anything else
+Acceleration accelerationFromName(std::string const &name);
+
+class FlatShape {
+public:
+    Object* object;
+    FlatTransform inverse;          //world -> object space
+    FlatTransform normalTransform;  //transpose of inverse, object normals -> world
+    int pattern;                    //root node in FlatScene::patterns, -1 -> material color
+    int material;                   //in FlatScene::materials
+    int csg;                        //in FlatScene::csgs when the object is a CSG, -1 otherwise
+};
+
+//A CSG compiled: its two children are intersected through the same typed paths as the top level
+//shapes, in the node's space like CSG::localIntersects, and combined in one caller-owned vector
+class FlatCSG {
+public:
+    CSG* object;
+    FlatShape children[2];  //left and right, `inverse` goes from the node's space to the child's
+    ShapeType types[2];     //exact type of each child, Other for a CSG or any other subclass
+    Bounds bounds[2];       //of each child in the node's space, padded like CSG's own
+};
+
+enum class PatternType {
+    Solid,
+    Stripe,
+    Ring,
+    Gradient,
+    Grid,
+    Noise,      //NoisePattern, through its batched noise
+    Perturb,    //jitters the point, then jumps to childA
+    Other       //any other Pattern subclass, dispatched through colorAt
+};
+
+//One instruction of the pattern bytecode: transform the point, then either produce a color or jump
+//to childA or childB. `inverse` maps the parent's space into this pattern's space.
+class FlatPattern {
+public:
+    PatternType type;
+    bool transformed;       //false when `inverse` is the identity or the instruction ignores the point
+    FlatTransform inverse;
+    Color colorA, colorB;   //Solid uses colorA, Gradient both
+    int childA, childB;     //jump targets of Stripe, Ring, Grid and Perturb (childA only)
+    Pattern* source;
+};
+
+//The objects of a World compiled down for rendering: shapes grouped in one contiguous array per
+//type with their inverse transforms cached, and pattern trees compiled into one array of bytecode
+//instructions with their transforms pre-inverted, run by a loop instead of virtual calls.
+//Intersection, normals and pattern colors dispatch on the type tag instead of virtual calls.
+//The Object hierarchy stays the authoring API; compile again after changing it.
+class FlatScene {
+public:
+    std::vector<FlatShape> spheres;
+    std::vector<FlatShape> cubes;
+    std::vector<FlatShape> planes;
+    std::vector<FlatShape> cylinders;
+    std::vector<FlatShape> cones;
+    std::vector<FlatShape> disks;
+    std::vector<FlatShape> others;
+    std::vector<FlatShape> members;     //CSG descendants, their inverse goes from world space through every parent
+    std::vector<FlatCSG> csgs;
+    std::vector<FlatPattern> patterns;
+    MaterialTable materials;        //deduplicated, objects with identical materials share one entry
+    std::vector<SpecularPower> specularPowers;  //one per material, for the PowMode compiled with
+
+    //the spheres again, laid out for intersecting several at once; only filled for Acceleration::None,
+    //the BVH and grid intersect the few spheres of a leaf one at a time
+    SphereBatch sphereBatch;
+
+    class ShapeRef {
+    public:
+        ShapeType type;
+        int index;      //in the list for `type`
+        int order;
+    };
+
+    Acceleration acceleration;
+    std::vector<ShapeRef> bounded;      //numbered the way `bvh` or `grid` refers to them, empty for None
+    std::vector<ShapeRef> unbounded;    //tested before walking `bvh` or `grid`, empty for None
+    BVH bvh;
+    UniformGrid grid;
+
+    FlatScene(std::vector<Object*> const &objects, PowMode specular = PowMode::Exact, Acceleration acceleration = Acceleration::BVH);
+
+    //appends the intersections with every shape to `intersections`, unsorted
+    void intersect(Ray const &ray, std::vector<Intersection> &intersections) const;
+
+    //smallest t in the ray's (tMin, tMax) over every shape, tMax for none: with the default range,
+    //what hit() would pick from intersect()
+    float nearestHit(Ray const &ray) const;
+
+    //same results as the Object methods, `object` must be one of the compiled objects
+    Tuple normalAt(Object const* object, Tuple const &point) const;
+
+    //the interned copy of the object's material
+    Material const& material(Object const* object) const;
+
+    //colorAt for many points on one object: each instruction transforms and routes all the points
+    //that reach it in one loop, instead of walking the pattern once per point
+    void colorsAt(Object const* object, std::vector<Tuple> const &points, std::vector<Color> &colors) const;
+
+    //shininess of the object's material under the compiled PowMode
+    SpecularPower const& specularPower(Object const* object) const;
+
+    //pattern color at `point`, or the material color for objects without a pattern
+    Color colorAt(Object const* object, Tuple const &point) const;
+
+    //position of `object` in the list it was compiled from, breaks ties between equal t the way
+    //sorting the per-object intersections did
+    int order(Object const* object) const;
+
+private:
+    std::unordered_map<Object const*, ShapeRef> lookup;
+    std::unordered_map<Pattern const*, int> patternNodes;
+
+    FlatShape const& shape(Object const* object, ShapeType &type) const;
+    FlatShape makeShape(Object* object, Matrix const &inverseTransform);
+    int addMembers(Object* csg, Matrix const &inverseTransform);
+    void csgHits(int csg, Ray const &ray, std::vector<Intersection> &intersections) const;
+    void childHits(FlatShape const &child, ShapeType type, Ray const &ray, std::vector<Intersection> &intersections) const;
+    template <class Emit>
+    void otherHits(FlatShape const &shape, Ray const &ray, Emit &emit) const;
+    int addPattern(Pattern* pattern);
+    template <class Emit>
+    void shapeHits(ShapeRef const &ref, Ray const &ray, Emit &emit) const;
+    template <class Emit>
+    void boundedHits(Ray const &ray, float tMin, float const &tMax, Emit &emit) const;
+    Color patternColor(int node, Tuple point) const;
+};
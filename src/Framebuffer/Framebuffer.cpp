@@ -0,0 +1,7 @@
+#include "Framebuffer.h"
+
+Framebuffer::Framebuffer(int width, int height) : width(width), height(height) {};
+
+Framebuffer::~Framebuffer() {};
+
+void Framebuffer::regionDone(int x, int y, int width, int height) {};
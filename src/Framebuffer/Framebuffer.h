@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Color.h"
+
+//Pixel storage render() writes into. Several threads write at once, never to the same pixel.
+class Framebuffer {
+public:
+    int width, height;
+
+    Framebuffer(int width, int height);
+    virtual ~Framebuffer();
+
+    virtual Color pixelAt(int x, int y) const = 0;
+    virtual void writePixel(int x, int y, Color const& color) = 0;
+
+    //the pixels of this rectangle are final, backends that stream to disk can let go of them
+    virtual void regionDone(int x, int y, int width, int height);
+};
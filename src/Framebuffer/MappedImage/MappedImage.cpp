@@ -0,0 +1,141 @@
+#include "MappedImage.h"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+static unsigned char toByte(float value) {
+    float scaled = value * 255.0f;
+    if (scaled < 0.0f) {
+        return 0;
+    }
+    if (scaled > 255.0f) {
+        return 255;
+    }
+    return (unsigned char)std::lround(scaled);
+};
+
+#ifdef _WIN32
+
+MappedImage::MappedImage(std::string const &path, int width, int height, ImageFormat format) : Framebuffer(width, height) {
+    throw std::runtime_error("memory-mapped images are not supported on this platform");
+};
+
+MappedImage::~MappedImage() {};
+
+void MappedImage::sync() {};
+
+void MappedImage::releaseRow(int y) {};
+
+#else
+
+MappedImage::MappedImage(std::string const &path, int width, int height, ImageFormat format) :
+    Framebuffer(width, height), format(format), fd(-1), map(nullptr), mapSize(0),
+    rowPixelsDone(new std::atomic<int>[height]) {
+    std::string header;
+    if (format == ImageFormat::PPMBinary) {
+        header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+        rowSize = (std::size_t)width * 3;
+    } else if (format == ImageFormat::PFM) {
+        header = "PF\n" + std::to_string(width) + " " + std::to_string(height) + "\n-1.0\n";
+        rowSize = (std::size_t)width * 3 * sizeof(float);
+    } else {
+        throw std::runtime_error("memory-mapped images are binary PPM or PFM");
+    }
+    headerSize = header.size();
+    mapSize = headerSize + rowSize * height;
+
+    for (int y = 0; y < height; y++) {
+        rowPixelsDone[y] = 0;
+    }
+
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, mapSize) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        throw std::runtime_error("cannot create " + path);
+    }
+
+    //pages of a fresh file read back as zeros: black for both formats
+    void* address = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error("cannot map " + path);
+    }
+    map = static_cast<unsigned char*>(address);
+    std::memcpy(map, header.data(), headerSize);
+};
+
+MappedImage::~MappedImage() {
+    if (map != nullptr) {
+        munmap(map, mapSize);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+};
+
+void MappedImage::sync() {
+    msync(map, mapSize, MS_SYNC);
+};
+
+void MappedImage::releaseRow(int y) {
+    //only pages lying entirely inside the row, neighbouring rows may still be in use
+    std::size_t page = sysconf(_SC_PAGESIZE);
+    unsigned char* rowStart = pixelAddress(0, y);
+    std::size_t start = ((std::size_t)(rowStart - map) + page - 1) / page * page;
+    std::size_t end = ((std::size_t)(rowStart - map) + rowSize) / page * page;
+
+    if (end > start) {
+        //dirty pages stay in the page cache and reach the file through normal writeback
+        msync(map + start, end - start, MS_ASYNC);
+        madvise(map + start, end - start, MADV_DONTNEED);
+    }
+};
+
+#endif
+
+unsigned char* MappedImage::pixelAddress(int x, int y) const {
+    if (format == ImageFormat::PFM) {
+        return map + headerSize + rowSize * (height - 1 - y) + (std::size_t)x * 3 * sizeof(float);
+    }
+    return map + headerSize + rowSize * y + (std::size_t)x * 3;
+};
+
+Color MappedImage::pixelAt(int x, int y) const {
+    unsigned char* pixel = pixelAddress(x, y);
+    if (format == ImageFormat::PFM) {
+        float rgb[3];
+        std::memcpy(rgb, pixel, sizeof(rgb));
+        return {rgb[0], rgb[1], rgb[2]};
+    }
+    return {pixel[0] / 255.0f, pixel[1] / 255.0f, pixel[2] / 255.0f};
+};
+
+void MappedImage::writePixel(int x, int y, Color const& color) {
+    unsigned char* pixel = pixelAddress(x, y);
+    if (format == ImageFormat::PFM) {
+        float rgb[3] = {color.red, color.green, color.blue};
+        std::memcpy(pixel, rgb, sizeof(rgb));
+    } else {
+        pixel[0] = toByte(color.red);
+        pixel[1] = toByte(color.green);
+        pixel[2] = toByte(color.blue);
+    }
+};
+
+void MappedImage::regionDone(int x, int y, int width, int height) {
+    for (int row = y; row < y + height; row++) {
+        if ((rowPixelsDone[row] += width) == this->width) {
+            releaseRow(row);
+        }
+    }
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "Framebuffer.h"
+#include "Canvas.h"
+
+//Framebuffer backed by a memory-mapped image file (binary PPM or PFM). Pixels are encoded into the
+//file as they are written, and rows are handed back to the kernel once complete, so resident memory
+//follows the rows being rendered rather than the image size.
+class MappedImage : public Framebuffer {
+public:
+    //creates (or truncates) `path`, throws std::runtime_error if it cannot be mapped
+    MappedImage(std::string const &path, int width, int height, ImageFormat format);
+    ~MappedImage();
+
+    MappedImage(MappedImage const &other) = delete;
+    void operator=(MappedImage const &other) = delete;
+
+    Color pixelAt(int x, int y) const override;
+    void writePixel(int x, int y, Color const& color) override;
+    void regionDone(int x, int y, int width, int height) override;
+
+    //writes everything back to the file
+    void sync();
+
+private:
+    ImageFormat format;
+    int fd;
+    unsigned char* map;
+    std::size_t mapSize;
+    std::size_t headerSize;
+    std::size_t rowSize;
+    std::unique_ptr<std::atomic<int>[]> rowPixelsDone;
+
+    unsigned char* pixelAddress(int x, int y) const;
+    void releaseRow(int y);
+};
@@ -1,7 +1,9 @@
 #include "Material.h"
 #include <cmath>
+#include <functional>
 
 #include "Object.h"
+#include "Stats.h"
 
 Material::Material(Color const &color, float ambient, float diffuse, float specular, float shininess, float reflective, float transparency, float refractive_index) :
      pattern(nullptr), 
@@ -32,13 +34,60 @@ void Material::setPattern(Pattern &p) {
     pattern = &p;
 };
 
+//every field counts, unlike operator==
+static bool identical(Material const &a, Material const &b) {
+    return a.color.red == b.color.red && a.color.green == b.color.green && a.color.blue == b.color.blue &&
+           a.ambient == b.ambient && a.diffuse == b.diffuse && a.specular == b.specular && a.shininess == b.shininess &&
+           a.reflective == b.reflective && a.transparency == b.transparency && a.refractive_index == b.refractive_index &&
+           a.pattern == b.pattern;
+};
+
+static std::size_t hashMaterial(Material const &material) {
+    float const fields[10] = {material.color.red, material.color.green, material.color.blue, material.ambient, material.diffuse,
+                              material.specular, material.shininess, material.reflective, material.transparency, material.refractive_index};
+    std::size_t hash = std::hash<Pattern const*>()(material.pattern);
+    for (float field : fields) {
+        hash = hash*31 + std::hash<float>()(field);
+    }
+    return hash;
+};
+
+int MaterialTable::intern(Material const &material) {
+    std::size_t hash = hashMaterial(material);
+    auto range = byHash.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (identical(materials[it->second], material)) {
+            return it->second;
+        }
+    }
+
+    materials.push_back(material);
+    int index = materials.size() - 1;
+    byHash.emplace(hash, index);
+    return index;
+};
+
+Material const& MaterialTable::operator[](int index) const {
+    return materials[index];
+};
+
+int MaterialTable::size() const {
+    return materials.size();
+};
+
 
 //Out of class
 Color lighting(Object* object, Light const &light, Tuple const &position, Tuple const &eyeDirection, Tuple const &normal, bool inShadow) {
-    Material material = object->material;
-    
+    Material const &material = object->material;
     Color materialColor = (material.pattern == nullptr) ? material.color : object->colorAt(position);
 
+    return lighting(material, materialColor, light, position, eyeDirection, normal, inShadow);
+};
+
+Color lighting(Material const &material, Color const &materialColor, Light const &light, Tuple const &position, Tuple const &eyeDirection, Tuple const &normal, bool inShadow,
+               SpecularPower const *specularPower) {
+    STATS_COUNT(LightingCalls);
+
     Color effectiveColor = materialColor * light.intensity;
 
     Tuple pointToLightSource = normalize(light.position - position);
@@ -53,7 +102,7 @@ Color lighting(Object* object, Light const &light, Tuple const &position, Tuple
         Tuple reflectv = reflect(-pointToLightSource, normal);
         float reflectDotEye = reflectv * eyeDirection;
         if (reflectDotEye > 0.0f) {
-            float factor = pow(reflectDotEye, material.shininess);
+            float factor = specularPower != nullptr ? (*specularPower)(reflectDotEye) : std::pow(reflectDotEye, material.shininess);
             specular = light.intensity * material.specular * factor;
         }
     } 
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
 #include "Color.h"
 #include "Light.h"
 #include "Pattern.h"
+#include "FastPow.h"
 
 class Object;
 
@@ -32,9 +37,31 @@ public:
     bool operator== (Material const &other);
     bool operator!= (Material const &other);
 
+    //the material only points at `p`, which must outlive it and every FlatScene compiled from it;
+    //scenes make their patterns in World::patterns, which owns them
     void setPattern(Pattern &p);
 };
 
+//Materials stored once and referred to by index. Materials with the same values and pattern
+//share an index, so thousands of objects made of a few materials touch only a few entries.
+class MaterialTable {
+public:
+    //index of a material identical to `material`, adding it when there is none
+    int intern(Material const &material);
+
+    Material const& operator[](int index) const;
+    int size() const;
+
+private:
+    std::vector<Material> materials;
+    std::unordered_multimap<std::size_t, int> byHash;
+};
+
 
 //Out of class
-Color lighting(Object* object, Light const &light, Tuple const &position, Tuple const &eyeDirection, Tuple const &normal, bool inShadow);
\ No newline at end of file
+Color lighting(Object* object, Light const &light, Tuple const &position, Tuple const &eyeDirection, Tuple const &normal, bool inShadow);
+
+//`surfaceColor` is the material or pattern color at `position`, `specularPower` (when given) raises to the
+//material's shininess in place of pow
+Color lighting(Material const &material, Color const &surfaceColor, Light const &light, Tuple const &position, Tuple const &eyeDirection, Tuple const &normal, bool inShadow,
+               SpecularPower const *specularPower = nullptr);
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Matrix.h"
+#include "Stats.h"
 #include <iostream>
 #include <cmath>
 
@@ -60,17 +61,29 @@ Matrix::Matrix(
 
 Matrix::Matrix(int dimension) : array{new float[dimension*dimension]}, dimension{dimension} {};
 
-Matrix::Matrix() {};
+Matrix::Matrix() : array{nullptr}, dimension(0) {};
+
+Matrix::Matrix(Matrix const& other) : array{new float[other.dimension*other.dimension]}, dimension(other.dimension) {
+  for(int i = 0; i < dimension*dimension; i++) {
+    array[i] = other.array[i];
+  }
+};
+
 Matrix::~Matrix() {
   delete[] array;
 };
 
 void Matrix::operator=(Matrix const& other){
-  (*this).dimension = other.dimension;
-  (*this).array = new float[other.dimension*other.dimension];
+  if (this == &other) { return; }
+
+  float* copy = new float[other.dimension*other.dimension];
   for(int i = 0; i < other.dimension*other.dimension; i++) {
-    (*this).array[i] = other.array[i];
+    copy[i] = other.array[i];
   }
+
+  delete[] array;
+  (*this).array = copy;
+  (*this).dimension = other.dimension;
 };
 
 //Operator overloads
@@ -238,6 +251,7 @@ bool isInvertible(Matrix const& matrix) {
 };
 
 Matrix inverse(Matrix const& matrix) {
+  STATS_COUNT(MatrixInversions);
   Matrix inv = Matrix(matrix.dimension);
   float det = determinant(matrix);
 
@@ -30,6 +30,7 @@ public:
     Matrix(int dimension); 
 
     Matrix();
+    Matrix(Matrix const& other);
     ~Matrix();
     
     //Operator overloads
@@ -0,0 +1,267 @@
+#include "Noise.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NOISE_AVX2
+#include <immintrin.h>
+#endif
+
+//the reference permutation twice over, so p[i + 1] and p[p[i] + j] never need wrapping
+alignas(64) static const std::int32_t permutation[512] = {
+    151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+    140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+    247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+    57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+    74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+    60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+    65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+    200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+    52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+    207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+    119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+    129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+    218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+    81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+    184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+    222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180,
+    151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+    140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+    247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+    57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+    74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+    60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+    65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+    200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+    52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+    207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+    119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+    129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+    218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+    81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+    184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+    222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180
+};
+
+static inline float fade(float t) {
+    return t*t*t*(t*(t*6.0f - 15.0f) + 10.0f);
+};
+
+static inline float lerp(float t, float a, float b) {
+    return a + t*(b - a);
+};
+
+//dot product of (x, y, z) with one of 12 edge directions picked by the hash
+static inline float grad(int hash, float x, float y, float z) {
+    int h = hash & 15;
+    float u = h < 8 ? x : y;
+    float v = h < 4 ? y : (h == 12 || h == 14 ? x : z);
+    return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+};
+
+float perlin(float x, float y, float z) {
+    float fx = std::floor(x);
+    float fy = std::floor(y);
+    float fz = std::floor(z);
+    int X = (int)fx & 255;
+    int Y = (int)fy & 255;
+    int Z = (int)fz & 255;
+    x -= fx;
+    y -= fy;
+    z -= fz;
+    float u = fade(x);
+    float v = fade(y);
+    float w = fade(z);
+
+    std::int32_t const* p = permutation;
+    int A = p[X] + Y, AA = p[A] + Z, AB = p[A + 1] + Z;
+    int B = p[X + 1] + Y, BA = p[B] + Z, BB = p[B + 1] + Z;
+
+    return lerp(w, lerp(v, lerp(u, grad(p[AA], x, y, z), grad(p[BA], x - 1.0f, y, z)),
+                           lerp(u, grad(p[AB], x, y - 1.0f, z), grad(p[BB], x - 1.0f, y - 1.0f, z))),
+                   lerp(v, lerp(u, grad(p[AA + 1], x, y, z - 1.0f), grad(p[BA + 1], x - 1.0f, y, z - 1.0f)),
+                           lerp(u, grad(p[AB + 1], x, y - 1.0f, z - 1.0f), grad(p[BB + 1], x - 1.0f, y - 1.0f, z - 1.0f))));
+};
+
+float perlin(Tuple const &point) {
+    return perlin(point.x, point.y, point.z);
+};
+
+static bool cpuHasAVX2() {
+#ifdef NOISE_AVX2
+    //runs from a static initializer, before the CPU model is known otherwise
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+};
+
+static std::atomic<bool> avx2Enabled(cpuHasAVX2());
+
+void enableNoiseAVX2(bool enabled) {
+    avx2Enabled = enabled && cpuHasAVX2();
+};
+
+bool usingNoiseAVX2() {
+    return avx2Enabled;
+};
+
+#ifdef NOISE_AVX2
+
+//the scalar helpers 8 lanes at a time, with the same operations in the same order
+
+__attribute__((target("avx2")))
+static inline __m256 fade8(__m256 t) {
+    __m256 inner = _mm256_add_ps(_mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f))), _mm256_set1_ps(10.0f));
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+};
+
+__attribute__((target("avx2")))
+static inline __m256 lerp8(__m256 t, __m256 a, __m256 b) {
+    return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+};
+
+__attribute__((target("avx2")))
+static inline __m256 grad8(__m256i hash, __m256 x, __m256 y, __m256 z) {
+    __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(15));
+    __m256 uIsY = _mm256_castsi256_ps(_mm256_cmpgt_epi32(h, _mm256_set1_epi32(7)));
+    __m256 vIsY = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h));
+    __m256 vIsX = _mm256_castsi256_ps(_mm256_or_si256(_mm256_cmpeq_epi32(h, _mm256_set1_epi32(12)),
+                                                      _mm256_cmpeq_epi32(h, _mm256_set1_epi32(14))));
+    __m256 u = _mm256_blendv_ps(x, y, uIsY);
+    __m256 v = _mm256_blendv_ps(_mm256_blendv_ps(z, x, vIsX), y, vIsY);
+
+    //negating is flipping the sign bit, bits 0 and 1 of the hash move onto it
+    __m256 signU = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31));
+    __m256 signV = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30));
+    return _mm256_add_ps(_mm256_xor_ps(u, signU), _mm256_xor_ps(v, signV));
+};
+
+__attribute__((target("avx2")))
+static inline __m256i lookup8(__m256i index) {
+    return _mm256_i32gather_epi32(reinterpret_cast<int const*>(permutation), index, 4);
+};
+
+__attribute__((target("avx2")))
+static __m256 perlin8(__m256 x, __m256 y, __m256 z) {
+    __m256 fx = _mm256_floor_ps(x);
+    __m256 fy = _mm256_floor_ps(y);
+    __m256 fz = _mm256_floor_ps(z);
+    __m256i mask = _mm256_set1_epi32(255);
+    __m256i X = _mm256_and_si256(_mm256_cvttps_epi32(fx), mask);
+    __m256i Y = _mm256_and_si256(_mm256_cvttps_epi32(fy), mask);
+    __m256i Z = _mm256_and_si256(_mm256_cvttps_epi32(fz), mask);
+    x = _mm256_sub_ps(x, fx);
+    y = _mm256_sub_ps(y, fy);
+    z = _mm256_sub_ps(z, fz);
+    __m256 u = fade8(x);
+    __m256 v = fade8(y);
+    __m256 w = fade8(z);
+
+    __m256i one = _mm256_set1_epi32(1);
+    __m256i A = _mm256_add_epi32(lookup8(X), Y);
+    __m256i AA = _mm256_add_epi32(lookup8(A), Z);
+    __m256i AB = _mm256_add_epi32(lookup8(_mm256_add_epi32(A, one)), Z);
+    __m256i B = _mm256_add_epi32(lookup8(_mm256_add_epi32(X, one)), Y);
+    __m256i BA = _mm256_add_epi32(lookup8(B), Z);
+    __m256i BB = _mm256_add_epi32(lookup8(_mm256_add_epi32(B, one)), Z);
+
+    __m256 x1 = _mm256_sub_ps(x, _mm256_set1_ps(1.0f));
+    __m256 y1 = _mm256_sub_ps(y, _mm256_set1_ps(1.0f));
+    __m256 z1 = _mm256_sub_ps(z, _mm256_set1_ps(1.0f));
+
+    __m256 near = lerp8(v, lerp8(u, grad8(lookup8(AA), x, y, z), grad8(lookup8(BA), x1, y, z)),
+                           lerp8(u, grad8(lookup8(AB), x, y1, z), grad8(lookup8(BB), x1, y1, z)));
+    __m256 far = lerp8(v, lerp8(u, grad8(lookup8(_mm256_add_epi32(AA, one)), x, y, z1), grad8(lookup8(_mm256_add_epi32(BA, one)), x1, y, z1)),
+                          lerp8(u, grad8(lookup8(_mm256_add_epi32(AB, one)), x, y1, z1), grad8(lookup8(_mm256_add_epi32(BB, one)), x1, y1, z1)));
+    return lerp8(w, near, far);
+};
+
+//the points in whole groups of 8, returns how many it did
+__attribute__((target("avx2")))
+static int perlinAVX2(float const* x, float const* y, float const* z, float* values, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(values + i, perlin8(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), _mm256_loadu_ps(z + i)));
+    }
+    return i;
+};
+
+#endif
+
+void perlin(float const* x, float const* y, float const* z, float* values, int count) {
+    int i = 0;
+#ifdef NOISE_AVX2
+    if (avx2Enabled) {
+        i = perlinAVX2(x, y, z, values, count);
+    }
+#endif
+    for (; i < count; i++) {
+        values[i] = perlin(x[i], y[i], z[i]);
+    }
+};
+
+//fbm and turbulence of a single point, with its octaves as the lanes of one batch
+static float octaves(Tuple const &point, int octaves, float lacunarity, float gain, bool absolute) {
+    float x[8], y[8], z[8], noise[8];
+    float sum = 0.0f;
+    float amplitude = 1.0f;
+    float frequency = 1.0f;
+    for (int first = 0; first < octaves; first += 8) {
+        int count = std::min(8, octaves - first);
+        for (int i = 0; i < count; i++) {
+            x[i] = point.x*frequency;
+            y[i] = point.y*frequency;
+            z[i] = point.z*frequency;
+            frequency *= lacunarity;
+        }
+        perlin(x, y, z, noise, count);
+        for (int i = 0; i < count; i++) {
+            sum += amplitude*(absolute ? std::fabs(noise[i]) : noise[i]);
+            amplitude *= gain;
+        }
+    }
+    return sum;
+};
+
+//the same sums over many points, one octave of all of them per batch
+static void octaves(Tuple const* points, float* values, int count, int octaves, float lacunarity, float gain, bool absolute) {
+    std::vector<float> x(count), y(count), z(count), noise(count);
+    std::fill(values, values + count, 0.0f);
+    float amplitude = 1.0f;
+    float frequency = 1.0f;
+    for (int octave = 0; octave < octaves; octave++) {
+        for (int i = 0; i < count; i++) {
+            x[i] = points[i].x*frequency;
+            y[i] = points[i].y*frequency;
+            z[i] = points[i].z*frequency;
+        }
+        perlin(x.data(), y.data(), z.data(), noise.data(), count);
+        for (int i = 0; i < count; i++) {
+            values[i] += amplitude*(absolute ? std::fabs(noise[i]) : noise[i]);
+        }
+        amplitude *= gain;
+        frequency *= lacunarity;
+    }
+};
+
+float fbm(Tuple const &point, int octaves, float lacunarity, float gain) {
+    return ::octaves(point, octaves, lacunarity, gain, false);
+};
+
+void fbm(Tuple const* points, float* values, int count, int octaves, float lacunarity, float gain) {
+    ::octaves(points, values, count, octaves, lacunarity, gain, false);
+};
+
+float turbulence(Tuple const &point, int octaves, float lacunarity, float gain) {
+    return ::octaves(point, octaves, lacunarity, gain, true);
+};
+
+void turbulence(Tuple const* points, float* values, int count, int octaves, float lacunarity, float gain) {
+    ::octaves(points, values, count, octaves, lacunarity, gain, true);
+};
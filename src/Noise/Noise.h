@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Tuple.h"
+
+//Ken Perlin's improved noise with his reference permutation, roughly in [-1, 1] and 0 at integer
+//lattice points. The permutation is 512 int32 (2KB) so the lookups stay in L1.
+float perlin(float x, float y, float z);
+float perlin(Tuple const &point);
+
+//perlin() of `count` points given as separate x, y and z arrays. Runs 8 points per pass with AVX2
+//when the CPU has it, one point at a time otherwise. The values match perlin() exactly.
+void perlin(float const* x, float const* y, float const* z, float* values, int count);
+
+//sum of `octaves` layers of noise, each `lacunarity` times the frequency and `gain` times the
+//amplitude of the one before
+float fbm(Tuple const &point, int octaves, float lacunarity = 2.0f, float gain = 0.5f);
+void fbm(Tuple const* points, float* values, int count, int octaves, float lacunarity = 2.0f, float gain = 0.5f);
+
+//fbm() of the absolute noise, in [0, ~1]
+float turbulence(Tuple const &point, int octaves, float lacunarity = 2.0f, float gain = 0.5f);
+void turbulence(Tuple const* points, float* values, int count, int octaves, float lacunarity = 2.0f, float gain = 0.5f);
+
+//false forces the scalar path, for tests and comparisons
+void enableNoiseAVX2(bool enabled);
+bool usingNoiseAVX2();
@@ -0,0 +1,141 @@
+#include "CSG.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <typeinfo>
+
+#include "Ray.h"
+#include "Stats.h"
+
+CSG::CSG(CSGOperation operation, Object &left, Object &right) : operation(operation), left(&left), right(&right) {
+    left.parent = this;
+    right.parent = this;
+    update();
+};
+
+bool CSG::allowed(CSGOperation operation, bool leftHit, bool inLeft, bool inRight) {
+    switch (operation) {
+        case CSGOperation::Union:
+            return (leftHit && !inRight) || (!leftHit && !inLeft);
+        case CSGOperation::Intersection:
+            return (leftHit && inRight) || (!leftHit && inLeft);
+        default:
+            return (leftHit && !inRight) || (!leftHit && inLeft);
+    }
+};
+
+void CSG::filter(std::vector<Intersection> &intersections, std::vector<Intersection>::size_type first) const {
+    bool inLeft = false;
+    bool inRight = false;
+
+    //compacts the kept intersections to the front of the range, no second list
+    std::vector<Intersection>::size_type kept = first;
+    for (std::vector<Intersection>::size_type i = first; i < intersections.size(); i++) {
+        bool leftHit = includes(left, intersections[i].object);
+        if (allowed(operation, leftHit, inLeft, inRight)) {
+            intersections[kept++] = intersections[i];
+        }
+        if (leftHit) {
+            inLeft = !inLeft;
+        } else {
+            inRight = !inRight;
+        }
+    }
+    intersections.resize(kept);
+};
+
+void CSG::combine(std::vector<Intersection> &intersections, std::vector<Intersection>::size_type first) const {
+    std::sort(intersections.begin() + first, intersections.end(), [](Intersection const &a, Intersection const &b) {
+        return a.t < b.t;
+    });
+    filter(intersections, first);
+};
+
+void CSG::update() {
+    Object* children[2] = {left, right};
+    for (int i = 0; i < 2; i++) {
+        childInverse[i] = inverse(children[i]->transform);
+        Bounds box = children[i]->worldBounds();
+        if (!box.empty() && box.finite()) {
+            box.min = box.min - Tuple::Vector(EPSILON, EPSILON, EPSILON);
+            box.max = box.max + Tuple::Vector(EPSILON, EPSILON, EPSILON);
+        }
+        childBounds[i] = box;
+    }
+};
+
+void CSG::childChanged() {
+    update();
+};
+
+void CSG::intersectChild(int child, Ray const &ray, std::vector<Intersection> &intersections) {
+    //unbounded children are always tested, their slabs could come out NaN
+    float tmin, tmax;
+    if (childBounds[child].finite() && !slabIntersect(childBounds[child], ray, tmin, tmax)) {
+        return;
+    }
+    Object* object = child == 0 ? left : right;
+    STATS_COUNT(IntersectionTests);
+    Ray local = transformRay(ray, childInverse[child]);
+    if (typeid(*object) == typeid(CSG)) {
+        static_cast<CSG*>(object)->intersect(local, intersections);
+        return;
+    }
+    for (Intersection const &intersection : object->localIntersects(local)) {
+        intersections.push_back(intersection);
+    }
+};
+
+void CSG::intersect(Ray const &ray, std::vector<Intersection> &intersections) {
+    std::vector<Intersection>::size_type first = intersections.size();
+    intersectChild(0, ray, intersections);
+    if (intersections.size() == first && operation != CSGOperation::Union) {
+        //nothing is left of an intersection or difference where the left child is missed
+        return;
+    }
+    intersectChild(1, ray, intersections);
+    combine(intersections, first);
+};
+
+std::vector<Intersection> CSG::localIntersects(Ray const &ray) {
+    std::vector<Intersection> intersections;
+    intersect(ray, intersections);
+    return intersections;
+};
+
+Tuple CSG::localNormalAt(Tuple const &localPoint) {
+    throw std::logic_error("a CSG has no surface of its own, its children provide the normals");
+};
+
+Bounds CSG::bounds() const {
+    Bounds box = left->worldBounds();
+    if (operation == CSGOperation::Union) {
+        box.add(right->worldBounds());
+    }
+    return box;
+};
+
+
+//Out of class
+
+CSGOperation csgOperationFromName(std::string const &name) {
+    if (name == "union") {
+        return CSGOperation::Union;
+    }
+    if (name == "intersection") {
+        return CSGOperation::Intersection;
+    }
+    if (name == "difference") {
+        return CSGOperation::Difference;
+    }
+    throw std::invalid_argument("unknown CSG operation '" + name + "'");
+};
+
+bool includes(Object const* group, Object const* object) {
+    for (; object != nullptr; object = object->parent) {
+        if (object == group) {
+            return true;
+        }
+    }
+    return false;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Object.h"
+#include "Intersection.h"
+
+enum class CSGOperation {
+    Union,
+    Intersection,
+    Difference      //left minus right
+};
+
+//"union", "intersection" or "difference"
+CSGOperation csgOperationFromName(std::string const &name);
+
+//Union, intersection or difference of two objects. The children become part of the node: their
+//transforms are relative to it and intersections report the child that was hit, so normals and
+//materials come from the children. Each child is skipped when the ray misses its bounds.
+class CSG : public Object {
+public:
+    CSGOperation operation;
+    Object* left;
+    Object* right;
+
+    CSG(CSGOperation operation, Object &left, Object &right);
+
+    //whether a hit on the left child (or right, when `leftHit` is false) is on the surface of the
+    //result, given whether the ray is inside each child at that point
+    static bool allowed(CSGOperation operation, bool leftHit, bool inLeft, bool inRight);
+
+    //keeps the intersections from `first` on, sorted by t, that are on the surface of the result, in place
+    void filter(std::vector<Intersection> &intersections, std::vector<Intersection>::size_type first = 0) const;
+
+    //sorts the children's intersections from `first` on by t, then filters them
+    void combine(std::vector<Intersection> &intersections, std::vector<Intersection>::size_type first) const;
+
+    //appends the intersections on the surface of the result to `intersections`. A CSG child appends
+    //to the same vector, so a tree of nodes fills one caller-owned vector
+    void intersect(Ray const &ray, std::vector<Intersection> &intersections);
+
+    //recomputes the cached child bounds and inverse transforms. setTransformation on any
+    //descendant does so through childChanged()
+    void update();
+    void childChanged() override;
+
+    std::vector<Intersection> localIntersects(Ray const &ray) override;
+    Tuple localNormalAt(Tuple const &localPoint) override;
+    Bounds bounds() const override;
+
+private:
+    Bounds childBounds[2];      //in the node's space, padded so flat children keep some volume
+    Matrix childInverse[2];
+
+    void intersectChild(int child, Ray const &ray, std::vector<Intersection> &intersections);
+};
+
+//whether `object` is `group` or one of its descendants
+bool includes(Object const* group, Object const* object);
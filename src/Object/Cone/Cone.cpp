@@ -0,0 +1,102 @@
+#include "Cone.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "Ray.h"
+
+const int Cone::maxHits;
+
+Cone::Cone() :
+    minimum(-std::numeric_limits<float>::infinity()), maximum(std::numeric_limits<float>::infinity()), closed(false) {};
+
+//the cap at height y has radius |y|
+static bool withinCap(Ray const &ray, float t, float y) {
+    float x = ray.origin.x + t*ray.direction.x;
+    float z = ray.origin.z + t*ray.direction.z;
+    return (x*x + z*z) <= y*y + EPSILON;
+};
+
+int Cone::hits(Ray const &ray, float t[maxHits]) const {
+    int count = 0;
+    Tuple const &o = ray.origin;
+    Tuple const &d = ray.direction;
+
+    float a = d.x*d.x - d.y*d.y + d.z*d.z;
+    float b = 2*o.x*d.x - 2*o.y*d.y + 2*o.z*d.z;
+    float c = o.x*o.x - o.y*o.y + o.z*o.z;
+
+    if (std::fabs(a) > EPSILON) {
+        //a ray through the apex grazes the surface, rounding can take its discriminant just below 0
+        float det = b*b - 4*a*c;
+        if (det >= -EPSILON) {
+            det = std::max(det, 0.0f);
+            float t0 = (-b - std::sqrt(det)) / (2*a);
+            float t1 = (-b + std::sqrt(det)) / (2*a);
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            float y0 = o.y + t0*d.y;
+            if (minimum < y0 && y0 < maximum) {
+                t[count++] = t0;
+            }
+            float y1 = o.y + t1*d.y;
+            if (minimum < y1 && y1 < maximum) {
+                t[count++] = t1;
+            }
+        }
+    } else if (std::fabs(b) > EPSILON) {
+        //parallel to one of the halves, the ray crosses the other once
+        float t0 = -c / (2*b);
+        float y0 = o.y + t0*d.y;
+        if (minimum < y0 && y0 < maximum) {
+            t[count++] = t0;
+        }
+    }
+
+    if (closed && std::fabs(d.y) > EPSILON) {
+        float tLow = (minimum - o.y) / d.y;
+        if (withinCap(ray, tLow, minimum)) {
+            t[count++] = tLow;
+        }
+        float tHigh = (maximum - o.y) / d.y;
+        if (withinCap(ray, tHigh, maximum)) {
+            t[count++] = tHigh;
+        }
+    }
+    return count;
+};
+
+Tuple Cone::normal(Tuple const &localPoint) const {
+    float distance = localPoint.x*localPoint.x + localPoint.z*localPoint.z;
+    if (distance < maximum*maximum && localPoint.y >= maximum - EPSILON) {
+        return Tuple::Vector(0.0f, 1.0f, 0.0f);
+    }
+    if (distance < minimum*minimum && localPoint.y <= minimum + EPSILON) {
+        return Tuple::Vector(0.0f, -1.0f, 0.0f);
+    }
+    float y = std::sqrt(distance);
+    return Tuple::Vector(localPoint.x, localPoint.y > 0 ? -y : y, localPoint.z);
+};
+
+std::vector<Intersection> Cone::localIntersects(Ray const &ray) {
+    float t[maxHits];
+    int count = hits(ray, t);
+
+    std::vector<Intersection> intersections;
+    for (int i = 0; i < count; i++) {
+        intersections.push_back(Intersection(*this, t[i]));
+    }
+    return intersections;
+};
+
+Tuple Cone::localNormalAt(Tuple const &localPoint) {
+    return normal(localPoint);
+};
+
+Bounds Cone::bounds() const {
+    float radius = std::max(std::fabs(minimum), std::fabs(maximum));
+    return {Tuple::Point(-radius, minimum, -radius), Tuple::Point(radius, maximum, radius)};
+};
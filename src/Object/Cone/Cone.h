@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+
+#include "Object.h"
+#include "Intersection.h"
+
+//Double cone x² + z² = y² around the y axis, cut to (minimum, maximum), with end caps when closed
+class Cone : public Object {
+public:
+    static const int maxHits = 4;
+
+    float minimum;
+    float maximum;
+    bool closed;
+
+    Cone();
+
+    //writes the t of every hit to `t`, walls then caps, and returns how many there are
+    int hits(Ray const &ray, float t[maxHits]) const;
+    Tuple normal(Tuple const &localPoint) const;
+
+    std::vector<Intersection> localIntersects(Ray const &ray) override;
+    Tuple localNormalAt(Tuple const &localPoint) override;
+    Bounds bounds() const override;
+};
@@ -1,24 +1,18 @@
 #include "Cube.h"
 
 #include <vector>
-#include <limits>
-#include <algorithm>
+#include <cmath>
 
 #include "Intersection.h"
 #include "Ray.h"
 
+static const Bounds unitCube(Tuple::Point(-1.0f, -1.0f, -1.0f), Tuple::Point(1.0f, 1.0f, 1.0f));
 
 std::vector<Intersection> Cube::localIntersects(Ray const &ray) {
-    float* x = check_axis(ray.origin.x, ray.direction.x);
-    float* y = check_axis(ray.origin.y, ray.direction.y);
-    float* z = check_axis(ray.origin.z, ray.direction.z);
-
-    float tmin = std::max({x[0], y[0], z[0]}); //TODO: book says it should be max? 
-    float tmax = std::min({x[1], y[1], z[1]});
-
     std::vector<Intersection> intersections;
 
-    if (tmin<tmax){
+    float tmin, tmax;
+    if (slabIntersect(unitCube, ray, tmin, tmax)) {
         Intersection int1(*this, tmin);
         intersections.push_back(int1);
 
@@ -30,44 +24,27 @@ std::vector<Intersection> Cube::localIntersects(Ray const &ray) {
 }
 
 Tuple Cube::localNormalAt(Tuple const &localPoint) {
-    if (localPoint.x == 1.0f || localPoint.x == -1.0f) {
-        return Tuple::Vector(localPoint.x, 0.0f, 0.0f);
-    }
-    if (localPoint.y == 1.0f || localPoint.y == -1.0f) {
-        return Tuple::Vector(0.0f, localPoint.y, 0.0f);
-    }
-    return Tuple::Vector(0.0f, 0.0f, localPoint.z);
+    return cubeNormal(localPoint);
 }
 
+Bounds Cube::bounds() const {
+    return unitCube;
+};
 
-float* check_axis(float origin, float direction) {
-    float tmin_num = (-1 - origin);
-    float tmax_num = 1 - origin;
 
-    float tmin, tmax; 
+//Out of class
 
-    float absDir = direction;
-    if(absDir < 0) {
-        absDir *= -1;
-    }
-    if (absDir > EPSILON) {
-        tmin = tmin_num / direction;
-        tmax = tmax_num / direction;    
-    } 
-    else {
-        tmin = tmin_num * std::numeric_limits<float>::infinity();
-        tmax = tmax_num * std::numeric_limits<float>::infinity();
-    }
+Tuple cubeNormal(Tuple const &localPoint) {
+    //hits found through the reciprocal direction can land an ulp inside a face, so no exact == 1 tests
+    float x = std::fabs(localPoint.x);
+    float y = std::fabs(localPoint.y);
+    float z = std::fabs(localPoint.z);
 
-    if (tmin > tmax) {
-        float tmp = tmin;
-        tmin = tmax; 
-        tmax = tmp;
+    if (x >= y && x >= z) {
+        return Tuple::Vector(localPoint.x, 0.0f, 0.0f);
     }
-
-    float* result = new float[2];
-    result[0] = tmin;
-    result[1] = tmax;
-
-    return result;
-}
\ No newline at end of file
+    if (y >= z) {
+        return Tuple::Vector(0.0f, localPoint.y, 0.0f);
+    }
+    return Tuple::Vector(0.0f, 0.0f, localPoint.z);
+};
@@ -6,6 +6,8 @@ class Cube : public Object {
 public: 
     Tuple localNormalAt(Tuple const &localPoint) override;
     std::vector<Intersection> localIntersects(Ray const &ray) override;
+    Bounds bounds() const override;
 };
 
-float* check_axis(float origin, float direction);
\ No newline at end of file
+//normal of the face a point on the unit cube lies on, the largest component picks the face
+Tuple cubeNormal(Tuple const &localPoint);
@@ -0,0 +1,94 @@
+#include "Cylinder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "Ray.h"
+
+const int Cylinder::maxHits;
+
+Cylinder::Cylinder() :
+    minimum(-std::numeric_limits<float>::infinity()), maximum(std::numeric_limits<float>::infinity()), closed(false) {};
+
+//whether the point at `t` lies within radius 1 of the axis, rays through the rim count as hits
+static bool withinCap(Ray const &ray, float t) {
+    float x = ray.origin.x + t*ray.direction.x;
+    float z = ray.origin.z + t*ray.direction.z;
+    return (x*x + z*z) <= 1.0f + EPSILON;
+};
+
+int Cylinder::hits(Ray const &ray, float t[maxHits]) const {
+    int count = 0;
+    Tuple const &o = ray.origin;
+    Tuple const &d = ray.direction;
+
+    //rays parallel to the axis only meet the caps
+    float a = d.x*d.x + d.z*d.z;
+    if (std::fabs(a) > EPSILON) {
+        float b = 2*o.x*d.x + 2*o.z*d.z;
+        float c = o.x*o.x + o.z*o.z - 1.0f;
+        float det = b*b - 4*a*c;
+        if (det < -EPSILON) {
+            return 0;
+        }
+        //grazing rays round to either side of 0
+        det = std::max(det, 0.0f);
+        float t0 = (-b - std::sqrt(det)) / (2*a);
+        float t1 = (-b + std::sqrt(det)) / (2*a);
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        float y0 = o.y + t0*d.y;
+        if (minimum < y0 && y0 < maximum) {
+            t[count++] = t0;
+        }
+        float y1 = o.y + t1*d.y;
+        if (minimum < y1 && y1 < maximum) {
+            t[count++] = t1;
+        }
+    }
+
+    if (closed && std::fabs(d.y) > EPSILON) {
+        float tLow = (minimum - o.y) / d.y;
+        if (withinCap(ray, tLow)) {
+            t[count++] = tLow;
+        }
+        float tHigh = (maximum - o.y) / d.y;
+        if (withinCap(ray, tHigh)) {
+            t[count++] = tHigh;
+        }
+    }
+    return count;
+};
+
+Tuple Cylinder::normal(Tuple const &localPoint) const {
+    float distance = localPoint.x*localPoint.x + localPoint.z*localPoint.z;
+    if (distance < 1.0f && localPoint.y >= maximum - EPSILON) {
+        return Tuple::Vector(0.0f, 1.0f, 0.0f);
+    }
+    if (distance < 1.0f && localPoint.y <= minimum + EPSILON) {
+        return Tuple::Vector(0.0f, -1.0f, 0.0f);
+    }
+    return Tuple::Vector(localPoint.x, 0.0f, localPoint.z);
+};
+
+std::vector<Intersection> Cylinder::localIntersects(Ray const &ray) {
+    float t[maxHits];
+    int count = hits(ray, t);
+
+    std::vector<Intersection> intersections;
+    for (int i = 0; i < count; i++) {
+        intersections.push_back(Intersection(*this, t[i]));
+    }
+    return intersections;
+};
+
+Tuple Cylinder::localNormalAt(Tuple const &localPoint) {
+    return normal(localPoint);
+};
+
+Bounds Cylinder::bounds() const {
+    return {Tuple::Point(-1.0f, minimum, -1.0f), Tuple::Point(1.0f, maximum, 1.0f)};
+};
@@ -0,0 +1,38 @@
+#include "Disk.h"
+
+#include <cmath>
+
+#include "Ray.h"
+
+const int Disk::maxHits;
+
+int Disk::hits(Ray const &ray, float t[maxHits]) const {
+    if (std::fabs(ray.direction.y) <= EPSILON) {
+        return 0;
+    }
+    float hit = -ray.origin.y / ray.direction.y;
+    float x = ray.origin.x + hit*ray.direction.x;
+    float z = ray.origin.z + hit*ray.direction.z;
+    if (x*x + z*z > 1.0f) {
+        return 0;
+    }
+    t[0] = hit;
+    return 1;
+};
+
+std::vector<Intersection> Disk::localIntersects(Ray const &ray) {
+    std::vector<Intersection> intersections;
+    float t[maxHits];
+    if (hits(ray, t) > 0) {
+        intersections.push_back(Intersection(*this, t[0]));
+    }
+    return intersections;
+};
+
+Tuple Disk::localNormalAt(Tuple const &localPoint) {
+    return Tuple::Vector(0.0f, 1.0f, 0.0f);
+};
+
+Bounds Disk::bounds() const {
+    return {Tuple::Point(-1.0f, 0.0f, -1.0f), Tuple::Point(1.0f, 0.0f, 1.0f)};
+};
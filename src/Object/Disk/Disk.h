@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+
+#include "Object.h"
+#include "Intersection.h"
+
+//Radius 1 disk in the xz plane, facing +y
+class Disk : public Object {
+public:
+    static const int maxHits = 1;
+
+    //writes the t of the hit to `t` and returns 1, or returns 0 for a miss
+    int hits(Ray const &ray, float t[maxHits]) const;
+
+    std::vector<Intersection> localIntersects(Ray const &ray) override;
+    Tuple localNormalAt(Tuple const &localPoint) override;
+    Bounds bounds() const override;
+};
@@ -1,5 +1,6 @@
 #include "Object.h"
 #include "Ray.h"
+#include "Stats.h"
 
 int Object::currentId = 0;
 
@@ -9,6 +10,7 @@ Object::Object(){
 
     transform = Matrix::Identity(4);
     material = Material();
+    parent = nullptr;
 }
 
 bool Object::operator==(Object const& other){
@@ -21,25 +23,52 @@ void Object::operator=(Object const& other) {
 
 void Object::setTransformation(Matrix const &newTransform) {
     transform = newTransform;
+    //nearest first, so each node sees its children already updated
+    for (Object* ancestor = parent; ancestor != nullptr; ancestor = ancestor->parent) {
+        ancestor->childChanged();
+    }
 };
 
 std::vector<Intersection> Object::intersects(Ray const &ray) {
+    STATS_COUNT(IntersectionTests);
     Ray localRay = transformRay(ray, inverse(transform));
     return localIntersects(localRay);
 };
 
 Tuple Object::normalAt(Tuple const &point) {
-    Tuple localPoint = inverse(transform) * point;
+    Tuple localPoint = worldToObject(point);
     Tuple localNormal = this->localNormalAt(localPoint);
-    Tuple worldNormal = transpose(inverse(transform)) * localNormal;
-    worldNormal.w = 0;
-
-    return normalize(worldNormal);
+    return normalToWorld(localNormal);
 };  
 
+Tuple Object::worldToObject(Tuple const &point) const {
+    Tuple parentPoint = parent == nullptr ? point : parent->worldToObject(point);
+    return inverse(transform) * parentPoint;
+};
+
+Tuple Object::normalToWorld(Tuple const &localNormal) const {
+    Tuple normal = transpose(inverse(transform)) * localNormal;
+    normal.w = 0;
+    normal = normalize(normal);
+
+    return parent == nullptr ? normal : parent->normalToWorld(normal);
+};
+
 Color Object::colorAt(Tuple const &point) const {
-    Tuple pointObjectSpace = inverse(transform) * point;
+    STATS_COUNT(PatternEvaluations);
+    Tuple pointObjectSpace = worldToObject(point);
     Tuple pointPatternSpace = inverse(material.pattern->transform) * pointObjectSpace;
 
     return material.pattern->colorAt(pointPatternSpace);
-};
\ No newline at end of file
+};
+
+Bounds Object::bounds() const {
+    return Bounds::Infinite();
+};
+
+Bounds Object::worldBounds() const {
+    return bounds().transform(transform);
+};
+
+void Object::childChanged() {
+};
@@ -5,6 +5,7 @@
 #include "Matrix.h"
 #include "Material.h"
 #include "Color.h"
+#include "Bounds.h"
 
 class Intersection;
 class Ray;
@@ -16,6 +17,7 @@ public:
 
     Matrix transform;
     Material material;
+    Object* parent;     //the CSG the object is part of, nullptr for objects directly in a world
     
     Object();
 
@@ -23,12 +25,24 @@ public:
     bool operator==(Object const& other);
     void operator=(Object const& other); //copy constructor
 
+    //also tells every ancestor, whose caches of the children go stale
     void setTransformation(Matrix const &transform);
     std::vector<Intersection> intersects(Ray const &ray);
     Tuple normalAt(Tuple const &point);  
 
     Color colorAt(Tuple const &point) const;
 
+    //through the transforms of the parents first, then the object's own
+    Tuple worldToObject(Tuple const &point) const;
+    Tuple normalToWorld(Tuple const &localNormal) const;
+
+    //box around the shape in object space, infinite unless a shape says otherwise
+    virtual Bounds bounds() const;
+    Bounds worldBounds() const;
+
+    //called when the transform of a descendant changes, nothing to do unless the object caches it
+    virtual void childChanged();
+
     //virtual methods
     virtual std::vector<Intersection> localIntersects(Ray const &ray) = 0;
     virtual Tuple localNormalAt(Tuple const &point) = 0;
@@ -1,6 +1,7 @@
 #include "Plane.h"
 
 #include <cmath>
+#include <limits>
 
 #include "Ray.h"
 #include "Intersection.h"
@@ -20,3 +21,7 @@ Tuple Plane::localNormalAt(Tuple const &point) {
     return Tuple::Vector(0.0f, 1.0f, 0.0f);
 }; 
 
+Bounds Plane::bounds() const {
+    float infinity = std::numeric_limits<float>::infinity();
+    return {Tuple::Point(-infinity, 0.0f, -infinity), Tuple::Point(infinity, 0.0f, infinity)};
+};
@@ -12,4 +12,5 @@ public:
     
     std::vector<Intersection> localIntersects(Ray const &ray) override;
     Tuple localNormalAt(Tuple const &point) override; 
+    Bounds bounds() const override;
 };
\ No newline at end of file
@@ -34,6 +34,10 @@ std::vector<Intersection> Sphere::localIntersects(Ray const &ray) {
     return intersections;
 };
 
+Bounds Sphere::bounds() const {
+    return {Tuple::Point(-1.0f, -1.0f, -1.0f), Tuple::Point(1.0f, 1.0f, 1.0f)};
+};
+
 Sphere Sphere::GlassSphere() {
     Sphere sphere;
 
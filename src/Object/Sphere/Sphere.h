@@ -12,6 +12,7 @@ class Sphere : public Object {
 public: 
     Tuple localNormalAt(Tuple const &localPoint) override;
     std::vector<Intersection> localIntersects(Ray const &ray) override;
+    Bounds bounds() const override;
 
     static Sphere GlassSphere();
 };
\ No newline at end of file
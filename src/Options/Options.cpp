@@ -0,0 +1,223 @@
+#include "Options.h"
+
+#include <stdexcept>
+
+Options::Options() : format(ImageFormat::PPM), width(0), height(0), textureMemory(TextureCache::defaultBudget), mapped(false), quiet(false), help(false) {};
+
+
+//Out of class
+
+static int parseInt(std::string const &flag, std::string const &value, int min) {
+    std::size_t end = 0;
+    int result;
+    try {
+        result = std::stoi(value, &end);
+    } catch (std::exception const &) {
+        end = 0;
+    }
+    if (end != value.size() || value.empty()) {
+        throw std::invalid_argument(flag + " expects an integer, got '" + value + "'");
+    }
+    if (result < min) {
+        throw std::invalid_argument(flag + " must be at least " + std::to_string(min));
+    }
+    return result;
+};
+
+static float parseFloat(std::string const &flag, std::string const &value) {
+    std::size_t end = 0;
+    float result = 0.0f;
+    try {
+        result = std::stof(value, &end);
+    } catch (std::exception const &) {
+        end = 0;
+    }
+    if (end != value.size() || value.empty()) {
+        throw std::invalid_argument(flag + " expects a number, got '" + value + "'");
+    }
+    return result;
+};
+
+//"a,b,c" -> {a, b, c}
+static std::vector<int> parseIntList(std::string const &flag, std::string const &value, std::vector<int>::size_type count) {
+    std::vector<int> result;
+    std::string::size_type start = 0;
+    while (true) {
+        std::string::size_type comma = value.find(',', start);
+        result.push_back(parseInt(flag, value.substr(start, comma - start), 0));
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    if (result.size() != count) {
+        throw std::invalid_argument(flag + " expects " + std::to_string(count) + " comma separated integers, got '" + value + "'");
+    }
+    return result;
+};
+
+Options parseOptions(int argc, char const* const* argv) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument(arg + " expects a value");
+            }
+            return argv[++i];
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            options.help = true;
+        } else if (arg == "-q" || arg == "--quiet") {
+            options.quiet = true;
+        } else if (arg == "--width") {
+            options.width = parseInt(arg, value(), 1);
+        } else if (arg == "--height") {
+            options.height = parseInt(arg, value(), 1);
+        } else if (arg == "-t" || arg == "--threads") {
+            options.render.threads = parseInt(arg, value(), 0);
+        } else if (arg == "-s" || arg == "--samples") {
+            options.render.samples = parseInt(arg, value(), 1);
+        } else if (arg == "-b" || arg == "--bounces") {
+            options.render.maxBounces = parseInt(arg, value(), 0);
+        } else if (arg == "--specular") {
+            options.render.specular = powModeFromName(value());
+        } else if (arg == "--accel") {
+            options.render.acceleration = accelerationFromName(value());
+        } else if (arg == "--tile") {
+            //whole 8x8 blocks of the tiled canvas, so no two threads write to the same cache line
+            int tile = parseInt(arg, value(), 1);
+            options.render.tileSize = (tile + Canvas::tileEdge - 1) / Canvas::tileEdge * Canvas::tileEdge;
+        } else if (arg == "-f" || arg == "--format") {
+            options.format = imageFormatFromName(value());
+        } else if (arg == "-o" || arg == "--output") {
+            options.outputPath = value();
+        } else if (arg == "--crop") {
+            std::vector<int> crop = parseIntList(arg, value(), 4);
+            options.render.regions.push_back(RenderRegion(crop[0], crop[1], crop[2], crop[3]));
+        } else if (arg == "--merge") {
+            std::string piece = value();
+            std::string::size_type at = piece.rfind('@');
+            if (at == std::string::npos) {
+                throw std::invalid_argument("--merge expects <image>@<x>,<y>, got '" + piece + "'");
+            }
+            std::vector<int> position = parseIntList(arg, piece.substr(at + 1), 2);
+            options.merge.push_back({piece.substr(0, at), position[0], position[1]});
+        } else if (arg == "--grade") {
+            options.gradePath = value();
+        } else if (arg == "--tonemap") {
+            options.toneMap.op = toneMapOperatorFromName(value());
+        } else if (arg == "--exposure") {
+            options.toneMap.exposure = parseFloat(arg, value());
+        } else if (arg == "--gamma") {
+            options.toneMap.gamma = parseFloat(arg, value());
+            if (!(options.toneMap.gamma > 0.0f)) {
+                throw std::invalid_argument("--gamma must be positive");
+            }
+        } else if (arg == "--workers") {
+            options.farm.workers = parseInt(arg, value(), 0);
+        } else if (arg == "--listen") {
+            options.farm.socketPath = value();
+        } else if (arg == "--tile-timeout") {
+            options.farm.tileTimeout = parseInt(arg, value(), 1) * 1000;
+        } else if (arg == "--connect") {
+            options.connectPath = value();
+        } else if (arg == "--checkpoint") {
+            options.render.checkpointPath = value();
+        } else if (arg == "--resume") {
+            options.render.resume = true;
+        } else if (arg == "--mmap") {
+            options.mapped = true;
+        } else if (arg == "--texture-memory") {
+            options.textureMemory = (std::size_t)parseInt(arg, value(), 1) << 20;
+        } else if (arg == "--trace") {
+            options.tracePath = value();
+        } else if (arg == "--stats") {
+            options.stats = value();
+            if (options.stats != "table" && options.stats != "json") {
+                throw std::invalid_argument("--stats expects table or json, got '" + options.stats + "'");
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::invalid_argument("unknown option " + arg);
+        } else if (options.scenePath.empty()) {
+            options.scenePath = arg;
+        } else {
+            throw std::invalid_argument("more than one scene given: " + arg);
+        }
+    }
+
+    if (options.render.resume && options.render.checkpointPath.empty()) {
+        throw std::invalid_argument("--resume needs a --checkpoint file");
+    }
+
+    if (options.mapped && options.format != ImageFormat::PPMBinary && options.format != ImageFormat::PFM) {
+        throw std::invalid_argument("--mmap needs --format ppm-binary or pfm");
+    }
+    if (options.mapped && options.format != ImageFormat::PFM && !options.toneMap.identity()) {
+        throw std::invalid_argument("tone mapping needs the image in memory, render to pfm with --mmap and --grade it");
+    }
+    if (!options.render.checkpointPath.empty() && (options.farm.workers > 0 || !options.farm.socketPath.empty())) {
+        throw std::invalid_argument("--checkpoint cannot be combined with render workers");
+    }
+    if (options.mapped && (options.farm.workers > 0 || !options.farm.socketPath.empty())) {
+        throw std::invalid_argument("--mmap cannot be combined with render workers");
+    }
+
+    if (options.outputPath.empty()) {
+        options.outputPath = "render" + imageFormatExtension(options.format);
+    }
+
+    return options;
+};
+
+std::string usage(std::string const &program) {
+    return "usage: " + program + " [options] [scene]\n"
+        "       " + program + " --width <px> --height <px> -o <image> --merge <image>@<x>,<y> ...\n"
+        "       " + program + " --connect <socket> [scene]\n"
+        "       " + program + " --grade <image> [tone mapping options] -o <image>\n"
+        "\n"
+        "Renders `scene` (or the built-in demo scene) and prints a timing summary.\n"
+        "The second form assembles images rendered with --crop into one frame.\n"
+        "The third form renders tiles for a coordinator started with --listen.\n"
+        "The fourth form re-grades a PFM render without rendering it again.\n"
+        "\n"
+        "  --width <px>, --height <px>  override the scene camera resolution\n"
+        "  -t, --threads <n>            render threads, 0 = one per core (default 0)\n"
+        "  -s, --samples <n>            samples per pixel (default 1)\n"
+        "  -b, --bounces <n>            max reflection/refraction depth (default 3)\n"
+        "  --tile <px>                  tile edge handed to each thread, rounded up to a multiple\n"
+        "                               of 8 (default 32)\n"
+        "  --specular <mode>            exact | integer | table | approx highlights, the last two\n"
+        "                               trade accuracy for speed on previews (default exact)\n"
+        "  --accel <mode>               bvh | grid | none, grid suits many objects of similar\n"
+        "                               size, none tests every object against every ray (default bvh)\n"
+        "  --crop <x>,<y>,<w>,<h>       render only this rectangle, repeat for a bucket list;\n"
+        "                               the image covers the bounding box of the rectangles.\n"
+        "                               Keep the x and y of several rectangles multiples of 8\n"
+        "                               apart, or threads share cache lines of the frame\n"
+        "  --merge <image>@<x>,<y>      paste a PPM or PFM image into the frame, repeatable\n"
+        "  --workers <n>                fork n worker processes that render tiles for this one\n"
+        "  --listen <socket>            also take workers connecting on this Unix socket\n"
+        "  --tile-timeout <s>           seconds a worker gets per tile before the tile goes to\n"
+        "                               another one (default 600)\n"
+        "  --checkpoint <path>          save finished tiles to this file while rendering, not with\n"
+        "                               --workers or --listen\n"
+        "  --resume                     skip the tiles already saved in the checkpoint\n"
+        "  -f, --format <name>          ppm | ppm-binary | pfm | png (default ppm)\n"
+        "  --mmap                       render straight into the output file (ppm-binary or pfm),\n"
+        "                               keeping memory bounded for very large images\n"
+        "  --tonemap <name>             none | reinhard | aces (default none)\n"
+        "  --exposure <stops>           scale the radiance by 2^stops before tone mapping\n"
+        "  --gamma <g>                  encode with 1/g after tone mapping (default 1)\n"
+        "                               tone mapping applies to 8-bit outputs, pfm stays linear\n"
+        "  -o, --output <path>          output file (default render.<ext>)\n"
+        "  --texture-memory <MB>        texture tiles kept in memory, the rest is paged from disk\n"
+        "                               (default 256)\n"
+        "  --stats <table|json>         print ray and shading counters after the render\n"
+        "  --trace <path>               write a Chrome/Perfetto trace of the render stages\n"
+        "  -q, --quiet                  no timing summary\n"
+        "  -h, --help                   show this message\n";
+};
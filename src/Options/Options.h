@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Camera.h"
+#include "Canvas.h"
+#include "Farm.h"
+#include "ToneMap.h"
+#include "TextureCache.h"
+
+//image rendered by another process and where it goes in the frame
+class MergePiece {
+public:
+    std::string path;
+    int x, y;
+};
+
+//command line of the RayTracer executable
+class Options {
+public:
+    std::string scenePath;   //empty -> built-in demo scene
+    std::string outputPath;  //empty -> "render" + format extension
+    ImageFormat format;
+    int width;               //0 -> keep the scene camera size
+    int height;
+    RenderSettings render;
+    std::vector<MergePiece> merge;  //non-empty -> assemble these instead of rendering
+    std::string gradePath;          //non-empty -> tone map this image instead of rendering
+    ToneMapSettings toneMap;        //applied to 8-bit outputs, PFM keeps the rendered radiance
+    FarmSettings farm;
+    std::string connectPath;        //non-empty -> serve tiles to the coordinator on this socket
+    std::string tracePath;   //empty -> no trace
+    std::string stats;       //"", "table" or "json"
+    std::size_t textureMemory;      //bytes of texture tiles kept in memory
+    bool mapped;             //render straight into a memory-mapped output file
+    bool quiet;
+    bool help;
+
+    Options();
+};
+
+//throws std::invalid_argument on malformed command lines
+Options parseOptions(int argc, char const* const* argv);
+
+std::string usage(std::string const &program);
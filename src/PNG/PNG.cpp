@@ -0,0 +1,387 @@
+#include "PNG.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Trace.h"
+
+static const std::uint32_t adlerBase = 65521;
+
+std::uint32_t crc32(unsigned char const* data, std::size_t size, std::uint32_t crc) {
+    static const std::vector<std::uint32_t> table = []() {
+        std::vector<std::uint32_t> entries(256);
+        for (std::uint32_t n = 0; n < 256; n++) {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[n] = c;
+        }
+        return entries;
+    }();
+
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+};
+
+std::uint32_t adler32(unsigned char const* data, std::size_t size, std::uint32_t adler) {
+    std::uint32_t a = adler & 0xFFFF;
+    std::uint32_t b = adler >> 16;
+    while (size > 0) {
+        //5552 bytes is the most that can be summed before b overflows 32 bits
+        std::size_t block = size < 5552 ? size : 5552;
+        size -= block;
+        for (std::size_t i = 0; i < block; i++) {
+            a += *data++;
+            b += a;
+        }
+        a %= adlerBase;
+        b %= adlerBase;
+    }
+    return (b << 16) | a;
+};
+
+std::uint32_t adler32Combine(std::uint32_t first, std::uint32_t second, std::size_t secondSize) {
+    std::uint64_t remainder = secondSize % adlerBase;
+    std::uint64_t a = first & 0xFFFF;
+    std::uint64_t b = (remainder * a) % adlerBase;
+    a += (second & 0xFFFF) + adlerBase - 1;
+    b += (first >> 16) + (second >> 16) + adlerBase - remainder;
+    a %= adlerBase;
+    b %= adlerBase;
+    return (std::uint32_t)((b << 16) | a);
+};
+
+
+//Deflate, fixed Huffman codes with a hash chain LZ77 matcher
+
+class BitWriter {
+public:
+    std::vector<unsigned char> &out;
+    std::uint32_t buffer;
+    int count;
+
+    BitWriter(std::vector<unsigned char> &out) : out(out), buffer(0), count(0) {};
+
+    //least significant bit first, as deflate packs everything but Huffman codes
+    void write(std::uint32_t bits, int size) {
+        buffer |= bits << count;
+        count += size;
+        while (count >= 8) {
+            out.push_back(buffer & 0xFF);
+            buffer >>= 8;
+            count -= 8;
+        }
+    };
+
+    //Huffman codes go most significant bit first
+    void writeCode(std::uint32_t code, int size) {
+        std::uint32_t reversed = 0;
+        for (int i = 0; i < size; i++) {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        write(reversed, size);
+    };
+
+    void align() {
+        if (count > 0) {
+            out.push_back(buffer & 0xFF);
+        }
+        buffer = 0;
+        count = 0;
+    };
+};
+
+static const int lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                   35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const int lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const int distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                     257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const int distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                      7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+static void writeSymbol(BitWriter &bits, int symbol) {
+    if (symbol < 144) {
+        bits.writeCode(0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        bits.writeCode(0x190 + symbol - 144, 9);
+    } else if (symbol < 280) {
+        bits.writeCode(symbol - 256, 7);
+    } else {
+        bits.writeCode(0xC0 + symbol - 280, 8);
+    }
+};
+
+static void writeMatch(BitWriter &bits, int length, int distance) {
+    int code = 28;
+    while (lengthBase[code] > length) {
+        code--;
+    }
+    writeSymbol(bits, 257 + code);
+    bits.write(length - lengthBase[code], lengthExtra[code]);
+
+    code = 29;
+    while (distanceBase[code] > distance) {
+        code--;
+    }
+    bits.writeCode(code, 5);
+    bits.write(distance - distanceBase[code], distanceExtra[code]);
+};
+
+//compresses `data` as one fixed Huffman block; unless `last`, the block is followed by an empty
+//stored block (a sync flush) so the output ends on a byte boundary and the next chunk can follow it
+static void deflateChunk(unsigned char const* data, std::size_t size, bool last, std::vector<unsigned char> &out) {
+    const int windowSize = 32768;
+    const int hashBits = 15;
+    const int maxChain = 64;
+    const int minMatch = 3;
+    const int maxMatch = 258;
+
+    BitWriter bits(out);
+    bits.write(last ? 1 : 0, 1);
+    bits.write(1, 2);
+
+    std::vector<int> head(1 << hashBits, -1);
+    std::vector<int> previous(size);
+    auto hash = [&](std::size_t i) {
+        return ((data[i] << 10) ^ (data[i + 1] << 5) ^ data[i + 2]) & ((1 << hashBits) - 1);
+    };
+    auto insert = [&](std::size_t i) {
+        int h = hash(i);
+        previous[i] = head[h];
+        head[h] = (int)i;
+    };
+
+    std::size_t i = 0;
+    while (i + minMatch <= size) {
+        int bestLength = 0;
+        int bestDistance = 0;
+        int limit = (int)std::min<std::size_t>(maxMatch, size - i);
+
+        int candidate = head[hash(i)];
+        for (int chain = 0; candidate >= 0 && (int)i - candidate <= windowSize && chain < maxChain; chain++) {
+            if (data[candidate + bestLength] == data[i + bestLength]) {
+                int length = 0;
+                while (length < limit && data[candidate + length] == data[i + length]) {
+                    length++;
+                }
+                if (length > bestLength) {
+                    bestLength = length;
+                    bestDistance = (int)i - candidate;
+                    if (length == limit) {
+                        break;
+                    }
+                }
+            }
+            candidate = previous[candidate];
+        }
+
+        if (bestLength >= minMatch) {
+            writeMatch(bits, bestLength, bestDistance);
+            for (std::size_t end = i + bestLength; i < end; i++) {
+                if (i + minMatch <= size) {
+                    insert(i);
+                }
+            }
+        } else {
+            writeSymbol(bits, data[i]);
+            insert(i);
+            i++;
+        }
+    }
+    for (; i < size; i++) {
+        writeSymbol(bits, data[i]);
+    }
+    writeSymbol(bits, 256);
+
+    if (!last) {
+        bits.write(0, 3);
+        bits.align();
+        out.push_back(0x00);
+        out.push_back(0x00);
+        out.push_back(0xFF);
+        out.push_back(0xFF);
+    } else {
+        bits.align();
+    }
+};
+
+
+//PNG
+
+static unsigned char toByte(float value) {
+    float scaled = value*255.0f;
+    if (scaled < 0.0f) {
+        return 0;
+    }
+    if (scaled > 255.0f) {
+        return 255;
+    }
+    return (unsigned char)(scaled + 0.5f);
+};
+
+static int paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+};
+
+//writes the filter byte and the filtered row to `out`, picking the filter with the smallest sum of
+//absolute differences, the usual heuristic for true colour images
+static void filterRow(unsigned char const* row, unsigned char const* above, int size, unsigned char* out) {
+    const int bpp = 3;
+    std::vector<unsigned char> candidate(size);
+    long bestCost = -1;
+
+    for (int filter = 0; filter < 5; filter++) {
+        long cost = 0;
+        for (int i = 0; i < size; i++) {
+            int a = i >= bpp ? row[i - bpp] : 0;
+            int b = above != nullptr ? above[i] : 0;
+            int c = i >= bpp && above != nullptr ? above[i - bpp] : 0;
+            int predicted = 0;
+            switch (filter) {
+                case 1: predicted = a; break;
+                case 2: predicted = b; break;
+                case 3: predicted = (a + b) / 2; break;
+                case 4: predicted = paeth(a, b, c); break;
+            }
+            unsigned char value = (unsigned char)(row[i] - predicted);
+            candidate[i] = value;
+            cost += value < 128 ? value : 256 - value;
+        }
+        if (bestCost < 0 || cost < bestCost) {
+            bestCost = cost;
+            out[0] = (unsigned char)filter;
+            std::copy(candidate.begin(), candidate.end(), out + 1);
+        }
+    }
+};
+
+static void writeBigEndian(std::vector<unsigned char> &out, std::uint32_t value) {
+    out.push_back(value >> 24);
+    out.push_back((value >> 16) & 0xFF);
+    out.push_back((value >> 8) & 0xFF);
+    out.push_back(value & 0xFF);
+};
+
+//the chunk type is part of the CRC, the length is not
+static void writeChunk(std::ostream &out, char const* type, std::vector<unsigned char> const &data) {
+    std::vector<unsigned char> header;
+    writeBigEndian(header, (std::uint32_t)data.size());
+    header.insert(header.end(), type, type + 4);
+
+    std::vector<unsigned char> footer;
+    writeBigEndian(footer, crc32(data.data(), data.size(), crc32(header.data() + 4, 4)));
+
+    out.write(reinterpret_cast<char const*>(header.data()), header.size());
+    out.write(reinterpret_cast<char const*>(data.data()), data.size());
+    out.write(reinterpret_cast<char const*>(footer.data()), footer.size());
+};
+
+class PNGPiece {
+public:
+    int firstRow, rows;
+    std::vector<unsigned char> compressed;
+    std::uint32_t adler;
+    std::size_t filteredSize;
+};
+
+void writePNG(std::ostream &out, Canvas const &canvas, int threads) {
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    out.write(reinterpret_cast<char const*>(signature), sizeof(signature));
+
+    std::vector<unsigned char> header;
+    writeBigEndian(header, canvas.width);
+    writeBigEndian(header, canvas.height);
+    header.push_back(8);  //bit depth
+    header.push_back(2);  //true colour
+    header.push_back(0);  //deflate
+    header.push_back(0);  //adaptive filtering
+    header.push_back(0);  //no interlace
+    writeChunk(out, "IHDR", header);
+
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    //a few pieces per thread to even out the load, but not so small that compression suffers
+    int rowSize = canvas.width*3;
+    int rowsPerPiece = std::max(16, (canvas.height + threads*4 - 1) / std::max(1, threads*4));
+    std::vector<PNGPiece> pieces;
+    for (int row = 0; row < canvas.height; row += rowsPerPiece) {
+        pieces.push_back({row, std::min(rowsPerPiece, canvas.height - row), {}, 1, 0});
+    }
+    if (pieces.empty()) {
+        pieces.push_back({0, 0, {}, 1, 0});
+    }
+
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        std::vector<float> linear(rowSize);
+        std::vector<unsigned char> current(rowSize);
+        std::vector<unsigned char> above(rowSize);
+        for (int index = next++; index < (int)pieces.size(); index = next++) {
+            TraceSpan span("deflate", "io");
+            PNGPiece &piece = pieces[index];
+
+            std::vector<unsigned char> filtered((std::size_t)piece.rows*(rowSize + 1));
+            for (int r = 0; r < piece.rows; r++) {
+                int y = piece.firstRow + r;
+                canvas.readRow(y, linear.data());
+                for (int i = 0; i < rowSize; i++) {
+                    current[i] = toByte(linear[i]);
+                }
+                //the row above comes from the canvas, so pieces do not depend on each other
+                if (y > 0 && r == 0) {
+                    canvas.readRow(y - 1, linear.data());
+                    for (int i = 0; i < rowSize; i++) {
+                        above[i] = toByte(linear[i]);
+                    }
+                }
+                filterRow(current.data(), y > 0 ? above.data() : nullptr, rowSize, &filtered[(std::size_t)r*(rowSize + 1)]);
+                std::swap(current, above);
+            }
+
+            piece.filteredSize = filtered.size();
+            piece.adler = adler32(filtered.data(), filtered.size());
+            deflateChunk(filtered.data(), filtered.size(), index + 1 == (int)pieces.size(), piece.compressed);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < std::min(threads, (int)pieces.size()); i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : pool) {
+        thread.join();
+    }
+
+    //zlib header (deflate, 32K window, no preset dictionary), the pieces in order, the combined Adler-32
+    std::vector<unsigned char> zlibHeader = {0x78, 0x01};
+    writeChunk(out, "IDAT", zlibHeader);
+    std::uint32_t adler = 1;
+    for (PNGPiece const &piece : pieces) {
+        writeChunk(out, "IDAT", piece.compressed);
+        adler = adler32Combine(adler, piece.adler, piece.filteredSize);
+    }
+    std::vector<unsigned char> trailer;
+    writeBigEndian(trailer, adler);
+    writeChunk(out, "IDAT", trailer);
+
+    writeChunk(out, "IEND", std::vector<unsigned char>());
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "Canvas.h"
+
+//Self-contained PNG encoder. The filtered scanlines are split into chunks that are deflated on
+//separate threads; every chunk but the last ends with a sync flush so the compressed pieces can be
+//stitched into one zlib stream, and the Adler-32 of the whole is combined from the per chunk sums.
+
+//`threads` 0 -> one per core
+void writePNG(std::ostream &out, Canvas const &canvas, int threads = 0);
+
+//running checksums, pass the previous result to continue one
+std::uint32_t crc32(unsigned char const* data, std::size_t size, std::uint32_t crc = 0);
+std::uint32_t adler32(unsigned char const* data, std::size_t size, std::uint32_t adler = 1);
+
+//Adler-32 of A followed by B, from the sums of A and B and the length of B
+std::uint32_t adler32Combine(std::uint32_t first, std::uint32_t second, std::size_t secondSize);
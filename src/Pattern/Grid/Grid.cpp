@@ -3,9 +3,9 @@
 
 #include "Solid.h"
 
-Grid::Grid(Color a, Color b) {
-    patternA = new Solid(a); 
-    patternB = new Solid(b); 
+Grid::Grid(PatternPool &pool, Color a, Color b) {
+    patternA = &pool.make<Solid>(a);
+    patternB = &pool.make<Solid>(b);
 };
 
 Grid::Grid(Pattern &a, Pattern &b) {
@@ -15,8 +15,8 @@ Grid::Grid(Pattern &a, Pattern &b) {
 
 
 Color Grid::colorAt(Tuple const &point) {
-    Tuple pointPatternSpaceA = inverse(patternA->transform) * point;
-    Tuple pointPatternSpaceB = inverse(patternB->transform) * point;
+    Tuple pointPatternSpaceA = patternA->transform.toPattern(point);
+    Tuple pointPatternSpaceB = patternB->transform.toPattern(point);
 
     return ((int) (floor(point.x) + floor(point.y) + floor(point.z)) % 2) == 0 ? patternA->colorAt(pointPatternSpaceA) : patternB->colorAt(pointPatternSpaceB);
 };
\ No newline at end of file
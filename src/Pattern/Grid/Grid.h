@@ -2,14 +2,17 @@
 
 #include "Pattern.h"
 #include "Color.h"
+#include "PatternPool.h"
 
 class Grid : public Pattern {
 public:
     Pattern* patternA;
     Pattern* patternB;
     
-    Grid(Color a, Color b);
+    //the two colors become Solid children made in `pool`, next to the grid
+    Grid(PatternPool &pool, Color a, Color b);
     Grid(Pattern &a, Pattern &b);
+    Grid(Grid const &other) = delete;
     
     Color colorAt(Tuple const &point) override;
 };
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "ImageTexture.h"
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+ImageTexture::ImageTexture(TextureCache &cache, int texture, UVMapping mapping) :
+    cache(cache), texture(texture), mapping(mapping), lod(0.0f) {};
+
+Color ImageTexture::colorAt(Tuple const &point) {
+    float u = 0.0f, v = 0.0f;
+    switch (mapping) {
+        case UVMapping::Spherical:
+            sphericalMap(point, u, v);
+            break;
+        case UVMapping::Planar:
+            planarMap(point, u, v);
+            break;
+        case UVMapping::Cubic:
+            cubicMap(point, u, v);
+            break;
+    }
+    return sample(u, v, lod);
+};
+
+Color ImageTexture::sample(float u, float v, float lod) {
+    float level = std::min(std::max(lod, 0.0f), (float)(cache.levels(texture) - 1));
+    int fine = (int)level;
+    float blend = level - fine;
+    if (blend == 0.0f) {
+        return bilinear(fine, u, v);
+    }
+    return bilinear(fine, u, v)*(1.0f - blend) + bilinear(fine + 1, u, v)*blend;
+};
+
+Color ImageTexture::bilinear(int level, float u, float v) {
+    //texel centers sit at half-integer coordinates, row 0 is the top of the image
+    float x = u*cache.width(texture, level) - 0.5f;
+    float y = (1.0f - v)*cache.height(texture, level) - 0.5f;
+    float x0 = std::floor(x);
+    float y0 = std::floor(y);
+    float fx = x - x0;
+    float fy = y - y0;
+
+    //a cube face is the whole texture, wrapping would blend in the opposite edge
+    Color texels[4];
+    cache.footprint(texture, level, (int)x0, (int)y0, mapping != UVMapping::Cubic, texels);
+    Color top = texels[0]*(1.0f - fx) + texels[1]*fx;
+    Color bottom = texels[2]*(1.0f - fx) + texels[3]*fx;
+    return top*(1.0f - fy) + bottom*fy;
+};
+
+
+//Out of class
+
+UVMapping uvMappingFromName(std::string const &name) {
+    if (name == "sphere") {
+        return UVMapping::Spherical;
+    }
+    if (name == "plane") {
+        return UVMapping::Planar;
+    }
+    if (name == "cube") {
+        return UVMapping::Cubic;
+    }
+    throw std::invalid_argument("unknown texture mapping: " + name);
+};
+
+void sphericalMap(Tuple const &point, float &u, float &v) {
+    float theta = std::atan2(point.x, point.z);
+    float radius = std::sqrt(point.x*point.x + point.y*point.y + point.z*point.z);
+    float phi = radius > 0.0f ? std::acos(std::min(std::max(point.y / radius, -1.0f), 1.0f)) : 0.0f;
+    u = 1.0f - (theta / (2.0f*(float)M_PI) + 0.5f);
+    v = 1.0f - phi / (float)M_PI;
+};
+
+void planarMap(Tuple const &point, float &u, float &v) {
+    u = point.x - std::floor(point.x);
+    v = point.z - std::floor(point.z);
+};
+
+void cubicMap(Tuple const &point, float &u, float &v) {
+    float ax = std::fabs(point.x), ay = std::fabs(point.y), az = std::fabs(point.z);
+    //each face seen from outside the cube, with +y up on the side faces
+    if (ax >= ay && ax >= az) {
+        u = point.x > 0.0f ? (1.0f - point.z) / 2.0f : (point.z + 1.0f) / 2.0f;
+        v = (point.y + 1.0f) / 2.0f;
+    } else if (ay >= az) {
+        u = (point.x + 1.0f) / 2.0f;
+        v = point.y > 0.0f ? (1.0f - point.z) / 2.0f : (point.z + 1.0f) / 2.0f;
+    } else {
+        u = point.z > 0.0f ? (1.0f - point.x) / 2.0f : (point.x + 1.0f) / 2.0f;
+        v = (point.y + 1.0f) / 2.0f;
+    }
+    u = std::min(std::max(u, 0.0f), 0.9999999f);
+    v = std::min(std::max(v, 0.0f), 0.9999999f);
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Pattern.h"
+#include "Color.h"
+#include "TextureCache.h"
+
+//how points in pattern space become texture coordinates
+enum class UVMapping {
+    Spherical,  //longitude and latitude around the unit sphere
+    Planar,     //x and z, the texture repeats every unit
+    Cubic       //the whole texture on each face of the unit cube
+};
+
+//Image from a TextureCache wrapped around a shape. The renderer has no ray footprint to pick a
+//mip level from, so colorAt samples at `lod`, which is set by hand (the optional last number of
+//`pattern image` in a scene): 0 is full resolution, each step halves it.
+class ImageTexture : public Pattern {
+public:
+    TextureCache &cache;
+    int texture;
+    UVMapping mapping;
+    float lod;
+
+    ImageTexture(TextureCache &cache, int texture, UVMapping mapping);
+
+    Color colorAt(Tuple const &point) override;
+
+    //trilinear: bilinear in the two levels around `lod`, blended. u and v in [0, 1) cover the
+    //texture once with v = 0 at the bottom row, and wrap outside of that. Cubic mapping clamps
+    //to the edges instead, each face being the whole texture.
+    Color sample(float u, float v, float lod);
+
+private:
+    Color bilinear(int level, float u, float v);
+};
+
+UVMapping uvMappingFromName(std::string const &name);
+
+void sphericalMap(Tuple const &point, float &u, float &v);
+
+void planarMap(Tuple const &point, float &u, float &v);
+
+void cubicMap(Tuple const &point, float &u, float &v);
@@ -0,0 +1,51 @@
+#include "NoisePattern.h"
+
+#include <algorithm>
+
+#include "Noise.h"
+
+NoisePattern::NoisePattern(NoiseType type, Color a, Color b, int octaves) :
+    type(type), octaves(octaves), lacunarity(2.0f), gain(0.5f) {
+    colorA = a;
+    colorB = b;
+};
+
+//Perlin and fBm are signed, turbulence is not
+static float normalized(NoiseType type, float noise) {
+    float value = type == NoiseType::Turbulence ? noise : noise*0.5f + 0.5f;
+    return std::min(1.0f, std::max(0.0f, value));
+};
+
+float NoisePattern::value(Tuple const &point) const {
+    switch (type) {
+        case NoiseType::FBM:
+            return normalized(type, fbm(point, octaves, lacunarity, gain));
+        case NoiseType::Turbulence:
+            return normalized(type, turbulence(point, octaves, lacunarity, gain));
+        default:
+            return normalized(type, perlin(point));
+    }
+};
+
+void NoisePattern::values(Tuple const* points, float* values, int count) const {
+    if (type == NoiseType::FBM) {
+        fbm(points, values, count, octaves, lacunarity, gain);
+    } else if (type == NoiseType::Turbulence) {
+        turbulence(points, values, count, octaves, lacunarity, gain);
+    } else {
+        //one octave with unit frequency and amplitude is the noise itself
+        fbm(points, values, count, 1);
+    }
+    for (int i = 0; i < count; i++) {
+        values[i] = normalized(type, values[i]);
+    }
+};
+
+Color NoisePattern::color(float value) const {
+    Color distance = colorB - colorA;
+    return colorA + distance*value;
+};
+
+Color NoisePattern::colorAt(Tuple const &point) {
+    return color(value(point));
+};
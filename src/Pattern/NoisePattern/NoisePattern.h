@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Pattern.h"
+#include "Color.h"
+
+enum class NoiseType {
+    Perlin,
+    FBM,
+    Turbulence
+};
+
+//Blends colorA into colorB by procedural noise: plain Perlin noise, fBm, or turbulence
+class NoisePattern : public Pattern {
+public:
+    NoiseType type;
+    Color colorA;
+    Color colorB;
+    int octaves;        //FBM and Turbulence only
+    float lacunarity;
+    float gain;
+
+    NoisePattern(NoiseType type, Color a, Color b, int octaves = 4);
+
+    //the noise at `point` mapped to [0, 1], 0 is colorA and 1 colorB
+    float value(Tuple const &point) const;
+    void values(Tuple const* points, float* values, int count) const;
+    Color color(float value) const;
+
+    Color colorAt(Tuple const &point) override;
+};
@@ -2,6 +2,48 @@
 
 #include <iostream>
 
-Pattern::Pattern() {
-    transform = Matrix::Identity(4);
-}
+PatternTransform::PatternTransform() {
+    for (int i = 0; i < 16; i++) {
+        values[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+        inverseValues[i] = values[i];
+    }
+};
+
+PatternTransform::PatternTransform(Matrix const &matrix) {
+    Matrix inverted = inverse(matrix);
+    for (int i = 0; i < 16; i++) {
+        values[i] = matrix.array[i];
+        inverseValues[i] = inverted.array[i];
+    }
+};
+
+PatternTransform::operator Matrix() const {
+    Matrix matrix(4);
+    for (int i = 0; i < 16; i++) {
+        matrix.array[i] = values[i];
+    }
+    return matrix;
+};
+
+bool PatternTransform::operator==(Matrix const &other) const {
+    return Matrix(*this) == other;
+};
+
+//same order of operations as Matrix * Tuple
+Tuple PatternTransform::toPattern(Tuple const &point) const {
+    float const* m = inverseValues;
+    return {m[0]*point.x + m[1]*point.y + m[2]*point.z + m[3]*point.w,
+            m[4]*point.x + m[5]*point.y + m[6]*point.z + m[7]*point.w,
+            m[8]*point.x + m[9]*point.y + m[10]*point.z + m[11]*point.w,
+            m[12]*point.x + m[13]*point.y + m[14]*point.z + m[15]*point.w};
+};
+
+Matrix inverse(PatternTransform const &transform) {
+    Matrix matrix(4);
+    for (int i = 0; i < 16; i++) {
+        matrix.array[i] = transform.inverseValues[i];
+    }
+    return matrix;
+};
+
+Pattern::Pattern() {}
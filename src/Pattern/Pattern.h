@@ -4,11 +4,33 @@
 #include "Color.h"
 #include "Matrix.h"
 
+//A 4x4 transform kept inside the pattern, so a pattern made in the PatternPool carries its transform
+//with it instead of pointing at the heap like Matrix does. Converts to and from Matrix. The inverse
+//is worked out when the transform is set, not every time a point is looked up.
+class PatternTransform {
+public:
+    float values[16];
+    float inverseValues[16];
+
+    PatternTransform(); //identity
+    PatternTransform(Matrix const &matrix);
+
+    operator Matrix() const;
+    bool operator== (Matrix const &other) const;
+
+    //`point` in the pattern's space, the same floats as inverse(transform) * point
+    Tuple toPattern(Tuple const &point) const;
+};
+
+//the cached inverse
+Matrix inverse(PatternTransform const &transform);
+
 class Pattern {
 public:
-    Matrix transform; 
+    PatternTransform transform; 
 
     Pattern();
+    virtual ~Pattern() = default;
     virtual Color colorAt(Tuple const &point) = 0;
 };
 
@@ -0,0 +1,44 @@
+#include "Perturb.h"
+
+#include <vector>
+
+#include "Noise.h"
+
+//where the y and z offsets sample the noise, far enough from x that the three look unrelated
+static const float offsetY[3] = {31.416f, 47.853f, 12.793f};
+static const float offsetZ[3] = {-27.179f, 13.692f, 57.071f};
+
+Perturb::Perturb(Pattern &pattern, float amount) : pattern(&pattern), amount(amount) {};
+
+Tuple Perturb::jitter(Tuple const &point, float amount) {
+    float x[3] = {point.x, point.x + offsetY[0], point.x + offsetZ[0]};
+    float y[3] = {point.y, point.y + offsetY[1], point.y + offsetZ[1]};
+    float z[3] = {point.z, point.z + offsetY[2], point.z + offsetZ[2]};
+    float noise[3];
+    perlin(x, y, z, noise, 3);
+    return {point.x + amount*noise[0], point.y + amount*noise[1], point.z + amount*noise[2], point.w};
+};
+
+void Perturb::jitter(Tuple* points, int count, float amount) {
+    std::vector<float> x(count*3), y(count*3), z(count*3), noise(count*3);
+    for (int i = 0; i < count; i++) {
+        x[i] = points[i].x;
+        y[i] = points[i].y;
+        z[i] = points[i].z;
+        x[count + i] = points[i].x + offsetY[0];
+        y[count + i] = points[i].y + offsetY[1];
+        z[count + i] = points[i].z + offsetY[2];
+        x[2*count + i] = points[i].x + offsetZ[0];
+        y[2*count + i] = points[i].y + offsetZ[1];
+        z[2*count + i] = points[i].z + offsetZ[2];
+    }
+    perlin(x.data(), y.data(), z.data(), noise.data(), count*3);
+    for (int i = 0; i < count; i++) {
+        points[i] = Tuple(points[i].x + amount*noise[i], points[i].y + amount*noise[count + i],
+                          points[i].z + amount*noise[2*count + i], points[i].w);
+    }
+};
+
+Color Perturb::colorAt(Tuple const &point) {
+    return pattern->colorAt(pattern->transform.toPattern(jitter(point, amount)));
+};
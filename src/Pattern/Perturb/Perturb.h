@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Pattern.h"
+
+//Moves the point by noise before handing it to another pattern, which turns stripes and rings
+//into marble and wood grain
+class Perturb : public Pattern {
+public:
+    Pattern* pattern;
+    float amount;   //largest offset along each axis
+
+    Perturb(Pattern &pattern, float amount);
+
+    //`point` offset by three decorrelated Perlin lookups, one per axis
+    static Tuple jitter(Tuple const &point, float amount);
+    static void jitter(Tuple* points, int count, float amount);
+
+    Color colorAt(Tuple const &point) override;
+};
@@ -3,9 +3,9 @@
 
 #include "Solid.h"
 
-Ring::Ring(Color a, Color b) {
-    patternA = new Solid(a); 
-    patternB = new Solid(b); 
+Ring::Ring(PatternPool &pool, Color a, Color b) {
+    patternA = &pool.make<Solid>(a);
+    patternB = &pool.make<Solid>(b);
 };
 
 Ring::Ring(Pattern &a, Pattern &b) {
@@ -16,7 +16,7 @@ Ring::Ring(Pattern &a, Pattern &b) {
 
 
 Color Ring::colorAt(Tuple const &point) {
-    Tuple pointPatternSpaceA = inverse(patternA->transform) * point;
-    Tuple pointPatternSpaceB = inverse(patternB->transform) * point;
+    Tuple pointPatternSpaceA = patternA->transform.toPattern(point);
+    Tuple pointPatternSpaceB = patternB->transform.toPattern(point);
     return (int) sqrt((point.x*point.x) + (point.z*point.z)) % 2 == 0 ? patternA->colorAt(pointPatternSpaceA) : patternB->colorAt(pointPatternSpaceB);
 };
\ No newline at end of file
@@ -2,13 +2,16 @@
 
 #include "Pattern.h"
 #include "Color.h"
+#include "PatternPool.h"
 
 class Ring : public Pattern {
 public:
     Pattern* patternA;
     Pattern* patternB;
     
-    Ring(Color a, Color b);
+    //the two colors become Solid children made in `pool`, next to the ring
+    Ring(PatternPool &pool, Color a, Color b);
     Ring(Pattern &a, Pattern &b);
+    Ring(Ring const &other) = delete;
     Color colorAt(Tuple const &point) override;
 };
\ No newline at end of file
@@ -3,9 +3,9 @@
 
 #include "Solid.h"
 
-Stripe::Stripe(Color a, Color b) {
-    patternA = new Solid(a); 
-    patternB = new Solid(b); 
+Stripe::Stripe(PatternPool &pool, Color a, Color b) {
+    patternA = &pool.make<Solid>(a);
+    patternB = &pool.make<Solid>(b);
 };
 
 Stripe::Stripe(Pattern &a, Pattern &b) {
@@ -14,8 +14,8 @@ Stripe::Stripe(Pattern &a, Pattern &b) {
 };
 
 Color Stripe::colorAt(Tuple const &point) {
-    Tuple pointPatternSpaceA = inverse(patternA->transform) * point;
-    Tuple pointPatternSpaceB = inverse(patternB->transform) * point;
+    Tuple pointPatternSpaceA = patternA->transform.toPattern(point);
+    Tuple pointPatternSpaceB = patternB->transform.toPattern(point);
 
     Color color = ( (int)std::floor(point.x) % 2 == 0) ? patternA->colorAt(pointPatternSpaceA) : patternB->colorAt(pointPatternSpaceB);
     return color; 
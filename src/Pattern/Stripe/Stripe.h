@@ -2,14 +2,17 @@
 
 #include "Pattern.h"
 #include "Color.h"
+#include "PatternPool.h"
 
 class Stripe : public Pattern {
 public: 
     Pattern* patternA;
     Pattern* patternB;
     
-    Stripe(Color a, Color b);
+    //the two colors become Solid children made in `pool`, next to the stripe
+    Stripe(PatternPool &pool, Color a, Color b);
     Stripe(Pattern &a, Pattern &b);
+    Stripe(Stripe const &other) = delete;
 
     Color colorAt(Tuple const &point) override;
 };
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "PatternPool.h"
+
+#include <algorithm>
+
+const std::size_t PatternPool::blockSize;
+
+PatternPool::PatternPool() : block(0), used(0) {};
+
+PatternPool::~PatternPool() {
+    clear();
+};
+
+int PatternPool::size() const {
+    return patterns.size();
+};
+
+Pattern* PatternPool::operator[](int index) const {
+    return patterns[index];
+};
+
+int PatternPool::blocks() const {
+    return memory.size();
+};
+
+void PatternPool::clear() {
+    for (auto pattern = patterns.rbegin(); pattern != patterns.rend(); pattern++) {
+        (*pattern)->~Pattern();
+    }
+    patterns.clear();
+    block = 0;
+    used = 0;
+};
+
+void* PatternPool::allocate(std::size_t size, std::size_t alignment) {
+    while (block < (int)memory.size()) {
+        std::size_t start = (used + alignment - 1) / alignment * alignment;
+        if (start + size <= capacity[block]) {
+            used = start + size;
+            return memory[block].get() + start;
+        }
+        block++;
+        used = 0;
+    }
+
+    //new[] of char is aligned for any fundamental type, which covers every pattern
+    std::size_t bytes = std::max(blockSize, size);
+    memory.emplace_back(new char[bytes]);
+    capacity.push_back(bytes);
+    block = memory.size() - 1;
+    used = size;
+    return memory[block].get();
+};
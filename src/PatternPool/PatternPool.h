@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "Pattern.h"
+
+//Owns the patterns of a world. Patterns are constructed in place in blocks of memory, one after
+//the other, so a pattern tree built in one go (the patterns of one material) sits on neighbouring
+//cache lines. Everything is destroyed with the pool, in reverse order of construction.
+class PatternPool {
+public:
+    static const std::size_t blockSize = 4096;
+
+    PatternPool();
+    ~PatternPool();
+    PatternPool(PatternPool const &other) = delete;
+    void operator=(PatternPool const &other) = delete;
+
+    template <class T, class... Args>
+    T& make(Args&&... args) {
+        T* pattern = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        patterns.push_back(pattern);
+        return *pattern;
+    };
+
+    //patterns in the order they were made
+    int size() const;
+    Pattern* operator[](int index) const;
+
+    //blocks of memory allocated so far
+    int blocks() const;
+
+    //destroys every pattern, the blocks are kept for the next ones
+    void clear();
+
+private:
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    std::vector<std::unique_ptr<char[]>> memory;
+    std::vector<std::size_t> capacity;
+    int block;                  //in `memory`, where the next pattern goes
+    std::size_t used;           //bytes of `block` taken
+    std::vector<Pattern*> patterns;
+};
@@ -2,7 +2,23 @@
 #include <limits>
 #include <cmath>
 
-Ray::Ray(Tuple const& origin, Tuple const& direction) : origin(origin), direction(direction) {};
+#include "Bounds.h"
+
+Ray::Ray(Tuple const& origin, Tuple const& direction, RayType type, int depth) :
+    origin(origin), direction(direction), invDirection(reciprocal(direction)),
+    tMin(0.0f), tMax(std::numeric_limits<float>::infinity()), depth(depth), type(type) {
+    sign[0] = invDirection.x < 0.0f;
+    sign[1] = invDirection.y < 0.0f;
+    sign[2] = invDirection.z < 0.0f;
+};
+
+Ray Ray::reframed(Tuple const &newOrigin, Tuple const &newDirection) const {
+    //an affine transform keeps t, so the range carries over as is
+    Ray ray(newOrigin, newDirection, type, depth);
+    ray.tMin = tMin;
+    ray.tMax = tMax;
+    return ray;
+};
 
 
 //Outside of class
@@ -12,5 +28,5 @@ Tuple position(Ray const &ray, float t) {
 };
 
 Ray transformRay(Ray const& ray, Matrix const& transform) {
-    return {transform * ray.origin, transform * ray.direction};
-};
\ No newline at end of file
+    return ray.reframed(transform * ray.origin, transform * ray.direction);
+};
@@ -5,11 +5,33 @@
 #include "Intersection.h"
 #include "Matrix.h"
 
+enum class RayType {
+    Camera,
+    Shadow,
+    Reflection,
+    Refraction
+};
+
 class Ray {
 public:
     Tuple origin;
     Tuple direction;
-    Ray(Tuple const &origin, Tuple const &direction);   
+
+    //derived from direction once, when the ray is built, for every slab test it goes through
+    Tuple invDirection;
+    int sign[3];        //1 where the direction is negative
+
+    //hits that count lie in (tMin, tMax)
+    float tMin;
+    float tMax;
+
+    int depth;          //bounces since the camera
+    RayType type;
+
+    Ray(Tuple const &origin, Tuple const &direction, RayType type = RayType::Camera, int depth = 0);
+
+    //the same ray (tags and t range) with a new origin and direction, e.g. in object space
+    Ray reframed(Tuple const &origin, Tuple const &direction) const;
 };
 
 Tuple position(Ray const &ray, float t);
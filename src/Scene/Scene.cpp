@@ -0,0 +1,362 @@
+#include "Scene.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "Transformations.h"
+#include "Sphere.h"
+#include "Cube.h"
+#include "Plane.h"
+#include "Cylinder.h"
+#include "Cone.h"
+#include "Disk.h"
+#include "CSG.h"
+#include "Stripe.h"
+#include "Ring.h"
+#include "Gradient.h"
+#include "Grid.h"
+#include "Solid.h"
+#include "ImageTexture.h"
+#include "NoisePattern.h"
+#include "Perturb.h"
+
+static const char* demoScene = R"(
+camera 1024 720 1.0471976
+view 0 1.5 -5  0 1 0  0 1 0
+light -10 10 -10  1 1 1
+
+# floor
+plane
+pattern grid 1 1 1  0 0 0
+diffuse 0.7
+specular 0.3
+
+# middle
+cube
+translate -0.5 1 0.5
+color 0.5 0.4 0.4
+transparency 0.8
+refractive-index 1.0105
+reflective 0.8
+diffuse 0.7
+specular 0.3
+
+# right
+sphere
+scale 0.5 0.5 0.5
+translate 1.5 0.5 -0.5
+color 0.5 1 0.1
+transparency 0.85
+refractive-index 0.985
+reflective 0.5
+diffuse 0.7
+specular 0.3
+
+# left
+sphere
+scale 0.33 0.33 0.33
+translate -1.5 0.33 -0.75
+pattern gradient 1 1 0.85  0.8 0.15 0.55
+pattern-translate -0.5 0 0
+pattern-scale 2.25 2.25 2.25
+pattern-rotate-z 0.3926991
+color 1 0.8 0.1
+diffuse 0.7
+specular 0.3
+reflective 0.5
+)";
+
+Scene::Scene(std::size_t textureBudget) : textures(new TextureCache(textureBudget)), camera(100, 100, M_PI/3.0f), hash(14695981039346656037ull) {};
+
+std::unique_ptr<Scene> Scene::DemoScene() {
+    std::istringstream input(demoScene);
+    return parseScene(input, "demo");
+};
+
+
+//Out of class
+
+std::unique_ptr<Scene> loadScene(std::string const &path, std::size_t textureBudget) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open scene " + path);
+    }
+    return parseScene(file, path, textureBudget);
+};
+
+static float readFloat(std::istringstream &line, std::string const &where) {
+    float value;
+    if (!(line >> value)) {
+        throw std::runtime_error(where + ": expected a number");
+    }
+    return value;
+};
+
+//a whole number of pixels, at least 1
+static int readSize(std::istringstream &line, std::string const &where, std::string const &what) {
+    std::string token;
+    std::size_t end = 0;
+    int value = 0;
+    if (line >> token) {
+        try {
+            value = std::stoi(token, &end);
+        } catch (std::exception const &) {
+            end = 0;
+        }
+    }
+    if (end == 0 || end != token.size()) {
+        throw std::runtime_error(where + ": camera " + what + " expects an integer, got '" + token + "'");
+    }
+    if (value < 1) {
+        throw std::runtime_error(where + ": camera " + what + " must be at least 1");
+    }
+    return value;
+};
+
+static Tuple readTriple(std::istringstream &line, std::string const &where) {
+    float x = readFloat(line, where);
+    float y = readFloat(line, where);
+    float z = readFloat(line, where);
+    return {x, y, z, 0.0f};
+};
+
+static Color readColor(std::istringstream &line, std::string const &where) {
+    Tuple t = readTriple(line, where);
+    return {t.x, t.y, t.z};
+};
+
+static Matrix readTransformation(std::string const &keyword, std::istringstream &line, std::string const &where) {
+    if (keyword == "translate") {
+        Tuple t = readTriple(line, where);
+        return translation(t.x, t.y, t.z);
+    }
+    if (keyword == "scale") {
+        Tuple t = readTriple(line, where);
+        return scaling(t.x, t.y, t.z);
+    }
+    if (keyword == "rotate-x") {
+        return rotation_x(readFloat(line, where));
+    }
+    if (keyword == "rotate-y") {
+        return rotation_y(readFloat(line, where));
+    }
+    if (keyword == "rotate-z") {
+        return rotation_z(readFloat(line, where));
+    }
+    if (keyword == "shear") {
+        float s[6];
+        for (int i = 0; i < 6; i++) {
+            s[i] = readFloat(line, where);
+        }
+        return shearing(s[0], s[1], s[2], s[3], s[4], s[5]);
+    }
+    throw std::runtime_error(where + ": unknown statement '" + keyword + "'");
+};
+
+static Pattern* readPattern(Scene &scene, std::istringstream &line, std::string const &where) {
+    std::string type;
+    line >> type;
+
+    PatternPool &pool = *scene.world.patterns;
+    Pattern* pattern;
+    if (type == "solid") {
+        pattern = &pool.make<Solid>(readColor(line, where));
+    } else if (type == "image") {
+        std::string path, mapping;
+        if (!(line >> path >> mapping)) {
+            throw std::runtime_error(where + ": expected an image path and sphere, plane or cube");
+        }
+        ImageTexture* image;
+        try {
+            image = &pool.make<ImageTexture>(*scene.textures, scene.textures->load(path), uvMappingFromName(mapping));
+        } catch (std::exception const &e) {
+            throw std::runtime_error(where + ": " + e.what());
+        }
+        float lod;
+        if (line >> lod) {
+            if (lod < 0.0f) {
+                throw std::runtime_error(where + ": lod must not be negative");
+            }
+            image->lod = lod;
+        }
+        pattern = image;
+    } else {
+        Color a = readColor(line, where);
+        Color b = readColor(line, where);
+        if (type == "stripe") {
+            pattern = &pool.make<Stripe>(pool, a, b);
+        } else if (type == "ring") {
+            pattern = &pool.make<Ring>(pool, a, b);
+        } else if (type == "gradient") {
+            pattern = &pool.make<Gradient>(a, b);
+        } else if (type == "grid") {
+            pattern = &pool.make<Grid>(pool, a, b);
+        } else if (type == "perlin") {
+            pattern = &pool.make<NoisePattern>(NoiseType::Perlin, a, b);
+        } else if (type == "fbm" || type == "turbulence") {
+            int octaves = 4;
+            if (!(line >> octaves)) {
+                octaves = 4;
+            } else if (octaves < 1) {
+                throw std::runtime_error(where + ": octaves must be at least 1");
+            }
+            pattern = &pool.make<NoisePattern>(type == "fbm" ? NoiseType::FBM : NoiseType::Turbulence, a, b, octaves);
+        } else {
+            throw std::runtime_error(where + ": unknown pattern '" + type + "'");
+        }
+    }
+
+    return pattern;
+};
+
+//lines that change the material of the current object
+static bool setsMaterial(std::string const &keyword) {
+    return keyword == "color" || keyword == "ambient" || keyword == "diffuse" || keyword == "specular" ||
+           keyword == "shininess" || keyword == "reflective" || keyword == "transparency" ||
+           keyword == "refractive-index" || keyword == "pattern" || keyword.compare(0, 8, "pattern-") == 0;
+};
+
+//minimum, maximum and closed of a cylinder or cone
+static void setExtent(Object* object, std::string const &keyword, std::istringstream &line, std::string const &where) {
+    float* minimum;
+    float* maximum;
+    bool* closed;
+    if (Cylinder* cylinder = dynamic_cast<Cylinder*>(object)) {
+        minimum = &cylinder->minimum;
+        maximum = &cylinder->maximum;
+        closed = &cylinder->closed;
+    } else if (Cone* cone = dynamic_cast<Cone*>(object)) {
+        minimum = &cone->minimum;
+        maximum = &cone->maximum;
+        closed = &cone->closed;
+    } else {
+        throw std::runtime_error(where + ": '" + keyword + "' only applies to cylinders and cones");
+    }
+
+    if (keyword == "minimum") {
+        *minimum = readFloat(line, where);
+    } else if (keyword == "maximum") {
+        *maximum = readFloat(line, where);
+    } else {
+        *closed = true;
+    }
+};
+
+std::unique_ptr<Scene> parseScene(std::istream &input, std::string const &name, std::size_t textureBudget) {
+    std::unique_ptr<Scene> scene(new Scene(textureBudget));
+    Object* object = nullptr;
+
+    std::string text;
+    int lineNumber = 0;
+    while (std::getline(input, text)) {
+        lineNumber++;
+        for (char c : text + '\n') {
+            scene->hash = (scene->hash ^ (unsigned char)c) * 1099511628211ull;
+        }
+        std::string where = name + ":" + std::to_string(lineNumber);
+
+        std::string::size_type comment = text.find('#');
+        if (comment != std::string::npos) {
+            text.erase(comment);
+        }
+
+        std::istringstream line(text);
+        std::string keyword;
+        if (!(line >> keyword)) {
+            continue;
+        }
+
+        if (keyword == "camera") {
+            int hsize = readSize(line, where, "width");
+            int vsize = readSize(line, where, "height");
+            float fieldOfView = readFloat(line, where);
+            Matrix view = scene->camera.transform;
+            scene->camera = Camera(hsize, vsize, fieldOfView);
+            scene->camera.transform = view;
+        } else if (keyword == "view") {
+            Tuple from = readTriple(line, where);
+            Tuple to = readTriple(line, where);
+            Tuple up = readTriple(line, where);
+            from.w = 1.0f;
+            to.w = 1.0f;
+            scene->camera.transform = viewTransformation(from, to, up);
+        } else if (keyword == "light") {
+            Tuple position = readTriple(line, where);
+            position.w = 1.0f;
+            scene->world.light = Light(position, readColor(line, where));
+        } else if (keyword == "sphere" || keyword == "cube" || keyword == "plane" ||
+                   keyword == "cylinder" || keyword == "cone" || keyword == "disk") {
+            if (keyword == "sphere") {
+                object = new Sphere();
+            } else if (keyword == "cube") {
+                object = new Cube();
+            } else if (keyword == "cylinder") {
+                object = new Cylinder();
+            } else if (keyword == "cone") {
+                object = new Cone();
+            } else if (keyword == "disk") {
+                object = new Disk();
+            } else {
+                object = new Plane();
+            }
+            scene->objects.emplace_back(object);
+            scene->world.objects.push_back(object);
+        } else if (keyword == "union" || keyword == "intersection" || keyword == "difference") {
+            std::vector<Object*> &objects = scene->world.objects;
+            if (objects.size() < 2) {
+                throw std::runtime_error(where + ": '" + keyword + "' needs two objects before it");
+            }
+            Object* right = objects.back();
+            objects.pop_back();
+            Object* left = objects.back();
+            objects.pop_back();
+            object = new CSG(csgOperationFromName(keyword), *left, *right);
+            scene->objects.emplace_back(object);
+            objects.push_back(object);
+        } else if (object == nullptr) {
+            throw std::runtime_error(where + ": '" + keyword + "' before any object");
+        } else if (setsMaterial(keyword) && dynamic_cast<CSG*>(object) != nullptr) {
+            //hits report the child, whose material is the one shaded
+            throw std::runtime_error(where + ": '" + keyword + "' does not apply to a CSG, set it on its children");
+        } else if (keyword == "color") {
+            object->material.color = readColor(line, where);
+        } else if (keyword == "ambient") {
+            object->material.ambient = readFloat(line, where);
+        } else if (keyword == "diffuse") {
+            object->material.diffuse = readFloat(line, where);
+        } else if (keyword == "specular") {
+            object->material.specular = readFloat(line, where);
+        } else if (keyword == "shininess") {
+            object->material.shininess = readFloat(line, where);
+        } else if (keyword == "reflective") {
+            object->material.reflective = readFloat(line, where);
+        } else if (keyword == "transparency") {
+            object->material.transparency = readFloat(line, where);
+        } else if (keyword == "refractive-index") {
+            object->material.refractive_index = readFloat(line, where);
+        } else if (keyword == "minimum" || keyword == "maximum" || keyword == "closed") {
+            setExtent(object, keyword, line, where);
+        } else if (keyword == "pattern") {
+            object->material.setPattern(*readPattern(*scene, line, where));
+        } else if (keyword.compare(0, 8, "pattern-") == 0) {
+            Pattern* pattern = object->material.pattern;
+            if (pattern == nullptr) {
+                throw std::runtime_error(where + ": '" + keyword + "' before any pattern");
+            }
+            if (keyword == "pattern-perturb") {
+                //the wrapper goes in the pattern's place, later pattern- lines move both together
+                object->material.setPattern(scene->world.patterns->make<Perturb>(*pattern, readFloat(line, where)));
+                continue;
+            }
+            pattern->transform = readTransformation(keyword.substr(8), line, where) * pattern->transform;
+        } else {
+            object->setTransformation(readTransformation(keyword, line, where) * object->transform);
+        }
+    }
+
+    return scene;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Camera.h"
+#include "World.h"
+#include "Object.h"
+#include "Pattern.h"
+#include "TextureCache.h"
+
+/*
+Scene description, one statement per line, '#' starts a comment:
+
+    camera <hsize> <vsize> <fieldOfView>
+    view <from x y z> <to x y z> <up x y z>
+    light <x y z> <r g b>
+
+    sphere | cube | plane | cylinder | cone | disk    starts a new object, the lines below apply to it
+    union | intersection | difference     combines the two objects above into a new object, difference
+                                          keeps the first minus the second. It takes transformations
+                                          but no material or pattern lines, the children keep theirs
+    translate <x y z>
+    scale <x y z>
+    rotate-x | rotate-y | rotate-z <rad>
+    shear <xy xz yx yz zx zy>
+    minimum | maximum <y>                 cylinder and cone extent along y, unbounded by default
+    closed                                caps the ends of a cylinder or cone
+    color <r g b>
+    ambient | diffuse | specular | shininess | reflective | transparency | refractive-index <value>
+    pattern stripe | ring | gradient | grid <r g b> <r g b>
+    pattern solid <r g b>
+    pattern perlin <r g b> <r g b>
+    pattern fbm | turbulence <r g b> <r g b> [octaves]     octaves defaults to 4
+    pattern image <path> sphere | plane | cube [lod]    PPM or PFM texture, uv mapped for that shape.
+                                          The mip level is not picked per hit, lod sets it by hand:
+                                          0 (the default) is full resolution, each step halves it
+    pattern-translate | pattern-scale <x y z>
+    pattern-rotate-x | pattern-rotate-y | pattern-rotate-z <rad>
+    pattern-perturb <amount>              jitters the point the pattern so far is looked up at
+
+Transformations are applied in the order they are written. Texture paths are relative to the
+working directory.
+*/
+class Scene {
+public:
+    //declared first so it outlives the patterns in world.patterns reading it
+    std::unique_ptr<TextureCache> textures;
+
+    World world;
+    Camera camera;
+
+    //storage for the objects the world points to, its patterns are in world.patterns
+    std::vector<std::unique_ptr<Object>> objects;
+
+    //FNV-1a of the scene text, tells renders of different scenes apart (see RenderSettings::sceneHash)
+    std::uint64_t hash;
+
+    Scene(std::size_t textureBudget = TextureCache::defaultBudget);
+    Scene(Scene const &other) = delete;
+    void operator=(Scene const &other) = delete;
+
+    //the scene main() used to hard-code
+    static std::unique_ptr<Scene> DemoScene();
+};
+
+//`textureBudget` bounds the memory the scene's image textures take while rendering
+std::unique_ptr<Scene> loadScene(std::string const &path, std::size_t textureBudget = TextureCache::defaultBudget);
+
+//`name` is only used to prefix error messages
+std::unique_ptr<Scene> parseScene(std::istream &input, std::string const &name, std::size_t textureBudget = TextureCache::defaultBudget);
@@ -0,0 +1,169 @@
+#include "SphereBatch.h"
+
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SPHERE_BATCH_AVX
+#include <immintrin.h>
+#endif
+
+void SphereBatch::add(Object* sphere, Matrix const &inverseTransform) {
+    spheres.push_back(sphere);
+    for (int i = 0; i < 16; i++) {
+        inverse[i].push_back(inverseTransform.array[i]);
+    }
+};
+
+int SphereBatch::size() const {
+    return spheres.size();
+};
+
+static bool cpuHasAVX() {
+#ifdef SPHERE_BATCH_AVX
+    //runs from a static initializer, before the CPU model is known otherwise
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx");
+#else
+    return false;
+#endif
+};
+
+static std::atomic<bool> avxEnabled(cpuHasAVX());
+
+void SphereBatch::enableAVX(bool enabled) {
+    avxEnabled = enabled && cpuHasAVX();
+};
+
+bool SphereBatch::usingAVX() {
+    return avxEnabled;
+};
+
+//a, b and the discriminant of the ray/unit sphere quadratic, for one sphere. The operations and
+//their order are the ones of Matrix * Tuple and Sphere::localIntersects, so the floats match.
+static void quadratic(float const* const m[16], int i, Ray const &ray, float &a, float &b, float &det) {
+    Tuple const &o = ray.origin;
+    Tuple const &d = ray.direction;
+    float ox = m[0][i]*o.x + m[1][i]*o.y + m[2][i]*o.z + m[3][i]*o.w;
+    float oy = m[4][i]*o.x + m[5][i]*o.y + m[6][i]*o.z + m[7][i]*o.w;
+    float oz = m[8][i]*o.x + m[9][i]*o.y + m[10][i]*o.z + m[11][i]*o.w;
+    float ow = m[12][i]*o.x + m[13][i]*o.y + m[14][i]*o.z + m[15][i]*o.w;
+    float dx = m[0][i]*d.x + m[1][i]*d.y + m[2][i]*d.z + m[3][i]*d.w;
+    float dy = m[4][i]*d.x + m[5][i]*d.y + m[6][i]*d.z + m[7][i]*d.w;
+    float dz = m[8][i]*d.x + m[9][i]*d.y + m[10][i]*d.z + m[11][i]*d.w;
+    float dw = m[12][i]*d.x + m[13][i]*d.y + m[14][i]*d.z + m[15][i]*d.w;
+
+    //sphere to ray is the local origin minus the point (0, 0, 0)
+    float sx = ox - 0.0f, sy = oy - 0.0f, sz = oz - 0.0f, sw = ow - 1.0f;
+
+    a = dx*dx + dy*dy + dz*dz + dw*dw;
+    b = 2 * (dx*sx + dy*sy + dz*sz + dw*sw);
+    float c = (sx*sx + sy*sy + sz*sz + sw*sw) - 1.0f;
+    det = (b*b) - (4*a*c);
+};
+
+#ifdef SPHERE_BATCH_AVX
+
+//4 component dot product of 8 tuple pairs, summed in Tuple's order
+__attribute__((target("avx")))
+static inline __m256 dot(__m256 const *u, __m256 const *v) {
+    return _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+        _mm256_mul_ps(u[0], v[0]), _mm256_mul_ps(u[1], v[1])), _mm256_mul_ps(u[2], v[2])), _mm256_mul_ps(u[3], v[3]));
+};
+
+//quadratic() for spheres [first, first + 8), returns a bit per sphere with det >= 0
+__attribute__((target("avx")))
+static int quadratic8(float const* const m[16], int first, Ray const &ray, float a[8], float b[8], float det[8]) {
+    float const o[4] = {ray.origin.x, ray.origin.y, ray.origin.z, ray.origin.w};
+    float const d[4] = {ray.direction.x, ray.direction.y, ray.direction.z, ray.direction.w};
+
+    __m256 local[2][4];
+    for (int row = 0; row < 4; row++) {
+        __m256 m0 = _mm256_loadu_ps(m[row*4] + first);
+        __m256 m1 = _mm256_loadu_ps(m[row*4 + 1] + first);
+        __m256 m2 = _mm256_loadu_ps(m[row*4 + 2] + first);
+        __m256 m3 = _mm256_loadu_ps(m[row*4 + 3] + first);
+        //no fused multiply-add, it would round differently from the scalar path
+        local[0][row] = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+            _mm256_mul_ps(m0, _mm256_set1_ps(o[0])), _mm256_mul_ps(m1, _mm256_set1_ps(o[1]))),
+            _mm256_mul_ps(m2, _mm256_set1_ps(o[2]))), _mm256_mul_ps(m3, _mm256_set1_ps(o[3])));
+        local[1][row] = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+            _mm256_mul_ps(m0, _mm256_set1_ps(d[0])), _mm256_mul_ps(m1, _mm256_set1_ps(d[1]))),
+            _mm256_mul_ps(m2, _mm256_set1_ps(d[2]))), _mm256_mul_ps(m3, _mm256_set1_ps(d[3])));
+    }
+
+    __m256 zero = _mm256_set1_ps(0.0f);
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 s[4] = {_mm256_sub_ps(local[0][0], zero), _mm256_sub_ps(local[0][1], zero),
+                   _mm256_sub_ps(local[0][2], zero), _mm256_sub_ps(local[0][3], one)};
+    __m256 const *dir = local[1];
+
+    __m256 va = dot(dir, dir);
+    __m256 vb = _mm256_mul_ps(_mm256_set1_ps(2.0f), dot(dir, s));
+    __m256 vc = _mm256_sub_ps(dot(s, s), one);
+    __m256 vdet = _mm256_sub_ps(_mm256_mul_ps(vb, vb), _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(4.0f), va), vc));
+
+    _mm256_storeu_ps(a, va);
+    _mm256_storeu_ps(b, vb);
+    _mm256_storeu_ps(det, vdet);
+    return _mm256_movemask_ps(_mm256_cmp_ps(vdet, zero, _CMP_GE_OQ));
+};
+
+#endif
+
+//calls hit(sphere, a, b, det) for every sphere with a real root
+template<class Hit>
+static void forEachHit(SphereBatch const &batch, Ray const &ray, Hit &&hit) {
+    float const* const m[16] = {
+        batch.inverse[0].data(), batch.inverse[1].data(), batch.inverse[2].data(), batch.inverse[3].data(),
+        batch.inverse[4].data(), batch.inverse[5].data(), batch.inverse[6].data(), batch.inverse[7].data(),
+        batch.inverse[8].data(), batch.inverse[9].data(), batch.inverse[10].data(), batch.inverse[11].data(),
+        batch.inverse[12].data(), batch.inverse[13].data(), batch.inverse[14].data(), batch.inverse[15].data()};
+    int count = batch.size();
+    int i = 0;
+
+#ifdef SPHERE_BATCH_AVX
+    if (avxEnabled.load(std::memory_order_relaxed)) {
+        float a[8], b[8], det[8];
+        for (; i + 8 <= count; i += 8) {
+            int mask = quadratic8(m, i, ray, a, b, det);
+            for (int lane = 0; mask != 0; lane++, mask >>= 1) {
+                if (mask & 1) {
+                    hit(i + lane, a[lane], b[lane], det[lane]);
+                }
+            }
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        float a, b, det;
+        quadratic(m, i, ray, a, b, det);
+        if (det >= 0) {
+            hit(i, a, b, det);
+        }
+    }
+};
+
+void SphereBatch::intersect(Ray const &ray, std::vector<Intersection> &intersections) const {
+    forEachHit(*this, ray, [&](int sphere, float a, float b, float det) {
+        intersections.push_back(Intersection(*spheres[sphere], (-b - sqrt(det)) / (2*a)));
+        intersections.push_back(Intersection(*spheres[sphere], (-b + sqrt(det)) / (2*a)));
+    });
+};
+
+float SphereBatch::nearest(Ray const &ray) const {
+    float nearest = ray.tMax;
+    forEachHit(*this, ray, [&](int sphere, float a, float b, float det) {
+        float t1 = (-b - sqrt(det)) / (2*a);
+        float t2 = (-b + sqrt(det)) / (2*a);
+        if (t1 > ray.tMin && t1 < nearest) {
+            nearest = t1;
+        }
+        if (t2 > ray.tMin && t2 < nearest) {
+            nearest = t2;
+        }
+    });
+    return nearest;
+};
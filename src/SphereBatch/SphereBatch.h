@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+
+#include "Matrix.h"
+#include "Object.h"
+#include "Intersection.h"
+#include "Ray.h"
+
+//Spheres in structure-of-arrays form: each of the 16 inverse transform entries has its own array,
+//indexed by sphere. Transforming the ray and solving the quadratic runs for 8 spheres per pass with
+//AVX when the CPU has it, one sphere at a time otherwise. Results match Sphere::localIntersects.
+class SphereBatch {
+public:
+    std::vector<Object*> spheres;
+    std::vector<float> inverse[16];     //world -> unit sphere space, row-major entries
+
+    void add(Object* sphere, Matrix const &inverseTransform);
+    int size() const;
+
+    //appends both intersections of every sphere the ray meets, in the order the spheres were added
+    void intersect(Ray const &ray, std::vector<Intersection> &intersections) const;
+
+    //smallest t in the ray's (tMin, tMax), tMax when the ray misses every sphere
+    float nearest(Ray const &ray) const;
+
+    //false forces the scalar path, for tests and comparisons
+    static void enableAVX(bool enabled);
+    static bool usingAVX();
+};
@@ -0,0 +1,86 @@
+#include "Stats.h"
+
+#include <mutex>
+#include <iomanip>
+
+#ifdef RAYTRACER_STATS
+thread_local RenderStats threadStats;
+#endif
+
+static std::mutex totalsMutex;
+static RenderStats totals;
+
+void RenderStats::reset() {
+    for (int i = 0; i < (int)Counter::Count; i++) {
+        counters[i] = 0;
+    }
+};
+
+void RenderStats::merge(RenderStats const &other) {
+    for (int i = 0; i < (int)Counter::Count; i++) {
+        counters[i] += other.counters[i];
+    }
+};
+
+std::uint64_t RenderStats::rays() const {
+    return (*this)[Counter::PrimaryRays] + (*this)[Counter::ShadowRays] + 
+           (*this)[Counter::ReflectionRays] + (*this)[Counter::RefractionRays];
+};
+
+std::uint64_t RenderStats::operator[] (Counter counter) const {
+    return counters[(int)counter];
+};
+
+
+//Out of class
+
+char const* counterName(Counter counter) {
+    switch (counter) {
+        case Counter::PrimaryRays: return "primary_rays";
+        case Counter::ShadowRays: return "shadow_rays";
+        case Counter::ReflectionRays: return "reflection_rays";
+        case Counter::RefractionRays: return "refraction_rays";
+        case Counter::IntersectionTests: return "intersection_tests";
+        case Counter::MatrixInversions: return "matrix_inversions";
+        case Counter::LightingCalls: return "lighting_calls";
+        case Counter::PatternEvaluations: return "pattern_evaluations";
+        case Counter::TextureTileLoads: return "texture_tile_loads";
+        default: return "unknown";
+    }
+};
+
+void resetRenderStats() {
+    std::lock_guard<std::mutex> lock(totalsMutex);
+    totals.reset();
+#ifdef RAYTRACER_STATS
+    threadStats.reset();
+#endif
+};
+
+void flushThreadStats() {
+#ifdef RAYTRACER_STATS
+    std::lock_guard<std::mutex> lock(totalsMutex);
+    totals.merge(threadStats);
+    threadStats.reset();
+#endif
+};
+
+RenderStats renderStats() {
+    std::lock_guard<std::mutex> lock(totalsMutex);
+    return totals;
+};
+
+void writeStatsTable(std::ostream &out, RenderStats const &stats) {
+    for (int i = 0; i < (int)Counter::Count; i++) {
+        out << "  " << std::left << std::setw(20) << counterName((Counter)i) 
+            << std::right << std::setw(16) << stats.counters[i] << "\n";
+    }
+};
+
+void writeStatsJSON(std::ostream &out, RenderStats const &stats) {
+    out << "{";
+    for (int i = 0; i < (int)Counter::Count; i++) {
+        out << (i == 0 ? "" : ", ") << "\"" << counterName((Counter)i) << "\": " << stats.counters[i];
+    }
+    out << "}\n";
+};
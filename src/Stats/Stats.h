@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+enum class Counter {
+    PrimaryRays,
+    ShadowRays,
+    ReflectionRays,
+    RefractionRays,
+    IntersectionTests,
+    MatrixInversions,
+    LightingCalls,
+    PatternEvaluations,
+    TextureTileLoads,
+    Count
+};
+
+//no constructor on purpose: a zero-initialised thread_local needs no init guard on the hot path
+class RenderStats {
+public:
+    std::uint64_t counters[(int)Counter::Count];
+
+    void reset();
+    void merge(RenderStats const &other);
+    std::uint64_t rays() const;
+
+    std::uint64_t operator[] (Counter counter) const;
+};
+
+#ifdef RAYTRACER_STATS
+extern thread_local RenderStats threadStats;
+#define STATS_COUNT(counter) (++threadStats.counters[(int)Counter::counter])
+#define STATS_ADD(counter, amount) (threadStats.counters[(int)Counter::counter] += (amount))
+#else
+#define STATS_COUNT(counter) ((void)0)
+#define STATS_ADD(counter, amount) ((void)0)
+#endif
+
+char const* counterName(Counter counter);
+
+//clears the totals and the calling thread's counters, render() calls it first
+void resetRenderStats();
+
+//folds the calling thread's counters into the totals, render() threads call it when done
+void flushThreadStats();
+
+//totals of the last render()
+RenderStats renderStats();
+
+void writeStatsTable(std::ostream &out, RenderStats const &stats);
+
+void writeStatsJSON(std::ostream &out, RenderStats const &stats);
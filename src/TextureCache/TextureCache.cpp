@@ -0,0 +1,297 @@
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <stdexcept>
+
+#include "Stats.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+const int TextureCache::tileEdge;
+const std::size_t TextureCache::defaultBudget;
+const int TextureCache::maxShards;
+const int TextureCache::minShardTiles;
+
+static const std::size_t tileFloats = TextureCache::tileEdge*TextureCache::tileEdge*3;
+static const std::size_t tileBytes = tileFloats*sizeof(float);
+
+TextureCache::TextureCache(std::size_t budget) : maxBytes(budget), loads(0) {
+    std::size_t budgetTiles = budget / tileBytes;
+    shardCount = (int)std::min<std::size_t>(std::max<std::size_t>(budgetTiles / minShardTiles, 1), maxShards);
+    shardTiles = budgetTiles / shardCount;
+    shards.reset(new Shard[shardCount]);
+};
+
+TextureCache::~TextureCache() {
+    for (Texture const &texture : textures) {
+        close(texture.file);
+        std::remove(texture.cachePath.c_str());
+    }
+};
+
+int TextureCache::load(std::string const &path) {
+    auto known = byPath.find(path);
+    if (known != byPath.end()) {
+        return known->second;
+    }
+    ImageRows rows(path);
+    int texture = build(rows.width, rows.height, [&rows](float* rgb) { rows.readRow(rgb); });
+    byPath[path] = texture;
+    return texture;
+};
+
+int TextureCache::add(Canvas const &image) {
+    int y = 0;
+    return build(image.width, image.height, [&image, &y](float* rgb) { image.readRow(y++, rgb); });
+};
+
+//One mip level as it is written: rows come in top to bottom and are kept until a band of tileEdge
+//rows is complete, which is then written out as a row of tiles
+class LevelWriter {
+public:
+    int width, height;
+    int tilesX;
+    long offset;
+    int rows;
+    std::vector<float> band;
+};
+
+static void writeBand(LevelWriter const &level, int bandRows, int bandY, int file, std::vector<float> &tile) {
+    //the parts of edge tiles outside the image repeat the edge texels
+    int edge = TextureCache::tileEdge;
+    for (int tx = 0; tx < level.tilesX; tx++) {
+        for (int y = 0; y < edge; y++) {
+            float const* row = &level.band[(std::size_t)std::min(y, bandRows - 1)*level.width*3];
+            for (int x = 0; x < edge; x++) {
+                float const* source = &row[std::min(tx*edge + x, level.width - 1)*3];
+                float* texel = &tile[(y*edge + x)*3];
+                texel[0] = source[0];
+                texel[1] = source[1];
+                texel[2] = source[2];
+            }
+        }
+        off_t at = level.offset + ((off_t)bandY*level.tilesX + tx)*tileBytes;
+        if (pwrite(file, tile.data(), tileBytes, at) != (ssize_t)tileBytes) {
+            throw std::runtime_error("cannot write texture cache");
+        }
+    }
+};
+
+//adds a row to `level`, and every second row (or the last one alone) averaged with the one above
+//it, half as wide, to the next level
+static void pushRow(std::vector<LevelWriter> &levels, std::size_t index, float const* rgb, int file, std::vector<float> &tile) {
+    LevelWriter &level = levels[index];
+    int y = level.rows++;
+    int bandRow = y % TextureCache::tileEdge;
+    float* row = &level.band[(std::size_t)bandRow*level.width*3];
+    std::copy(rgb, rgb + level.width*3, row);
+
+    //tileEdge is even, so the row above an odd row is still in the band
+    if (index + 1 < levels.size() && (y % 2 == 1 || y == level.height - 1)) {
+        float const* above = y % 2 == 1 ? row - level.width*3 : row;
+        std::vector<float> half(levels[index + 1].width*3);
+        for (int x = 0; x < levels[index + 1].width; x++) {
+            int x1 = std::min(x*2 + 1, level.width - 1);
+            Color sum = Color(above[x*6], above[x*6 + 1], above[x*6 + 2]) + Color(above[x1*3], above[x1*3 + 1], above[x1*3 + 2]) +
+                        Color(row[x*6], row[x*6 + 1], row[x*6 + 2]) + Color(row[x1*3], row[x1*3 + 1], row[x1*3 + 2]);
+            Color average = sum * 0.25f;
+            half[x*3] = average.red;
+            half[x*3 + 1] = average.green;
+            half[x*3 + 2] = average.blue;
+        }
+        pushRow(levels, index + 1, half.data(), file, tile);
+    }
+
+    if (bandRow == TextureCache::tileEdge - 1 || y == level.height - 1) {
+        writeBand(level, bandRow + 1, y / TextureCache::tileEdge, file, tile);
+    }
+};
+
+int TextureCache::build(int width, int height, std::function<void(float*)> const &nextRow) {
+    if (width <= 0 || height <= 0) {
+        throw std::runtime_error("empty texture");
+    }
+
+    static std::atomic<int> files(0);
+    Texture texture;
+    texture.cachePath = (std::filesystem::temp_directory_path() /
+                         ("raytracer-" + std::to_string(getpid()) + "-" + std::to_string(files++) + ".tiles")).string();
+
+    //the size of every level, and so where its tiles go, is known up front
+    std::vector<LevelWriter> writers;
+    long offset = 0;
+    while (true) {
+        Level info;
+        info.width = width;
+        info.height = height;
+        info.tilesX = (width + tileEdge - 1) / tileEdge;
+        info.tilesY = (height + tileEdge - 1) / tileEdge;
+        info.offset = offset;
+        texture.levels.push_back(info);
+        offset += (long)info.tilesX*info.tilesY*tileBytes;
+
+        LevelWriter writer;
+        writer.width = width;
+        writer.height = height;
+        writer.tilesX = info.tilesX;
+        writer.offset = info.offset;
+        writer.rows = 0;
+        writers.push_back(writer);
+
+        if (width == 1 && height == 1) {
+            break;
+        }
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+    }
+
+    texture.file = open(texture.cachePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (texture.file < 0) {
+        throw std::runtime_error("cannot write texture cache " + texture.cachePath);
+    }
+
+    //rows stream through every level at once, so besides a band of tileEdge rows per level (about
+    //twice that of the source) nothing of the image is held in memory
+    try {
+        for (LevelWriter &writer : writers) {
+            writer.band.resize((std::size_t)tileEdge*writer.width*3);
+        }
+        Tile tile(tileFloats);
+        std::vector<float> row((std::size_t)writers[0].width*3);
+        for (int y = 0; y < writers[0].height; y++) {
+            nextRow(row.data());
+            pushRow(writers, 0, row.data(), texture.file, tile);
+        }
+    } catch (...) {
+        close(texture.file);
+        std::remove(texture.cachePath.c_str());
+        throw;
+    }
+
+    textures.push_back(texture);
+    return textures.size() - 1;
+};
+
+int TextureCache::levels(int texture) const {
+    return textures[texture].levels.size();
+};
+
+int TextureCache::width(int texture, int level) const {
+    return textures[texture].levels[level].width;
+};
+
+int TextureCache::height(int texture, int level) const {
+    return textures[texture].levels[level].height;
+};
+
+static int wrapped(int x, int size) {
+    x %= size;
+    return x < 0 ? x + size : x;
+};
+
+static Color texelOf(std::vector<float> const &tile, int x, int y) {
+    float const* t = &tile[((y % TextureCache::tileEdge)*TextureCache::tileEdge + x % TextureCache::tileEdge)*3];
+    return {t[0], t[1], t[2]};
+};
+
+Color TextureCache::texel(int texture, int level, int x, int y) {
+    Level const &info = textures[texture].levels[level];
+    x = wrapped(x, info.width);
+    y = wrapped(y, info.height);
+    return texelOf(*tile(texture, level, x / tileEdge, y / tileEdge), x, y);
+};
+
+void TextureCache::footprint(int texture, int level, int x, int y, bool wrap, Color texels[4]) {
+    Level const &info = textures[texture].levels[level];
+    int xs[2], ys[2];
+    for (int i = 0; i < 2; i++) {
+        xs[i] = wrap ? wrapped(x + i, info.width) : std::min(std::max(x + i, 0), info.width - 1);
+        ys[i] = wrap ? wrapped(y + i, info.height) : std::min(std::max(y + i, 0), info.height - 1);
+    }
+
+    //up to 4 distinct tiles, most footprints fall in one
+    std::shared_ptr<Tile const> fetched[4];
+    int fetchedX[4], fetchedY[4];
+    int count = 0;
+    for (int j = 0; j < 2; j++) {
+        for (int i = 0; i < 2; i++) {
+            int tileX = xs[i] / tileEdge;
+            int tileY = ys[j] / tileEdge;
+            int k = 0;
+            while (k < count && (fetchedX[k] != tileX || fetchedY[k] != tileY)) {
+                k++;
+            }
+            if (k == count) {
+                fetched[k] = tile(texture, level, tileX, tileY);
+                fetchedX[k] = tileX;
+                fetchedY[k] = tileY;
+                count++;
+            }
+            texels[j*2 + i] = texelOf(*fetched[k], xs[i], ys[j]);
+        }
+    }
+};
+
+std::shared_ptr<TextureCache::Tile const> TextureCache::tile(int texture, int level, int tileX, int tileY) {
+    Texture const &source = textures[texture];
+    Level const &info = source.levels[level];
+    //texture in the high bits, then level, then the tile's index in the level
+    std::uint64_t key = (std::uint64_t)texture << 40 | (std::uint64_t)level << 32 | (std::uint32_t)(tileY*info.tilesX + tileX);
+    Shard &shard = shards[std::hash<std::uint64_t>()(key) % shardCount];
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.tiles.find(key);
+        if (found != shard.tiles.end()) {
+            shard.recent.splice(shard.recent.begin(), shard.recent, found->second.used);
+            return found->second.tile;
+        }
+    }
+
+    //a miss reads without holding the lock, other threads keep hitting meanwhile
+    std::shared_ptr<Tile> data = std::make_shared<Tile>(tileFloats);
+    off_t offset = info.offset + (off_t)(tileY*info.tilesX + tileX)*tileBytes;
+    if (pread(source.file, data->data(), tileBytes, offset) != (ssize_t)tileBytes) {
+        throw std::runtime_error("cannot read texture cache " + source.cachePath);
+    }
+    loads++;
+    STATS_COUNT(TextureTileLoads);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.tiles.find(key);
+    if (found != shard.tiles.end()) {
+        //another thread read the same tile first, keep its copy
+        shard.recent.splice(shard.recent.begin(), shard.recent, found->second.used);
+        return found->second.tile;
+    }
+    //tiles still in use by other threads stay alive through their shared_ptr until those are done
+    while (!shard.recent.empty() && shard.tiles.size() + 1 > shardTiles) {
+        shard.tiles.erase(shard.recent.back());
+        shard.recent.pop_back();
+    }
+    shard.recent.push_front(key);
+    shard.tiles[key] = {data, shard.recent.begin()};
+    return data;
+};
+
+std::size_t TextureCache::budget() const {
+    return maxBytes;
+};
+
+std::size_t TextureCache::resident() {
+    std::size_t count = 0;
+    for (int i = 0; i < shardCount; i++) {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+        count += shards[i].tiles.size();
+    }
+    return count*tileBytes;
+};
+
+std::uint64_t TextureCache::tileLoads() {
+    return loads;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Color.h"
+#include "Canvas.h"
+
+/*
+Image textures for rendering within a fixed memory budget. load() streams an image once, a band
+of tileEdge rows at a time, builds its mip chain (each level half the size of the one above, down
+to 1x1) from it as it goes and writes every level to a cache file as tileEdge x tileEdge tiles of
+float RGB, so images larger than memory can be loaded. Texel lookups then page single tiles in from
+that file on demand, keeping the least recently used ones up to `budget` bytes. Thread safe: tiles
+are read with pread() outside any lock, and large budgets split the cache into shards by tile, each
+with its own lock and least recently used list, so render threads rarely wait on each other.
+*/
+class TextureCache {
+public:
+    static const int tileEdge = 32;
+    static const std::size_t defaultBudget = std::size_t(256) << 20;
+    static const int maxShards = 16;
+    static const int minShardTiles = 64;    //smaller budgets keep one shard, an exact LRU over every tile
+
+    TextureCache(std::size_t budget = defaultBudget);
+    ~TextureCache();    //removes the cache files
+    TextureCache(TextureCache const &other) = delete;
+    void operator=(TextureCache const &other) = delete;
+
+    //PPM or PFM, returns the handle of the texture. Loading a path again returns the same handle
+    int load(std::string const &path);
+
+    //the same from an image in memory
+    int add(Canvas const &image);
+
+    int levels(int texture) const;
+    int width(int texture, int level) const;
+    int height(int texture, int level) const;
+
+    //texel of `level`, x and y wrap around so textures repeat
+    Color texel(int texture, int level, int x, int y);
+
+    //the 2x2 texels (x, y), (x + 1, y), (x, y + 1), (x + 1, y + 1) of a bilinear lookup, wrapped
+    //around or clamped to the edges. Each tile they fall in is fetched once.
+    void footprint(int texture, int level, int x, int y, bool wrap, Color texels[4]);
+
+    std::size_t budget() const;
+    std::size_t resident();             //bytes of tiles in memory now
+    std::uint64_t tileLoads();          //tiles read from the cache files so far
+
+private:
+    class Level {
+    public:
+        int width, height;
+        int tilesX, tilesY;
+        long offset;        //of the level's first tile in the cache file
+    };
+    class Texture {
+    public:
+        std::string cachePath;
+        int file;           //descriptor of cachePath, tiles are pread() from it
+        std::vector<Level> levels;
+    };
+    typedef std::vector<float> Tile;
+    class Entry {
+    public:
+        std::shared_ptr<Tile const> tile;
+        std::list<std::uint64_t>::iterator used;
+    };
+
+    class Shard {
+    public:
+        std::mutex mutex;
+        std::list<std::uint64_t> recent;    //most recently used tile first
+        std::unordered_map<std::uint64_t, Entry> tiles;
+    };
+
+    std::size_t maxBytes;
+    std::vector<Texture> textures;
+    std::unordered_map<std::string, int> byPath;
+
+    int shardCount;
+    std::size_t shardTiles;             //tiles each shard keeps
+    std::unique_ptr<Shard[]> shards;
+    std::atomic<std::uint64_t> loads;
+
+    std::shared_ptr<Tile const> tile(int texture, int level, int tileX, int tileY);
+
+    //writes the tiles of a width x height image whose rows `nextRow` gives top to bottom
+    int build(int width, int height, std::function<void(float*)> const &nextRow);
+};
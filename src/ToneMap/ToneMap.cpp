@@ -0,0 +1,89 @@
+#include "ToneMap.h"
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include "Trace.h"
+
+ToneMapSettings::ToneMapSettings(ToneMapOperator op, float exposure, float gamma) : op(op), exposure(exposure), gamma(gamma) {};
+
+bool ToneMapSettings::identity() const {
+    return op == ToneMapOperator::None && exposure == 0.0f && gamma == 1.0f;
+};
+
+
+//Out of class
+
+//each pass is a plain loop over the flat channel array. Exposure and the operators vectorize, gamma
+//stays a std::pow call per channel
+
+static void scaleChannels(float* channels, std::size_t count, float scale) {
+    for (std::size_t i = 0; i < count; i++) {
+        channels[i] *= scale;
+    }
+};
+
+static void reinhard(float* channels, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        float x = channels[i] > 0.0f ? channels[i] : 0.0f;
+        channels[i] = x / (1.0f + x);
+    }
+};
+
+static void aces(float* channels, std::size_t count) {
+    const float a = 2.51f, b = 0.03f, c = 2.43f, d = 0.59f, e = 0.14f;
+    for (std::size_t i = 0; i < count; i++) {
+        float x = channels[i] > 0.0f ? channels[i] : 0.0f;
+        float y = (x*(a*x + b)) / (x*(c*x + d) + e);
+        channels[i] = y < 1.0f ? y : 1.0f;
+    }
+};
+
+static void applyGamma(float* channels, std::size_t count, float gamma) {
+    float exponent = 1.0f / gamma;
+    for (std::size_t i = 0; i < count; i++) {
+        channels[i] = channels[i] > 0.0f ? std::pow(channels[i], exponent) : 0.0f;
+    }
+};
+
+void toneMap(Canvas &canvas, ToneMapSettings const &settings) {
+    if (settings.identity()) {
+        return;
+    }
+    TraceSpan span("tone map");
+
+    float* channels = canvas.pixels;
+    //layout padding is mapped along with the image, it is never read back
+    std::size_t count = canvas.channelCount();
+
+    if (settings.exposure != 0.0f) {
+        scaleChannels(channels, count, std::exp2(settings.exposure));
+    }
+    switch (settings.op) {
+        case ToneMapOperator::None:
+            break;
+        case ToneMapOperator::Reinhard:
+            reinhard(channels, count);
+            break;
+        case ToneMapOperator::ACES:
+            aces(channels, count);
+            break;
+    }
+    if (settings.gamma != 1.0f) {
+        applyGamma(channels, count, settings.gamma);
+    }
+};
+
+ToneMapOperator toneMapOperatorFromName(std::string const &name) {
+    if (name == "none") {
+        return ToneMapOperator::None;
+    }
+    if (name == "reinhard") {
+        return ToneMapOperator::Reinhard;
+    }
+    if (name == "aces") {
+        return ToneMapOperator::ACES;
+    }
+    throw std::invalid_argument("unknown tone mapping operator: " + name);
+};
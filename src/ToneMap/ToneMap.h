@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+#include "Canvas.h"
+
+enum class ToneMapOperator {
+    None,       //clamp at write time, as before
+    Reinhard,   //x / (1 + x)
+    ACES        //Narkowicz's fit of the ACES filmic curve
+};
+
+//grading applied to a linear HDR canvas before it is written as 8-bit
+class ToneMapSettings {
+public:
+    ToneMapOperator op;
+    float exposure;     //in stops, 0 leaves the radiance as rendered
+    float gamma;        //1 writes linear values
+
+    ToneMapSettings(ToneMapOperator op = ToneMapOperator::None, float exposure = 0.0f, float gamma = 1.0f);
+
+    //true when toneMap() would leave the canvas as it is
+    bool identity() const;
+};
+
+//exposure, then the operator, then gamma, over every channel of the canvas in place
+void toneMap(Canvas &canvas, ToneMapSettings const &settings);
+
+//accepts the names used on the command line: "none", "reinhard", "aces"
+ToneMapOperator toneMapOperatorFromName(std::string const &name);
@@ -0,0 +1,132 @@
+#include "Trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+class TraceEvent {
+public:
+    std::string name;
+    std::string category;
+    std::string args;
+    long long start;
+    long long duration;
+    int thread;
+};
+
+static std::atomic<bool> enabled(false);
+static std::atomic<int> nextThread(0);
+static std::mutex eventsMutex;
+static std::vector<TraceEvent> events;
+static std::vector<std::string> threadNames;
+static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+static long long now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+};
+
+static int threadIndex() {
+    thread_local int index = nextThread++;
+    return index;
+};
+
+static void writeEscaped(std::ostream &out, std::string const &text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (c == '\n') {
+            out << "\\n";
+        } else {
+            out << c;
+        }
+    }
+};
+
+TraceSpan::TraceSpan(char const *name, char const *category) : 
+    name(name), category(category), start(enabled ? now() : -1) {};
+
+TraceSpan::TraceSpan(char const *name, char const *category, std::string const &args) :
+    name(name), category(category), args(args), start(enabled ? now() : -1) {};
+
+TraceSpan::~TraceSpan() {
+    if (start < 0) {
+        return;
+    }
+    long long end = now();
+    int thread = threadIndex();
+
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    events.push_back({name, category, args, start, end - start, thread});
+};
+
+
+//Out of class
+
+void enableTracing(bool enable) {
+    enabled = enable;
+};
+
+bool tracingEnabled() {
+    return enabled;
+};
+
+void clearTrace() {
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    events.clear();
+    threadNames.clear();
+};
+
+void nameTraceThread(std::string const &name) {
+    if (!enabled) {
+        return;
+    }
+    int thread = threadIndex();
+
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    if ((int)threadNames.size() <= thread) {
+        threadNames.resize(thread + 1);
+    }
+    threadNames[thread] = name;
+};
+
+void writeTrace(std::ostream &out) {
+    std::lock_guard<std::mutex> lock(eventsMutex);
+
+    out << "{\"traceEvents\": [\n";
+    bool first = true;
+    for (std::vector<std::string>::size_type i = 0; i < threadNames.size(); i++) {
+        if (threadNames[i].empty()) {
+            continue;
+        }
+        out << (first ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << i
+            << ", \"args\": {\"name\": \"";
+        writeEscaped(out, threadNames[i]);
+        out << "\"}}";
+        first = false;
+    }
+    for (TraceEvent const &event : events) {
+        out << (first ? "" : ",\n") << "{\"name\": \"";
+        writeEscaped(out, event.name);
+        out << "\", \"cat\": \"";
+        writeEscaped(out, event.category);
+        out << "\", \"ph\": \"X\", \"ts\": " << event.start << ", \"dur\": " << event.duration
+            << ", \"pid\": 1, \"tid\": " << event.thread;
+        if (!event.args.empty()) {
+            out << ", \"args\": {" << event.args << "}";
+        }
+        out << "}";
+        first = false;
+    }
+    out << "\n], \"displayTimeUnit\": \"ms\"}\n";
+};
+
+void writeTraceFile(std::string const &path) {
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open " + path + " for writing");
+    }
+    writeTrace(file);
+};
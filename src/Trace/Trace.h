@@ -0,0 +1,36 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+//Wall-clock spans written as Chrome/Perfetto trace events ("X" complete events).
+//Recording is off until enableTracing() is called; a disabled span costs one atomic load.
+class TraceSpan {
+public:
+    TraceSpan(char const *name, char const *category = "render");
+    TraceSpan(char const *name, char const *category, std::string const &args); //args: JSON object body, e.g. "\"x\": 0"
+    ~TraceSpan();
+
+    TraceSpan(TraceSpan const &other) = delete;
+    void operator=(TraceSpan const &other) = delete;
+
+private:
+    char const *name;
+    char const *category;
+    std::string args;
+    long long start;    //microseconds since the trace epoch, -1 when not recording
+};
+
+void enableTracing(bool enabled);
+
+bool tracingEnabled();
+
+//drops every recorded event
+void clearTrace();
+
+//labels the calling thread in the trace viewer
+void nameTraceThread(std::string const &name);
+
+void writeTrace(std::ostream &out);
+
+void writeTraceFile(std::string const &path);
@@ -0,0 +1,102 @@
+#include "UniformGrid.h"
+
+#include <cmath>
+
+const int UniformGrid::cellsPerPrimitive;
+const int UniformGrid::maxResolution;
+
+UniformGrid::UniformGrid() : resolution{1, 1, 1}, cellSize(Tuple::Vector(1.0f, 1.0f, 1.0f)), cellStart{0, 0}, primitiveCount(0) {};
+
+int UniformGrid::cells() const {
+    return resolution[0]*resolution[1]*resolution[2];
+};
+
+void UniformGrid::build(std::vector<Bounds> const &boxes) {
+    primitiveCount = boxes.size();
+    bounds = Bounds();
+    std::vector<Bounds> padded(boxes);
+    Tuple pad = Tuple::Vector(EPSILON, EPSILON, EPSILON);
+    for (Bounds &box : padded) {
+        box.min = box.min - pad;
+        box.max = box.max + pad;
+        bounds.add(box);
+    }
+    if (boxes.empty()) {
+        resolution[0] = resolution[1] = resolution[2] = 1;
+        cellStart.assign(2, 0);
+        cellPrimitives.clear();
+        return;
+    }
+
+    //cubic cells, cellsPerPrimitive of them per primitive. Flat scenes would have no volume, so
+    //no axis counts as thinner than a thousandth of the widest.
+    Tuple extent = bounds.max - bounds.min;
+    float const extents[3] = {extent.x, extent.y, extent.z};
+    float widest = std::max(extents[0], std::max(extents[1], extents[2]));
+    float volume = 1.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        volume *= std::max(extents[axis], widest*0.001f);
+    }
+    float perUnit = std::cbrt(cellsPerPrimitive*boxes.size() / volume);
+    for (int axis = 0; axis < 3; axis++) {
+        resolution[axis] = std::min(std::max((int)(extents[axis]*perUnit), 1), maxResolution);
+    }
+    cellSize = Tuple::Vector(extent.x / resolution[0], extent.y / resolution[1], extent.z / resolution[2]);
+
+    //each box goes in every cell it overlaps: count them, turn the counts into offsets, then fill
+    auto cellRange = [this](Bounds const &box, int first[3], int last[3]) {
+        float const low[3] = {box.min.x, box.min.y, box.min.z};
+        float const high[3] = {box.max.x, box.max.y, box.max.z};
+        float const origin[3] = {bounds.min.x, bounds.min.y, bounds.min.z};
+        float const size[3] = {cellSize.x, cellSize.y, cellSize.z};
+        for (int axis = 0; axis < 3; axis++) {
+            first[axis] = std::min(std::max((int)((low[axis] - origin[axis]) / size[axis]), 0), resolution[axis] - 1);
+            last[axis] = std::min(std::max((int)((high[axis] - origin[axis]) / size[axis]), 0), resolution[axis] - 1);
+        }
+    };
+
+    cellStart.assign(cells() + 1, 0);
+    int first[3], last[3];
+    for (Bounds const &box : padded) {
+        cellRange(box, first, last);
+        for (int z = first[2]; z <= last[2]; z++) {
+            for (int y = first[1]; y <= last[1]; y++) {
+                for (int x = first[0]; x <= last[0]; x++) {
+                    cellStart[(z*resolution[1] + y)*resolution[0] + x + 1]++;
+                }
+            }
+        }
+    }
+    for (int cell = 0; cell < cells(); cell++) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+
+    cellPrimitives.resize(cellStart[cells()]);
+    std::vector<int> filled(cellStart.begin(), cellStart.end() - 1);
+    for (int primitive = 0; primitive < primitiveCount; primitive++) {
+        cellRange(padded[primitive], first, last);
+        for (int z = first[2]; z <= last[2]; z++) {
+            for (int y = first[1]; y <= last[1]; y++) {
+                for (int x = first[0]; x <= last[0]; x++) {
+                    cellPrimitives[filled[(z*resolution[1] + y)*resolution[0] + x]++] = primitive;
+                }
+            }
+        }
+    }
+};
+
+unsigned UniformGrid::mailbox(unsigned* &visited) const {
+    thread_local std::vector<unsigned> stamps;
+    thread_local unsigned stamp = 0;
+
+    if ((int)stamps.size() < primitiveCount) {
+        stamps.resize(primitiveCount, 0);
+    }
+    //stamps are shared by every grid the thread walks, a new one per walk keeps them apart
+    if (++stamp == 0) {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        stamp = 1;
+    }
+    visited = stamps.data();
+    return stamp;
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "Bounds.h"
+#include "Ray.h"
+
+//Uniform grid over boxes the caller numbers 0..n-1, the same interface as BVH. Cells hold the
+//boxes overlapping them, stored as one array of primitive lists with an offset per cell. A ray walks
+//the cells it crosses front to back (3D-DDA), so for many objects of similar size it reaches the
+//nearest hit after a few cells. Boxes spanning several cells are tested once per walk, see mailbox().
+class UniformGrid {
+public:
+    //cells per primitive the resolution aims for, and the most cells along one axis
+    static const int cellsPerPrimitive = 2;
+    static const int maxResolution = 128;
+
+    Bounds bounds;
+    int resolution[3];
+    Tuple cellSize;
+    std::vector<int> cellStart;         //cell c lists cellPrimitives[cellStart[c], cellStart[c + 1])
+    std::vector<int> cellPrimitives;
+    int primitiveCount;
+
+    UniformGrid();
+
+    //boxes are padded by EPSILON, like the BVH's
+    void build(std::vector<Bounds> const &boxes);
+
+    int cells() const;
+
+    //calls visit(primitive) once for every primitive in a cell the ray crosses within (tMin, tMax).
+    //Cells are visited in order along the ray and the walk stops at the first cell that ends past
+    //`tMax`, which the visitor may shrink.
+    template <class Visit>
+    void traverse(Ray const &ray, float tMin, float const &tMax, Visit &&visit) const {
+        float near, far;
+        if (primitiveCount == 0 || !slabIntersect(bounds, ray, near, far)) {
+            return;
+        }
+        near = std::max(near, tMin);
+        if (near > std::min(far, tMax)) {
+            return;
+        }
+
+        float const origin[3] = {ray.origin.x, ray.origin.y, ray.origin.z};
+        float const direction[3] = {ray.direction.x, ray.direction.y, ray.direction.z};
+        float const invDirection[3] = {ray.invDirection.x, ray.invDirection.y, ray.invDirection.z};
+        float const low[3] = {bounds.min.x, bounds.min.y, bounds.min.z};
+        float const size[3] = {cellSize.x, cellSize.y, cellSize.z};
+
+        int cell[3], step[3];
+        float next[3], delta[3];
+        for (int axis = 0; axis < 3; axis++) {
+            float entry = origin[axis] + direction[axis]*near;
+            cell[axis] = std::min(std::max((int)((entry - low[axis]) / size[axis]), 0), resolution[axis] - 1);
+            if (direction[axis] > 0.0f) {
+                step[axis] = 1;
+                next[axis] = (low[axis] + (cell[axis] + 1)*size[axis] - origin[axis]) * invDirection[axis];
+                delta[axis] = size[axis] * invDirection[axis];
+            } else if (direction[axis] < 0.0f) {
+                step[axis] = -1;
+                next[axis] = (low[axis] + cell[axis]*size[axis] - origin[axis]) * invDirection[axis];
+                delta[axis] = -size[axis] * invDirection[axis];
+            } else {
+                step[axis] = 0;
+                next[axis] = std::numeric_limits<float>::infinity();
+                delta[axis] = 0.0f;
+            }
+        }
+
+        unsigned* visited;
+        unsigned stamp = mailbox(visited);
+        while (true) {
+            int index = (cell[2]*resolution[1] + cell[1])*resolution[0] + cell[0];
+            for (int i = cellStart[index]; i < cellStart[index + 1]; i++) {
+                int primitive = cellPrimitives[i];
+                if (visited[primitive] != stamp) {
+                    visited[primitive] = stamp;
+                    visit(primitive);
+                }
+            }
+
+            int axis = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2) : (next[1] < next[2] ? 1 : 2);
+            float exit = next[axis];
+            if (exit >= far || exit >= tMax) {
+                return;
+            }
+            cell[axis] += step[axis];
+            if (cell[axis] < 0 || cell[axis] >= resolution[axis]) {
+                return;
+            }
+            next[axis] += delta[axis];
+        }
+    };
+
+private:
+    //Mailboxing: the calling thread's array of one stamp per primitive and a fresh stamp for this
+    //walk. A primitive is tested when its entry differs from the stamp, then marked with it, so one
+    //spanning many cells is still tested once and no other thread's walk interferes.
+    unsigned mailbox(unsigned* &visited) const;
+};
@@ -5,8 +5,13 @@
 #include "World.h"
 #include "Sphere.h"
 #include "Transformations.h"
+#include "Stats.h"
 
-World::World() {};
+World::World() : patterns(std::make_shared<PatternPool>()) {};
+
+void World::compile(PowMode specular, Acceleration acceleration) {
+    flat = std::make_shared<FlatScene>(objects, specular, acceleration);
+};
 
 
 World World::DefaultWorld() {
@@ -41,16 +46,25 @@ bool World::isShadow(Tuple point) const {
     float distance = magnitude(pointToLight);
     Tuple direction = normalize(pointToLight);
 
-    Ray ray(point, direction);
+    Ray ray(point, direction, RayType::Shadow);
+    ray.tMax = distance;
+    return isShadow(ray);
+};
+
+bool World::isShadow(Ray const &ray) const {
+    STATS_COUNT(ShadowRays);
+    if (flat) {
+        //only the nearest hit matters, no need to collect and sort them all
+        return flat->nearestHit(ray) < ray.tMax;
+    }
     std::vector<Intersection> intersections = intersectsWorld(ray, *this);
 
     bool shadow = false; 
 
-    if (intersections.size() > 0) {
-        Intersection i = hit(intersections);
-
-        if (i.t < distance) {
+    for (Intersection const &intersection : intersections) {
+        if (intersection.t > ray.tMin && intersection.t < ray.tMax) {
             shadow = true;
+            break;
         }
     }
 
@@ -62,26 +76,41 @@ bool World::isShadow(Tuple point) const {
 std::vector<Intersection> intersectsWorld(Ray const &ray, World const &world) {
     std::vector<Intersection> worldIntersections;    
     
-    for (auto object : world.objects) {
-        std::vector<Intersection> objectIntersections = object->intersects(ray);
-        worldIntersections.insert(std::end(worldIntersections), std::begin(objectIntersections), std::end(objectIntersections));
-    };
+    if (world.flat) {
+        world.flat->intersect(ray, worldIntersections);
+    } else {
+        for (auto object : world.objects) {
+            std::vector<Intersection> objectIntersections = object->intersects(ray);
+            worldIntersections.insert(std::end(worldIntersections), std::begin(objectIntersections), std::end(objectIntersections));
+        };
+    }
 
     //sort by t
-    std::sort(worldIntersections.begin(), worldIntersections.end(), [](const Intersection& lhs, const Intersection& rhs) { 
-        return lhs.t < rhs.t; 
-    });
+    if (world.flat) {
+        FlatScene const &flat = *world.flat;
+        std::sort(worldIntersections.begin(), worldIntersections.end(), [&flat](const Intersection& lhs, const Intersection& rhs) { 
+            return lhs.t < rhs.t || (lhs.t == rhs.t && lhs.object != rhs.object && flat.order(lhs.object) < flat.order(rhs.object)); 
+        });
+    } else {
+        std::sort(worldIntersections.begin(), worldIntersections.end(), [](const Intersection& lhs, const Intersection& rhs) { 
+            return lhs.t < rhs.t; 
+        });
+    }
 
     return worldIntersections;
 };
 
 Color shadeHit(World const &world, Computation const &comp, int remaining) {
     bool isShadowed = world.isShadow(comp.overPoint);
-    Color surface = lighting(comp.object, world.light, comp.overPoint, comp.eyeDirection, comp.normal, isShadowed); //TODO: support multiple light sources
+    Material const &material = *comp.material;
+    Color surface = world.flat ? 
+        lighting(material, world.flat->colorAt(comp.object, comp.overPoint), world.light, comp.overPoint, comp.eyeDirection, comp.normal, isShadowed,
+                 &world.flat->specularPower(comp.object)) :
+        lighting(comp.object, world.light, comp.overPoint, comp.eyeDirection, comp.normal, isShadowed); //TODO: support multiple light sources
     Color reflected = reflectedColor(world, comp, remaining);
     Color refracted = refractedColor(world, comp, remaining);
     
-    if (comp.object->material.reflective > 0.0f && comp.object->material.transparency > 0.0f) {
+    if (material.reflective > 0.0f && material.transparency > 0.0f) {
         float reflectance = shlick(comp);
         return surface + reflected*reflectance + refracted*(1-reflectance);
     }
@@ -95,11 +124,14 @@ Color colorAt(World const &world, Ray const &ray, int remaining) {
 
     std::vector<Intersection> intersections = intersectsWorld(ray, world);
 
-    if (intersections.size() > 0){
-        Intersection intersection = hit(intersections);
-        if (intersection.t < std::numeric_limits<float>::infinity()) {
-            Computation comp = prepareComputation(intersection, ray, intersections);
-            color = shadeHit(world, comp, remaining);
+    //sorted by t, so the hit is the first one past the ray's tMin
+    for (Intersection const &intersection : intersections) {
+        if (intersection.t > ray.tMin) {
+            if (intersection.t < ray.tMax) {
+                Computation comp = prepareShading(intersection, ray, intersections, world.flat.get());
+                color = shadeHit(world, comp, remaining);
+            }
+            break;
         }
     }
     return color;
@@ -107,12 +139,13 @@ Color colorAt(World const &world, Ray const &ray, int remaining) {
 
 
 Color reflectedColor(World const &world, Computation const &comp, int remaining) {
-    float reflective = comp.object->material.reflective;
+    float reflective = comp.material->reflective;
     if (reflective == 0.0f || remaining < 1) {
         return {0.0f, 0.0f, 0.0f};
     }
     else {
-        Ray reflectedRay(comp.overPoint, comp.reflectv);
+        Ray reflectedRay(comp.overPoint, comp.reflectv, RayType::Reflection, comp.depth + 1);
+        STATS_COUNT(ReflectionRays);
         Color color = colorAt(world, reflectedRay, remaining - 1);
         return color * reflective;
     }
@@ -120,7 +153,7 @@ Color reflectedColor(World const &world, Computation const &comp, int remaining)
 
 
 Color refractedColor(World const &world, Computation const &comp, int remaining) {
-    if (comp.object->material.transparency == 0.0f || remaining == 0) {
+    if (comp.material->transparency == 0.0f || remaining == 0) {
         return {0.0f, 0.0f, 0.0f};
     } 
     
@@ -135,9 +168,8 @@ Color refractedColor(World const &world, Computation const &comp, int remaining)
     float cos_t = sqrt(1.0f - sin2_t);
     Tuple refractedDirection = comp.normal*(nRatio*cos_i - cos_t) - comp.eyeDirection*nRatio;
 
-    Ray refractedRay(comp.underPoint, refractedDirection);
+    Ray refractedRay(comp.underPoint, refractedDirection, RayType::Refraction, comp.depth + 1);
+    STATS_COUNT(RefractionRays);
 
-    Color color1 = colorAt(world, refractedRay, remaining-1);
-    
-    return colorAt(world, refractedRay, remaining-1) * comp.object->material.transparency;
+    return colorAt(world, refractedRay, remaining-1) * comp.material->transparency;
 };
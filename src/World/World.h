@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "Object.h"
@@ -7,6 +8,8 @@
 #include "Intersection.h"
 #include "Ray.h"
 #include "Computation.h"
+#include "FlatScene.h"
+#include "PatternPool.h"
 
 
 class World {
@@ -14,12 +17,24 @@ public:
     std::vector<Object*> objects;
     Light light;
 
+    //owns the patterns of scenes built into this world, copies of the world share it
+    std::shared_ptr<PatternPool> patterns;
+
+    //set by compile(), intersection and shading go through it while it is there
+    std::shared_ptr<FlatScene const> flat;
+
     World();
 
     static World DefaultWorld();
 
+    //flattens `objects` for rendering, call again after changing them
+    void compile(PowMode specular = PowMode::Exact, Acceleration acceleration = Acceleration::BVH);
+
     bool isShadow(Tuple point) const;
 
+    //whether anything blocks `ray` within its (tMin, tMax)
+    bool isShadow(Ray const &ray) const;
+
     //void operator=(World const &other); //copy constructor
 };
 
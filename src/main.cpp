@@ -1,83 +1,148 @@
 ﻿#include <iostream>
-#include <limits>
-
-#define _USE_MATH_DEFINES
-#include <cmath>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <exception>
+#include <cstdio>
 
 #include "Canvas.h"
-#include "Sphere.h"
-#include "Cube.h"
-#include "Plane.h"
-#include "Ray.h"
-#include "Transformations.h"
-#include "World.h"
-#include "Light.h"
+#include "MappedImage.h"
+#include "ToneMap.h"
 #include "Camera.h"
+#include "Scene.h"
+#include "Options.h"
+#include "Farm.h"
+#include "Stats.h"
+#include "Trace.h"
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
 
-#include "Pattern.h"
-#include "Grid.h"
-#include "Stripe.h"
-#include "Gradient.h"
-#include "Solid.h"
+//tone maps 8-bit outputs, float outputs keep the radiance as rendered
+static void writeGraded(Canvas &canvas, Options const &options)
+{
+	if (options.format != ImageFormat::PFM) {
+		toneMap(canvas, options.toneMap);
+	}
+	writeImage(canvas, options.outputPath, options.format);
+}
 
-int main()
+int main(int argc, char** argv)
 {
+	Options options;
+	try {
+		options = parseOptions(argc, argv);
+	} catch (std::exception const &e) {
+		std::cerr << e.what() << "\n\n" << usage(argv[0]);
+		return 2;
+	}
+
+	if (options.help) {
+		std::cout << usage(argv[0]);
+		return 0;
+	}
+
+	try {
+		enableTracing(!options.tracePath.empty());
+		nameTraceThread("main");
+
+		if (!options.merge.empty()) {
+			if (options.width <= 0 || options.height <= 0) {
+				throw std::invalid_argument("--merge needs the frame --width and --height");
+			}
+			Canvas frame(options.width, options.height);
+			for (MergePiece const &piece : options.merge) {
+				pasteCanvas(frame, readImage(piece.path), piece.x, piece.y);
+			}
+			writeGraded(frame, options);
+			return 0;
+		}
+
+		if (!options.gradePath.empty()) {
+			Canvas image = readImage(options.gradePath);
+			writeGraded(image, options);
+			return 0;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		std::unique_ptr<Scene> scene;
+		{
+			TraceSpan span("scene load", "io");
+			scene = options.scenePath.empty() ? Scene::DemoScene() : loadScene(options.scenePath, options.textureMemory);
+		}
+		options.render.sceneHash = scene->hash;
+
+		Camera camera = scene->camera;
+		if (options.width > 0 || options.height > 0) {
+			int hsize = options.width > 0 ? options.width : camera.hsize;
+			int vsize = options.height > 0 ? options.height : camera.vsize;
+			camera = Camera(hsize, vsize, scene->camera.fieldOfView);
+			camera.transform = scene->camera.transform;
+		}
+		double loadTime = millisecondsSince(start);
+
+		if (!options.connectPath.empty()) {
+			runFarmWorker(options.connectPath, scene->world, scene->hash);
+			return 0;
+		}
+
+		double renderTime;
+		double encodeTime;
+		if (options.mapped) {
+			RenderRegion frame = boundingRegion(renderRegions(camera, options.render));
+			MappedImage image(options.outputPath, frame.width, frame.height, options.format);
+			start = std::chrono::steady_clock::now();
+			renderInto(camera, scene->world, options.render, image);
+			renderTime = millisecondsSince(start);
+
+			start = std::chrono::steady_clock::now();
+			image.sync();
+		} else {
+			start = std::chrono::steady_clock::now();
+			Canvas canvas = renderFarm(camera, scene->world, options.render, options.farm);
+			renderTime = millisecondsSince(start);
+
+			start = std::chrono::steady_clock::now();
+			writeGraded(canvas, options);
+		}
+		if (!options.render.checkpointPath.empty()) {
+			std::remove(options.render.checkpointPath.c_str());
+		}
+		encodeTime = millisecondsSince(start);
+
+		RenderStats stats = renderStats();
+
+		if (!options.quiet) {
+			double primaryRays = (double)camera.hsize * camera.vsize * options.render.samples;
+
+			std::cout << std::fixed << std::setprecision(1)
+				<< options.outputPath << ": " << camera.hsize << "x" << camera.vsize
+				<< ", " << options.render.samples << " spp, " << options.render.maxBounces << " bounces\n"
+				<< "  scene load " << std::setw(10) << loadTime << " ms\n"
+				<< "  render     " << std::setw(10) << renderTime << " ms\n"
+				<< "  encode     " << std::setw(10) << encodeTime << " ms\n"
+				<< "  total      " << std::setw(10) << loadTime + renderTime + encodeTime << " ms\n"
+				<< "  primary rays/s " << std::setprecision(0) << primaryRays / (renderTime / 1000.0) << "\n";
+#ifdef RAYTRACER_STATS
+			std::cout << "  total rays/s   " << stats.rays() / (renderTime / 1000.0) << "\n";
+#endif
+		}
+
+		if (!options.tracePath.empty()) {
+			writeTraceFile(options.tracePath);
+		}
+
+		if (options.stats == "table") {
+			writeStatsTable(std::cout, stats);
+		} else if (options.stats == "json") {
+			writeStatsJSON(std::cout, stats);
+		}
+	} catch (std::exception const &e) {
+		std::cerr << "error: " << e.what() << "\n";
+		return 1;
+	}
 
-	//Floor
-	Plane floor;
-	Grid grid = Grid(Color(1.0f, 1.0f, 1.0f), Color(0.0f, 0.0f, 0.0f));
-	floor.material.setPattern(grid);
-	floor.material.diffuse = 0.7f;
-	floor.material.specular = 0.3f;
-	
-	//Sphere1
-	Cube middle;
-	middle.setTransformation(translation(-0.5f, 1.0f, 0.5f));
-	middle.material = Material();
-
-	Grid grid3 = Grid(Color(0.8f, 0.1f, 0.9f), Color(0.1f, 0.7f, 0.5f));
-	Solid solid = Solid(Color(1.0f, 1.0f, 1.0f));
-	middle.material.color = Color(0.5f, 0.4f, 0.4f);
-	middle.material.transparency = 0.8f;
-	middle.material.refractive_index = 1.0105f;
-	middle.material.reflective = 0.75f;
-	middle.material.diffuse = 0.7f;
-	middle.material.specular = 0.3f;
-	middle.material.reflective = 0.8f;
-
-	//Sphere2
-	Sphere right;
-	right.setTransformation(translation(1.5f, 0.5f, -0.5f) * scaling(0.5f, 0.5f, 0.5f));
-	right.material = Material();
-	right.material.color = Color(0.5f, 1.0f, 0.1f);
-	right.material.transparency = 0.85f;
-	right.material.refractive_index = 0.985f;
-	right.material.reflective = 0.5f;
-	right.material.diffuse = 0.7f;
-	right.material.specular = 0.3f;
-	right.material.reflective = 0.5f;
-	
-	//Sphere3
-	Sphere left;
-	left.setTransformation(translation(-1.5f, 0.33f, -0.75f) * scaling(0.33f, 0.33f, 0.33f));
-	left.material = Material();
-	Gradient gradient = Gradient(Color(1.0f, 1.0f, 0.85f), Color(0.8f, 0.15f, 0.55f));
-	gradient.transform = rotation_z(M_PI/8)*scaling(2.25f, 2.25f, 2.25f)*translation(-0.5f, 0.0f, 0.0f);
-	left.material.setPattern(gradient);
-	left.material.color = Color(1.0f, 0.8f, 0.1f);
-	left.material.diffuse = 0.7f;
-	left.material.specular = 0.3f;
-	left.material.reflective = 0.5f;
-
-	World world;
-	world.objects = {&floor, &middle, &right, &left};
-	world.light = Light(Tuple::Point(-10.0f, 10.0f, -10.0f), Color(1.0f, 1.0f, 1.0f));
-
-	Camera camera(1024, 720, M_PI/3.0f);
-	camera.transform = viewTransformation(Tuple::Point(0.0f, 1.5f, -5.0f), Tuple::Point(0.0f, 1.0f, 0.0f), Tuple::Vector(0.0f, 1.0f, 0.0f));
-
-	Canvas canvas = render(camera, world);
-	writeFile(canvas, "test");
-	
 	return 0;
 }
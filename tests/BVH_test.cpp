@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "BVH.h"
+
+static std::vector<Bounds> scatteredBoxes(int count) {
+    std::vector<Bounds> boxes;
+    for (int i = 0; i < count; i++) {
+        Tuple center = Tuple::Point(std::sin(i*1.7f)*10.0f, std::cos(i*0.9f)*3.0f, std::sin(i*0.37f)*10.0f);
+        Tuple size = Tuple::Vector(0.2f + (i % 5)*0.1f, 0.3f, 0.2f + (i % 3)*0.2f);
+        boxes.push_back(Bounds(center - size, center + size));
+    }
+    return boxes;
+};
+
+static bool inside(Bounds const &inner, Bounds const &outer) {
+    return inner.min.x >= outer.min.x && inner.min.y >= outer.min.y && inner.min.z >= outer.min.z &&
+           inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+};
+
+TEST(BVH_test, an_empty_hierarchy_visits_nothing) {
+    BVH bvh;
+    bvh.build({});
+    ASSERT_TRUE(bvh.nodes.empty());
+
+    int visits = 0;
+    float tMax = std::numeric_limits<float>::infinity();
+    bvh.traverse(Ray(Tuple::Point(0, 0, 0), Tuple::Vector(0, 0, 1)), 0.0f, tMax, [&visits](int) { visits++; });
+    ASSERT_EQ(visits, 0);
+}
+
+TEST(BVH_test, every_primitive_is_in_one_leaf_inside_its_parents) {
+    std::vector<Bounds> boxes = scatteredBoxes(200);
+    BVH bvh;
+    bvh.build(boxes);
+
+    std::vector<int> seen(boxes.size(), 0);
+    for (std::vector<BVHNode>::size_type i = 0; i < bvh.nodes.size(); i++) {
+        BVHNode const &node = bvh.nodes[i];
+        if (node.count > 0) {
+            ASSERT_LE(node.count, BVH::leafSize);
+            for (int j = node.first; j < node.first + node.count; j++) {
+                seen[bvh.primitives[j]]++;
+                ASSERT_TRUE(inside(boxes[bvh.primitives[j]], node.bounds));
+            }
+        } else {
+            ASSERT_TRUE(inside(bvh.nodes[i + 1].bounds, node.bounds));
+            ASSERT_TRUE(inside(bvh.nodes[node.first].bounds, node.bounds));
+        }
+    }
+    for (int count : seen) {
+        ASSERT_EQ(count, 1);
+    }
+}
+
+TEST(BVH_test, traversal_visits_every_box_the_ray_passes_through) {
+    std::vector<Bounds> boxes = scatteredBoxes(300);
+    BVH bvh;
+    bvh.build(boxes);
+
+    float const infinity = std::numeric_limits<float>::infinity();
+    for (int i = 0; i < 100; i++) {
+        Tuple origin = Tuple::Point(-15.0f + i*0.3f, std::sin(i*0.1f), -15.0f);
+        Tuple target = Tuple::Point(std::cos(i*0.7f)*8.0f, std::sin(i*0.5f)*2.0f, 8.0f);
+        Ray ray(origin, normalize(target - origin));
+
+        std::vector<int> visited;
+        bvh.traverse(ray, -infinity, infinity, [&visited](int primitive) { visited.push_back(primitive); });
+
+        for (std::vector<Bounds>::size_type j = 0; j < boxes.size(); j++) {
+            float tmin, tmax;
+            if (slabIntersect(boxes[j], ray, tmin, tmax)) {
+                ASSERT_NE(std::find(visited.begin(), visited.end(), (int)j), visited.end());
+            }
+        }
+        std::sort(visited.begin(), visited.end());
+        ASSERT_EQ(std::adjacent_find(visited.begin(), visited.end()), visited.end());
+    }
+}
+
+TEST(BVH_test, shrinking_tmax_skips_boxes_behind_the_nearest) {
+    //a row of boxes along z, the ray runs down the row
+    std::vector<Bounds> boxes;
+    for (int i = 0; i < 64; i++) {
+        boxes.push_back(Bounds(Tuple::Point(-0.5f, -0.5f, i*2.0f), Tuple::Point(0.5f, 0.5f, i*2.0f + 1.0f)));
+    }
+    BVH bvh;
+    bvh.build(boxes);
+
+    Ray ray(Tuple::Point(0.0f, 0.0f, -1.0f), Tuple::Vector(0.0f, 0.0f, 1.0f));
+    float nearest = std::numeric_limits<float>::infinity();
+    int visits = 0;
+    bvh.traverse(ray, 0.0f, nearest, [&](int primitive) {
+        visits++;
+        nearest = std::min(nearest, boxes[primitive].min.z + 1.0f);
+    });
+    ASSERT_EQ(nearest, 1.0f);
+    ASSERT_LE(visits, BVH::leafSize);
+}
+
+TEST(BVH_test, flat_boxes_are_still_hit) {
+    std::vector<Bounds> boxes = {Bounds(Tuple::Point(-1.0f, 0.0f, -1.0f), Tuple::Point(1.0f, 0.0f, 1.0f))};
+    BVH bvh;
+    bvh.build(boxes);
+
+    int visits = 0;
+    float tMax = std::numeric_limits<float>::infinity();
+    bvh.traverse(Ray(Tuple::Point(0.2f, 2.0f, 0.3f), Tuple::Vector(0.0f, -1.0f, 0.0f)), 0.0f, tMax, [&visits](int) { visits++; });
+    ASSERT_EQ(visits, 1);
+}
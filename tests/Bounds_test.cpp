@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "Bounds.h"
+#include "Transformations.h"
+#include "Sphere.h"
+#include "Plane.h"
+#include "Cube.h"
+
+TEST(Bounds_test, an_empty_box_grows_to_what_is_added) {
+    Bounds box;
+    ASSERT_TRUE(box.empty());
+
+    box.add(Tuple::Point(-5.0f, 2.0f, 0.0f));
+    box.add(Tuple::Point(7.0f, 0.0f, -3.0f));
+    ASSERT_FALSE(box.empty());
+    ASSERT_EQ(box.min, Tuple::Point(-5.0f, 0.0f, -3.0f));
+    ASSERT_EQ(box.max, Tuple::Point(7.0f, 2.0f, 0.0f));
+
+    Bounds other(Tuple::Point(8.0f, -7.0f, -2.0f), Tuple::Point(14.0f, 4.0f, 8.0f));
+    box.add(other);
+    ASSERT_EQ(box.min, Tuple::Point(-5.0f, -7.0f, -3.0f));
+    ASSERT_EQ(box.max, Tuple::Point(14.0f, 4.0f, 8.0f));
+}
+
+TEST(Bounds_test, transforming_a_box) {
+    Bounds box(Tuple::Point(-1.0f, -1.0f, -1.0f), Tuple::Point(1.0f, 1.0f, 1.0f));
+    Bounds moved = box.transform(translation(1.0f, 2.0f, 3.0f) * scaling(2.0f, 1.0f, 1.0f));
+    ASSERT_EQ(moved.min, Tuple::Point(-1.0f, 1.0f, 2.0f));
+    ASSERT_EQ(moved.max, Tuple::Point(3.0f, 3.0f, 4.0f));
+
+    Bounds rotated = box.transform(rotation_y(M_PI/4.0f));
+    ASSERT_NEAR(rotated.max.x, std::sqrt(2.0f), 1e-5f);
+    ASSERT_NEAR(rotated.min.z, -std::sqrt(2.0f), 1e-5f);
+
+    ASSERT_FALSE(Bounds::Infinite().transform(translation(1.0f, 0.0f, 0.0f)).finite());
+}
+
+TEST(Bounds_test, shapes_report_their_bounds) {
+    Sphere sphere;
+    sphere.setTransformation(translation(0.0f, 0.0f, 5.0f));
+    ASSERT_EQ(sphere.worldBounds().min, Tuple::Point(-1.0f, -1.0f, 4.0f));
+    ASSERT_EQ(sphere.worldBounds().max, Tuple::Point(1.0f, 1.0f, 6.0f));
+
+    Cube cube;
+    ASSERT_EQ(cube.bounds().max, Tuple::Point(1.0f, 1.0f, 1.0f));
+
+    Plane plane;
+    ASSERT_FALSE(plane.bounds().finite());
+    ASSERT_EQ(plane.bounds().min.y, 0.0f);
+    ASSERT_EQ(plane.bounds().max.y, 0.0f);
+}
+
+TEST(Bounds_test, slab_test_hits_and_misses) {
+    Bounds box(Tuple::Point(5.0f, -2.0f, 0.0f), Tuple::Point(11.0f, 4.0f, 7.0f));
+    float tmin, tmax;
+
+    //through the middle along +x
+    ASSERT_TRUE(slabIntersect(box, Tuple::Point(2.0f, 1.0f, 3.0f), reciprocal(Tuple::Vector(1.0f, 0.0f, 0.0f)), tmin, tmax));
+    ASSERT_EQ(tmin, 3.0f);
+    ASSERT_EQ(tmax, 9.0f);
+
+    //from inside the box tmin is behind the origin
+    ASSERT_TRUE(slabIntersect(box, Tuple::Point(8.0f, 1.0f, 3.0f), reciprocal(Tuple::Vector(0.0f, -1.0f, 0.0f)), tmin, tmax));
+    ASSERT_EQ(tmin, -3.0f);
+    ASSERT_EQ(tmax, 3.0f);
+
+    //parallel to a slab and outside it
+    ASSERT_FALSE(slabIntersect(box, Tuple::Point(2.0f, 5.0f, 3.0f), reciprocal(Tuple::Vector(1.0f, 0.0f, 0.0f)), tmin, tmax));
+
+    //diagonal that passes the corner
+    Tuple direction = normalize(Tuple::Vector(1.0f, 1.0f, 0.0f));
+    ASSERT_FALSE(slabIntersect(box, Tuple::Point(-5.0f, 1.0f, 3.0f), reciprocal(direction), tmin, tmax));
+
+    //unbounded axes never clip
+    Bounds slab(Tuple::Point(-INFINITY, 0.0f, -INFINITY), Tuple::Point(INFINITY, 1.0f, INFINITY));
+    ASSERT_TRUE(slabIntersect(slab, Tuple::Point(0.0f, 2.0f, 0.0f), reciprocal(Tuple::Vector(0.0f, -1.0f, 0.0f)), tmin, tmax));
+    ASSERT_EQ(tmin, 1.0f);
+    ASSERT_EQ(tmax, 2.0f);
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "CSG.h"
+#include "Sphere.h"
+#include "Cube.h"
+#include "Ray.h"
+#include "Transformations.h"
+
+//counts localIntersects calls, to see which children the bounds let through
+class CountingSphere : public Sphere {
+public:
+    int calls = 0;
+
+    std::vector<Intersection> localIntersects(Ray const &ray) override {
+        calls++;
+        return Sphere::localIntersects(ray);
+    };
+};
+
+TEST(CSG_test, csg_is_created_with_an_operation_and_two_shapes) {
+    Sphere sphere;
+    Cube cube;
+    CSG csg(CSGOperation::Union, sphere, cube);
+
+    ASSERT_EQ(csg.operation, CSGOperation::Union);
+    ASSERT_EQ(csg.left, &sphere);
+    ASSERT_EQ(csg.right, &cube);
+    ASSERT_EQ(sphere.parent, &csg);
+    ASSERT_EQ(cube.parent, &csg);
+}
+
+TEST(CSG_test, evaluating_the_rule_for_a_csg_operation) {
+    //leftHit, inLeft, inRight for each row, then union, intersection and difference
+    bool rows[8][6] = {
+        {true,  true,  true,  false, true,  false},
+        {true,  true,  false, true,  false, true},
+        {true,  false, true,  false, true,  false},
+        {true,  false, false, true,  false, true},
+        {false, true,  true,  false, true,  true},
+        {false, true,  false, false, true,  true},
+        {false, false, true,  true,  false, false},
+        {false, false, false, true,  false, false},
+    };
+    CSGOperation operations[3] = {CSGOperation::Union, CSGOperation::Intersection, CSGOperation::Difference};
+
+    for (auto const &row : rows) {
+        for (int op = 0; op < 3; op++) {
+            ASSERT_EQ(CSG::allowed(operations[op], row[0], row[1], row[2]), row[3 + op]);
+        }
+    }
+}
+
+TEST(CSG_test, filtering_a_list_of_intersections) {
+    Sphere sphere;
+    Cube cube;
+    CSGOperation operations[3] = {CSGOperation::Union, CSGOperation::Intersection, CSGOperation::Difference};
+    int first[3] = {0, 1, 0};
+    int second[3] = {3, 2, 1};
+
+    for (int op = 0; op < 3; op++) {
+        CSG csg(operations[op], sphere, cube);
+        std::vector<Intersection> all = {Intersection(sphere, 1.0f), Intersection(cube, 2.0f),
+                                         Intersection(sphere, 3.0f), Intersection(cube, 4.0f)};
+        std::vector<Intersection> result = all;
+        csg.filter(result);
+
+        ASSERT_EQ(result.size(), 2);
+        ASSERT_TRUE(result[0] == all[first[op]]);
+        ASSERT_TRUE(result[1] == all[second[op]]);
+    }
+}
+
+TEST(CSG_test, a_ray_misses_a_csg_object) {
+    Sphere sphere;
+    Cube cube;
+    CSG csg(CSGOperation::Union, sphere, cube);
+    Ray ray(Tuple::Point(0.0f, 2.0f, -5.0f), Tuple::Vector(0.0f, 0.0f, 1.0f));
+    ASSERT_TRUE(csg.localIntersects(ray).empty());
+}
+
+TEST(CSG_test, a_ray_hits_a_csg_object) {
+    Sphere s1;
+    Sphere s2;
+    s2.setTransformation(translation(0.0f, 0.0f, 0.5f));
+    CSG csg(CSGOperation::Union, s1, s2);
+    Ray ray(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Vector(0.0f, 0.0f, 1.0f));
+
+    std::vector<Intersection> intersections = csg.localIntersects(ray);
+    ASSERT_EQ(intersections.size(), 2);
+    ASSERT_EQ(intersections[0].t, 4.0f);
+    ASSERT_EQ(intersections[0].object, &s1);
+    ASSERT_EQ(intersections[1].t, 6.5f);
+    ASSERT_EQ(intersections[1].object, &s2);
+}
+
+TEST(CSG_test, children_outside_the_ray_are_culled_by_their_bounds) {
+    CountingSphere near;
+    CountingSphere far;
+    far.setTransformation(translation(5.0f, 0.0f, 0.0f));
+    CSG csg(CSGOperation::Union, near, far);
+    csg.update();
+
+    Ray ray(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Vector(0.0f, 0.0f, 1.0f));
+    ASSERT_EQ(csg.localIntersects(ray).size(), 2);
+    ASSERT_EQ(near.calls, 1);
+    ASSERT_EQ(far.calls, 0);
+
+    //missing the left side of a difference ends the test before the right side
+    CountingSphere cut;
+    CountingSphere hole;
+    CSG difference(CSGOperation::Difference, cut, hole);
+    Ray past(Tuple::Point(0.0f, 3.0f, -5.0f), Tuple::Vector(0.0f, 0.0f, 1.0f));
+    ASSERT_TRUE(difference.localIntersects(past).empty());
+    ASSERT_EQ(hole.calls, 0);
+}
+
+TEST(CSG_test, nested_nodes_fill_the_callers_vector) {
+    Sphere a, b, c;
+    b.setTransformation(translation(0.0f, 0.0f, 0.5f));
+    c.setTransformation(translation(0.0f, 0.0f, 1.5f) * scaling(0.5f, 0.5f, 0.5f));
+    CSG inner(CSGOperation::Union, a, b);
+    CSG outer(CSGOperation::Difference, inner, c);
+    Ray ray(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Vector(0.0f, 0.0f, 1.0f));
+
+    //what is already there stays, the node appends its own sorted hits after it
+    Sphere before;
+    std::vector<Intersection> intersections = {Intersection(before, 9.0f)};
+    outer.intersect(ray, intersections);
+    ASSERT_EQ(intersections.size(), 3);
+    ASSERT_EQ(intersections[0].object, &before);
+    ASSERT_EQ(intersections[1].t, 4.0f);
+    ASSERT_EQ(intersections[1].object, &a);
+    ASSERT_EQ(intersections[2].t, 6.0f);
+    ASSERT_EQ(intersections[2].object, &c);
+    ASSERT_EQ(outer.localIntersects(ray).size(), 2);
+}
+
+TEST(CSG_test, moving_a_child_updates_every_ancestor) {
+    Sphere a, b, c;
+    CSG inner(CSGOperation::Union, a, b);
+    CSG outer(CSGOperation::Union, inner, c);
+    c.setTransformation(translation(10.0f, 0.0f, 0.0f));
+
+    //b moves after both nodes cached their children, into the ray's path and out of the old bounds
+    b.setTransformation(translation(0.0f, 5.0f, 0.0f));
+    Ray ray(Tuple::Point(0.0f, 5.0f, -5.0f), Tuple::Vector(0.0f, 0.0f, 1.0f));
+    std::vector<Intersection> intersections = outer.localIntersects(ray);
+    ASSERT_EQ(intersections.size(), 2);
+    ASSERT_EQ(intersections[0].object, &b);
+    ASSERT_EQ(intersections[0].t, 4.0f);
+
+    //and the shape it used to be at no longer answers
+    Ray old(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Vector(0.0f, 0.0f, 1.0f));
+    ASSERT_EQ(outer.localIntersects(old)[0].object, &a);
+}
+
+TEST(CSG_test, nested_children_are_included_in_their_ancestors) {
+    Sphere a, b, c;
+    CSG inner(CSGOperation::Union, a, b);
+    CSG outer(CSGOperation::Difference, inner, c);
+
+    ASSERT_TRUE(includes(&outer, &a));
+    ASSERT_TRUE(includes(&inner, &b));
+    ASSERT_FALSE(includes(&inner, &c));
+    ASSERT_TRUE(includes(&c, &c));
+}
+
+TEST(CSG_test, normals_of_children_go_through_the_parent_transforms) {
+    Sphere sphere;
+    sphere.setTransformation(translation(5.0f, 0.0f, 0.0f));
+    Cube cube;
+    CSG csg(CSGOperation::Union, sphere, cube);
+    csg.setTransformation(rotation_y(M_PI/2) * scaling(2.0f, 2.0f, 2.0f));
+    ASSERT_TRUE(sphere.worldToObject(Tuple::Point(-2.0f, 0.0f, -10.0f)) == Tuple::Point(0.0f, 0.0f, -1.0f));
+
+    csg.setTransformation(rotation_y(M_PI/2) * scaling(1.0f, 2.0f, 3.0f));
+    Tuple normal = sphere.normalToWorld(Tuple::Vector(std::sqrt(3.0f)/3, std::sqrt(3.0f)/3, std::sqrt(3.0f)/3));
+    ASSERT_TRUE(normal == Tuple::Vector(0.2857f, 0.4286f, -0.8571f));
+}
+
+TEST(CSG_test, bounds_contain_the_children_that_can_be_kept) {
+    Sphere sphere;
+    Cube cube;
+    cube.setTransformation(translation(3.0f, 0.0f, 0.0f));
+
+    CSG csgUnion(CSGOperation::Union, sphere, cube);
+    ASSERT_TRUE(csgUnion.bounds().min == Tuple::Point(-1.0f, -1.0f, -1.0f));
+    ASSERT_TRUE(csgUnion.bounds().max == Tuple::Point(4.0f, 1.0f, 1.0f));
+
+    CSG csgDifference(CSGOperation::Difference, sphere, cube);
+    ASSERT_TRUE(csgDifference.bounds().max == Tuple::Point(1.0f, 1.0f, 1.0f));
+}
@@ -71,4 +71,84 @@ TEST(Camera_test, render_a_default_world_with_a_camera) {
     Color result = image.pixelAt(5, 5);
     Color expectedColor(0.38066f, 0.47583f, 0.2855f);
     ASSERT_TRUE(image.pixelAt(5, 5) == expectedColor);
-}
\ No newline at end of file
+}
+
+TEST(Camera_test, threaded_tiled_render_matches_single_thread) {
+    World world = World::DefaultWorld();
+    Camera camera(23, 17, M_PI/2);
+    camera.transform = viewTransformation(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Point(0.0f, 0.0f, 0.0f), Tuple::Vector(0.0f, 1.0f, 0.0f));
+
+    Canvas single = render(camera, world, RenderSettings(1, 1, 3, 64));
+    Canvas tiled = render(camera, world, RenderSettings(4, 1, 3, 5));
+
+    for (int y = 0; y < camera.vsize; y++) {
+        for (int x = 0; x < camera.hsize; x++) {
+            ASSERT_TRUE(single.pixelAt(x, y) == tiled.pixelAt(x, y));
+        }
+    }
+}
+
+TEST(Camera_test, sample_offsets_stay_inside_the_pixel) {
+    float offsetX, offsetY;
+    sampleOffset(0, 1, offsetX, offsetY);
+    ASSERT_EQ(offsetX, 0.5f);
+    ASSERT_EQ(offsetY, 0.5f);
+
+    for (int i = 0; i < 16; i++) {
+        sampleOffset(i, 16, offsetX, offsetY);
+        ASSERT_TRUE(offsetX >= 0.0f && offsetX < 1.0f);
+        ASSERT_TRUE(offsetY >= 0.0f && offsetY < 1.0f);
+    }
+}
+
+TEST(Camera_test, makeTiles_splits_regions_without_crossing_them) {
+    std::vector<RenderRegion> tiles = makeTiles({RenderRegion(0, 0, 5, 3), RenderRegion(10, 10, 2, 2)}, 4);
+
+    ASSERT_EQ(tiles.size(), 3);
+    ASSERT_TRUE(tiles[0] == RenderRegion(0, 0, 4, 3));
+    ASSERT_TRUE(tiles[1] == RenderRegion(4, 0, 1, 3));
+    ASSERT_TRUE(tiles[2] == RenderRegion(10, 10, 2, 2));
+}
+
+TEST(Camera_test, rendered_crop_windows_merge_into_the_full_frame) {
+    World world = World::DefaultWorld();
+    Camera camera(11, 11, M_PI/2);
+    camera.transform = viewTransformation(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Point(0.0f, 0.0f, 0.0f), Tuple::Vector(0.0f, 1.0f, 0.0f));
+
+    Canvas full = render(camera, world, RenderSettings(1));
+
+    RenderSettings top(2, 1, 3, 4);
+    top.regions = {RenderRegion(0, 0, 11, 6)};
+    RenderSettings bottom(2, 1, 3, 4);
+    bottom.regions = {RenderRegion(0, 6, 11, 5)};
+
+    Canvas topBand = render(camera, world, top);
+    Canvas bottomBand = render(camera, world, bottom);
+    ASSERT_EQ(topBand.height, 6);
+    ASSERT_EQ(bottomBand.height, 5);
+
+    Canvas merged(11, 11);
+    pasteCanvas(merged, topBand, 0, 0);
+    pasteCanvas(merged, bottomBand, 0, 6);
+
+    for (int y = 0; y < 11; y++) {
+        for (int x = 0; x < 11; x++) {
+            ASSERT_TRUE(merged.pixelAt(x, y) == full.pixelAt(x, y));
+        }
+    }
+}
+
+TEST(Camera_test, bucket_list_renders_into_its_bounding_box) {
+    World world = World::DefaultWorld();
+    Camera camera(11, 11, M_PI/2);
+    camera.transform = viewTransformation(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Point(0.0f, 0.0f, 0.0f), Tuple::Vector(0.0f, 1.0f, 0.0f));
+
+    RenderSettings settings(1);
+    settings.regions = {RenderRegion(4, 4, 1, 1), RenderRegion(6, 5, 1, 1), RenderRegion(20, 20, 5, 5)};
+    Canvas buckets = render(camera, world, settings);
+
+    ASSERT_EQ(buckets.width, 3);
+    ASSERT_EQ(buckets.height, 2);
+    ASSERT_TRUE(buckets.pixelAt(0, 0) == render(camera, world).pixelAt(4, 4));
+    ASSERT_TRUE(buckets.pixelAt(1, 0) == Color());
+}
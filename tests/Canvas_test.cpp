@@ -1,4 +1,8 @@
 #include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
 #include <sstream>
 #include <string>
 #include <iostream>
@@ -105,3 +109,151 @@ TEST(Canvas_test, PPM_lines_are_splitted_if_longer_than_70_characters) {
     ASSERT_EQ(line, "153 255 204 153 255 204 153 255 204 153 255 204 153");
 
 }
+
+TEST(Canvas_test, readPPM_reads_back_plain_and_binary_images) {
+    Canvas canvas{3, 2};
+    canvas.writePixel(0, 0, Color(1.0f, 0.0f, 0.0f));
+    canvas.writePixel(2, 1, Color(0.0f, 0.2f, 1.0f));
+
+    std::stringstream plain = canvasToPPM(canvas);
+    Canvas fromPlain = readPPM(plain);
+
+    std::stringstream binary;
+    writeBinaryPPM(binary, canvas);
+    Canvas fromBinary = readPPM(binary);
+
+    ASSERT_EQ(fromPlain.width, 3);
+    ASSERT_EQ(fromPlain.height, 2);
+    ASSERT_TRUE(fromPlain.pixelAt(0, 0) == Color(1.0f, 0.0f, 0.0f));
+    ASSERT_TRUE(fromPlain.pixelAt(2, 1) == Color(0.0f, 51.0f/255.0f, 1.0f));
+    ASSERT_TRUE(fromBinary.pixelAt(2, 1) == fromPlain.pixelAt(2, 1));
+}
+
+TEST(Canvas_test, image_sizes_are_checked_before_allocating) {
+    //past the limits, or overflowing width*height
+    std::stringstream huge("P6\n100000 10\n255\n");
+    ASSERT_THROW(readPPM(huge), std::runtime_error);
+    std::stringstream overflow("PF\n65536 65536\n-1.0\n");
+    ASSERT_THROW(readPFM(overflow), std::runtime_error);
+
+    //a size within the limits that the data after the header cannot hold
+    std::stringstream shortBinary("P6\n4000 4000\n255\n" + std::string(30, '\0'));
+    ASSERT_THROW(readPPM(shortBinary), std::runtime_error);
+    std::stringstream shortFloat("PF\n2 2\n-1.0\n" + std::string(40, '\0'));
+    ASSERT_THROW(readPFM(shortFloat), std::runtime_error);
+    std::stringstream shortPlain("P3\n3000 3000\n255\n0 0 0\n");
+    ASSERT_THROW(readPPM(shortPlain), std::runtime_error);
+
+    std::stringstream exact("PF\n2 2\n-1.0\n" + std::string(48, '\0'));
+    ASSERT_EQ(readPFM(exact).width, 2);
+}
+
+TEST(Canvas_test, writePFM_stores_float_rows_bottom_to_top) {
+    Canvas canvas{2, 2};
+    canvas.writePixel(0, 0, Color(1.5f, 0.0f, 0.25f));
+
+    std::stringstream out;
+    writePFM(out, canvas);
+    std::string data = out.str();
+
+    std::string header = "PF\n2 2\n-1.0\n";
+    ASSERT_EQ(data.size(), header.size() + 2*2*3*sizeof(float));
+    ASSERT_EQ(data.substr(0, header.size()), header);
+
+    //pixel (0, 0) is the first pixel of the last stored row
+    float pixel[3];
+    std::memcpy(pixel, data.data() + header.size() + 2*3*sizeof(float), sizeof(pixel));
+    ASSERT_FLOAT_EQ(pixel[0], 1.5f);
+    ASSERT_FLOAT_EQ(pixel[1], 0.0f);
+    ASSERT_FLOAT_EQ(pixel[2], 0.25f);
+}
+
+TEST(Canvas_test, readPFM_reads_back_unclamped_values) {
+    Canvas canvas{3, 2};
+    canvas.writePixel(0, 0, Color(12.5f, -0.25f, 0.0f));
+    canvas.writePixel(2, 1, Color(0.0f, 0.2f, 1.0f));
+
+    std::stringstream pfm;
+    writePFM(pfm, canvas);
+    Canvas read = readPFM(pfm);
+
+    ASSERT_EQ(read.width, 3);
+    ASSERT_EQ(read.height, 2);
+    ASSERT_TRUE(read.pixelAt(0, 0) == Color(12.5f, -0.25f, 0.0f));
+    ASSERT_TRUE(read.pixelAt(2, 1) == Color(0.0f, 0.2f, 1.0f));
+}
+
+TEST(Canvas_test, ImageRows_reads_rows_top_to_bottom) {
+    Canvas canvas{5, 3};
+    for (int y = 0; y < canvas.height; y++) {
+        for (int x = 0; x < canvas.width; x++) {
+            canvas.writePixel(x, y, Color(x / 4.0f, y / 2.0f, 0.5f));
+        }
+    }
+
+    for (ImageFormat format : {ImageFormat::PPM, ImageFormat::PPMBinary, ImageFormat::PFM}) {
+        std::string path = ::testing::TempDir() + "image_rows_test" + imageFormatExtension(format);
+        writeImage(canvas, path, format);
+        Canvas whole = readImage(path);
+        ImageRows rows(path);
+        ASSERT_EQ(rows.width, 5);
+        ASSERT_EQ(rows.height, 3);
+
+        std::vector<float> row(5*3), expected(5*3);
+        for (int y = 0; y < rows.height; y++) {
+            rows.readRow(row.data());
+            whole.readRow(y, expected.data());
+            ASSERT_EQ(row, expected);
+        }
+        ASSERT_THROW(rows.readRow(row.data()), std::runtime_error);
+        std::remove(path.c_str());
+    }
+}
+
+TEST(Canvas_test, tiled_layout_behaves_like_row_major) {
+    Canvas rows{19, 10};
+    Canvas tiles{19, 10, CanvasLayout::Tiled};
+    for (int y = 0; y < 10; y++) {
+        for (int x = 0; x < 19; x++) {
+            rows.writePixel(x, y, Color(x, y, x*y));
+            tiles.writePixel(x, y, Color(x, y, x*y));
+        }
+    }
+
+    //padded to 3x2 tiles of 8x8
+    ASSERT_EQ(tiles.channelCount(), 24u*16*3);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(tiles.pixels) % 64, 0u);
+    ASSERT_TRUE(tiles.pixelAt(18, 9) == Color(18.0f, 9.0f, 162.0f));
+
+    std::vector<float> fromRows(19*3), fromTiles(19*3);
+    rows.readRow(9, fromRows.data());
+    tiles.readRow(9, fromTiles.data());
+    ASSERT_TRUE(fromRows == fromTiles);
+
+    tiles.writeRow(0, fromRows.data());
+    ASSERT_TRUE(tiles.pixelAt(12, 0) == Color(12.0f, 9.0f, 108.0f));
+
+    std::stringstream a, b;
+    writePFM(a, rows);
+    writeBinaryPPM(b, rows);
+    Canvas tiled{19, 10, CanvasLayout::Tiled};
+    pasteCanvas(tiled, rows, 0, 0);
+    std::stringstream c, d;
+    writePFM(c, tiled);
+    writeBinaryPPM(d, tiled);
+    ASSERT_EQ(a.str(), c.str());
+    ASSERT_EQ(b.str(), d.str());
+}
+
+TEST(Canvas_test, pasteCanvas_clips_to_the_target) {
+    Canvas frame{4, 4};
+    Canvas piece{3, 3};
+    Color red(1.0f, 0.0f, 0.0f);
+    piece.fill(red);
+
+    pasteCanvas(frame, piece, 2, 2);
+
+    ASSERT_TRUE(frame.pixelAt(1, 1) == Color());
+    ASSERT_TRUE(frame.pixelAt(2, 2) == red);
+    ASSERT_TRUE(frame.pixelAt(3, 3) == red);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "Checkpoint.h"
+#include "Camera.h"
+#include "World.h"
+#include "Stats.h"
+#include "Transformations.h"
+
+class Checkpoint_test: public ::testing::Test { 
+public: 
+    World world = World::DefaultWorld();
+    Camera camera = Camera(11, 11, M_PI/2);
+    std::string path = ::testing::TempDir() + "checkpoint_test.ckpt";
+
+    void SetUp() override {
+        camera.transform = viewTransformation(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Point(0.0f, 0.0f, 0.0f), Tuple::Vector(0.0f, 1.0f, 0.0f));
+        std::remove(path.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+};
+
+TEST_F(Checkpoint_test, render_appends_every_finished_tile) {
+    RenderSettings settings(2, 1, 3, 4);
+    settings.checkpointPath = path;
+    Canvas image = render(camera, world, settings);
+
+    CheckpointHeader header(camera, RenderRegion(0, 0, 11, 11), settings);
+    std::vector<CheckpointTile> tiles = loadCheckpoint(path, header);
+    ASSERT_EQ(tiles.size(), 9);
+
+    Canvas restored(11, 11);
+    for (CheckpointTile const &tile : tiles) {
+        ASSERT_EQ(tile.samples, 1);
+        restoreTile(tile, restored, 0, 0);
+    }
+    for (int y = 0; y < 11; y++) {
+        for (int x = 0; x < 11; x++) {
+            ASSERT_TRUE(restored.pixelAt(x, y) == image.pixelAt(x, y));
+        }
+    }
+}
+
+TEST_F(Checkpoint_test, resume_skips_checkpointed_tiles) {
+    RenderSettings settings(1, 1, 3, 4);
+    settings.checkpointPath = path;
+    settings.resume = true;
+    CheckpointHeader header(camera, RenderRegion(0, 0, 11, 11), settings);
+
+    Color red(1.0f, 0.0f, 0.0f);
+    Canvas done(11, 11);
+    done.fill(red);
+    {
+        CheckpointWriter writer(path, header, false);
+        writer.push(RenderRegion(4, 0, 4, 4), 1, done, 0, 0);
+    }
+
+    Canvas image = render(camera, world, settings);
+
+    ASSERT_TRUE(image.pixelAt(4, 0) == red);
+    ASSERT_TRUE(image.pixelAt(7, 3) == red);
+    ASSERT_FALSE(image.pixelAt(5, 5) == red);
+#ifdef RAYTRACER_STATS
+    ASSERT_EQ(renderStats()[Counter::PrimaryRays], 11*11 - 16);
+#endif
+    ASSERT_EQ(loadCheckpoint(path, header).size(), 9);
+}
+
+TEST_F(Checkpoint_test, torn_record_is_dropped) {
+    RenderSettings settings(1, 1, 3, 4);
+    CheckpointHeader header(camera, RenderRegion(0, 0, 11, 11), settings);
+    Canvas done(11, 11);
+    {
+        CheckpointWriter writer(path, header, false);
+        writer.push(RenderRegion(0, 0, 4, 4), 1, done, 0, 0);
+    }
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file << "partial";
+    }
+    ASSERT_EQ(loadCheckpoint(path, header).size(), 1);
+
+    {
+        CheckpointWriter writer(path, header, true);
+        writer.push(RenderRegion(4, 0, 4, 4), 1, done, 0, 0);
+    }
+    ASSERT_EQ(loadCheckpoint(path, header).size(), 2);
+}
+
+TEST_F(Checkpoint_test, write_errors_reach_the_caller) {
+    //every write to /dev/full fails with no space left
+    RenderSettings settings(1, 1, 3, 4);
+    settings.checkpointPath = "/dev/full";
+    ASSERT_THROW(CheckpointWriter("/dev/full", CheckpointHeader(camera, RenderRegion(0, 0, 11, 11), settings), false), std::runtime_error);
+    ASSERT_THROW(render(camera, world, settings), std::runtime_error);
+}
+
+TEST_F(Checkpoint_test, checkpoint_of_another_render_is_rejected) {
+    RenderSettings settings(1, 1, 3, 4);
+    { 
+        CheckpointWriter writer(path, CheckpointHeader(camera, RenderRegion(0, 0, 11, 11), settings), false);
+    }
+
+    RenderSettings moreSamples(1, 4, 3, 4);
+    ASSERT_THROW(loadCheckpoint(path, CheckpointHeader(camera, RenderRegion(0, 0, 11, 11), moreSamples)), std::runtime_error);
+}
+
+TEST_F(Checkpoint_test, checkpoint_of_another_view_or_scene_is_rejected) {
+    RenderSettings settings(1, 1, 3, 4);
+    settings.sceneHash = 42;
+    {
+        CheckpointWriter writer(path, CheckpointHeader(camera, RenderRegion(0, 0, 11, 11), settings), false);
+    }
+    ASSERT_TRUE(loadCheckpoint(path, CheckpointHeader(camera, RenderRegion(0, 0, 11, 11), settings)).empty());
+
+    Camera wider(11, 11, M_PI/3);
+    wider.transform = camera.transform;
+    ASSERT_THROW(loadCheckpoint(path, CheckpointHeader(wider, RenderRegion(0, 0, 11, 11), settings)), std::runtime_error);
+
+    Camera moved = camera;
+    moved.transform = translation(0.0f, 1.0f, 0.0f) * camera.transform;
+    ASSERT_THROW(loadCheckpoint(path, CheckpointHeader(moved, RenderRegion(0, 0, 11, 11), settings)), std::runtime_error);
+
+    RenderSettings otherScene = settings;
+    otherScene.sceneHash = 43;
+    ASSERT_THROW(loadCheckpoint(path, CheckpointHeader(camera, RenderRegion(0, 0, 11, 11), otherScene)), std::runtime_error);
+
+    RenderSettings otherSpecular = settings;
+    otherSpecular.specular = PowMode::Approximate;
+    ASSERT_THROW(loadCheckpoint(path, CheckpointHeader(camera, RenderRegion(0, 0, 11, 11), otherSpecular)), std::runtime_error);
+}
@@ -223,4 +223,27 @@ TEST(Comptatuion_test, shlick_approximation_with_small_angle_and_n2_greater_than
 
     ASSERT_TRUE((reflectance - 0.48873f) < EPSILON && (reflectance - 0.48873f) > -EPSILON);
 
-}
\ No newline at end of file
+}
+TEST(Computation_test, shading_skips_what_the_material_does_not_use) {
+    Ray ray(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Vector(0.0f, 0.0f, 1.0f));
+
+    Sphere opaque;
+    std::vector<Intersection> intersections = {Intersection(opaque, 4.0f), Intersection(opaque, 6.0f)};
+    Computation comp = prepareShading(intersections[0], ray, intersections);
+
+    ASSERT_TRUE(comp.normal == Tuple::Vector(0.0f, 0.0f, -1.0f));
+    ASSERT_TRUE(comp.reflectv == Tuple::Vector(0.0f, 0.0f, 0.0f));
+    ASSERT_EQ(comp.n1, 1.0f);
+    ASSERT_EQ(comp.n2, 1.0f);
+
+    Sphere glass = Sphere::GlassSphere();
+    glass.material.reflective = 0.5f;
+    intersections = {Intersection(glass, 4.0f), Intersection(glass, 6.0f)};
+    comp = prepareShading(intersections[0], ray, intersections);
+    Computation full = prepareComputation(intersections[0], ray, intersections);
+
+    ASSERT_TRUE(comp.reflectv == full.reflectv);
+    ASSERT_TRUE(comp.underPoint == full.underPoint);
+    ASSERT_EQ(comp.n1, 1.0f);
+    ASSERT_EQ(comp.n2, 1.5f);
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "Cone.h"
+#include "Ray.h"
+#include "Tuple.h"
+
+TEST(Cone_test, intersecting_a_cone_with_a_ray) {
+    Cone cone;
+    Tuple origins[3] = {Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Point(1.0f, 1.0f, -5.0f)};
+    Tuple directions[3] = {Tuple::Vector(0.0f, 0.0f, 1.0f), Tuple::Vector(1.0f, 1.0f, 1.0f), Tuple::Vector(-0.5f, -1.0f, 1.0f)};
+    float t0[3] = {5.0f, 8.66025f, 4.55006f};
+    float t1[3] = {5.0f, 8.66025f, 49.44994f};
+
+    for (int i = 0; i < 3; i++) {
+        Ray ray(origins[i], normalize(directions[i]));
+        std::vector<Intersection> intersections = cone.localIntersects(ray);
+        ASSERT_EQ(intersections.size(), 2);
+        ASSERT_NEAR(intersections[0].t, t0[i], 1e-3f);
+        ASSERT_NEAR(intersections[1].t, t1[i], 1e-3f);
+    }
+}
+
+TEST(Cone_test, a_ray_parallel_to_one_half_hits_the_other) {
+    Cone cone;
+    Ray ray(Tuple::Point(0.0f, 0.0f, -1.0f), normalize(Tuple::Vector(0.0f, 1.0f, 1.0f)));
+    std::vector<Intersection> intersections = cone.localIntersects(ray);
+    ASSERT_EQ(intersections.size(), 1);
+    ASSERT_NEAR(intersections[0].t, 0.35355f, 1e-4f);
+}
+
+TEST(Cone_test, intersecting_the_caps_of_a_closed_cone) {
+    Cone cone;
+    cone.minimum = -0.5f;
+    cone.maximum = 0.5f;
+    cone.closed = true;
+    Tuple origins[3] = {Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Point(0.0f, 0.0f, -0.25f), Tuple::Point(0.0f, 0.0f, -0.25f)};
+    Tuple directions[3] = {Tuple::Vector(0.0f, 1.0f, 0.0f), Tuple::Vector(0.0f, 1.0f, 1.0f), Tuple::Vector(0.0f, 1.0f, 0.0f)};
+    int counts[3] = {0, 2, 4};
+
+    for (int i = 0; i < 3; i++) {
+        Ray ray(origins[i], normalize(directions[i]));
+        ASSERT_EQ(cone.localIntersects(ray).size(), counts[i]);
+    }
+}
+
+TEST(Cone_test, normal_vector_on_a_cone) {
+    Cone cone;
+    ASSERT_TRUE(cone.localNormalAt(Tuple::Point(0.0f, 0.0f, 0.0f)) == Tuple::Vector(0.0f, 0.0f, 0.0f));
+    ASSERT_TRUE(cone.localNormalAt(Tuple::Point(1.0f, 1.0f, 1.0f)) == Tuple::Vector(1.0f, -std::sqrt(2.0f), 1.0f));
+    ASSERT_TRUE(cone.localNormalAt(Tuple::Point(-1.0f, -1.0f, 0.0f)) == Tuple::Vector(-1.0f, 1.0f, 0.0f));
+}
+
+TEST(Cone_test, a_truncated_cone_is_bounded_by_its_widest_end) {
+    Cone cone;
+    ASSERT_FALSE(cone.bounds().finite());
+
+    cone.minimum = -1.0f;
+    cone.maximum = 3.0f;
+    ASSERT_TRUE(cone.bounds().min == Tuple::Point(-3.0f, -1.0f, -3.0f));
+    ASSERT_TRUE(cone.bounds().max == Tuple::Point(3.0f, 3.0f, 3.0f));
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "Cylinder.h"
+#include "Ray.h"
+#include "Tuple.h"
+
+TEST(Cylinder_test, a_ray_misses_a_cylinder) {
+    Cylinder cylinder;
+    Tuple origins[3] = {Tuple::Point(1.0f, 0.0f, 0.0f), Tuple::Point(0.0f, 0.0f, 0.0f), Tuple::Point(0.0f, 0.0f, -5.0f)};
+    Tuple directions[3] = {Tuple::Vector(0.0f, 1.0f, 0.0f), Tuple::Vector(0.0f, 1.0f, 0.0f), Tuple::Vector(1.0f, 1.0f, 1.0f)};
+
+    for (int i = 0; i < 3; i++) {
+        Ray ray(origins[i], normalize(directions[i]));
+        ASSERT_EQ(cylinder.localIntersects(ray).size(), 0);
+    }
+}
+
+TEST(Cylinder_test, a_ray_strikes_a_cylinder) {
+    Cylinder cylinder;
+    Tuple origins[3] = {Tuple::Point(1.0f, 0.0f, -5.0f), Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Point(0.5f, 0.0f, -5.0f)};
+    Tuple directions[3] = {Tuple::Vector(0.0f, 0.0f, 1.0f), Tuple::Vector(0.0f, 0.0f, 1.0f), Tuple::Vector(0.1f, 1.0f, 1.0f)};
+    float t0[3] = {5.0f, 4.0f, 6.80798f};
+    float t1[3] = {5.0f, 6.0f, 7.08872f};
+
+    for (int i = 0; i < 3; i++) {
+        Ray ray(origins[i], normalize(directions[i]));
+        std::vector<Intersection> intersections = cylinder.localIntersects(ray);
+        ASSERT_EQ(intersections.size(), 2);
+        ASSERT_NEAR(intersections[0].t, t0[i], 1e-4f);
+        ASSERT_NEAR(intersections[1].t, t1[i], 1e-4f);
+    }
+}
+
+TEST(Cylinder_test, normal_vector_on_a_cylinder) {
+    Cylinder cylinder;
+    ASSERT_TRUE(cylinder.localNormalAt(Tuple::Point(1.0f, 0.0f, 0.0f)) == Tuple::Vector(1.0f, 0.0f, 0.0f));
+    ASSERT_TRUE(cylinder.localNormalAt(Tuple::Point(0.0f, 5.0f, -1.0f)) == Tuple::Vector(0.0f, 0.0f, -1.0f));
+    ASSERT_TRUE(cylinder.localNormalAt(Tuple::Point(0.0f, -2.0f, 1.0f)) == Tuple::Vector(0.0f, 0.0f, 1.0f));
+    ASSERT_TRUE(cylinder.localNormalAt(Tuple::Point(-1.0f, 1.0f, 0.0f)) == Tuple::Vector(-1.0f, 0.0f, 0.0f));
+}
+
+TEST(Cylinder_test, the_default_cylinder_is_unbounded_and_open) {
+    Cylinder cylinder;
+    ASSERT_EQ(cylinder.minimum, -INFINITY);
+    ASSERT_EQ(cylinder.maximum, INFINITY);
+    ASSERT_FALSE(cylinder.closed);
+    ASSERT_FALSE(cylinder.bounds().finite());
+}
+
+TEST(Cylinder_test, intersecting_a_truncated_cylinder) {
+    Cylinder cylinder;
+    cylinder.minimum = 1.0f;
+    cylinder.maximum = 2.0f;
+    Tuple origins[6] = {Tuple::Point(0.0f, 1.5f, 0.0f), Tuple::Point(0.0f, 3.0f, -5.0f), Tuple::Point(0.0f, 0.0f, -5.0f),
+                        Tuple::Point(0.0f, 2.0f, -5.0f), Tuple::Point(0.0f, 1.0f, -5.0f), Tuple::Point(0.0f, 1.5f, -2.0f)};
+    Tuple directions[6] = {Tuple::Vector(0.1f, 1.0f, 0.0f), Tuple::Vector(0.0f, 0.0f, 1.0f), Tuple::Vector(0.0f, 0.0f, 1.0f),
+                           Tuple::Vector(0.0f, 0.0f, 1.0f), Tuple::Vector(0.0f, 0.0f, 1.0f), Tuple::Vector(0.0f, 0.0f, 1.0f)};
+    int counts[6] = {0, 0, 0, 0, 0, 2};
+
+    for (int i = 0; i < 6; i++) {
+        Ray ray(origins[i], normalize(directions[i]));
+        ASSERT_EQ(cylinder.localIntersects(ray).size(), counts[i]);
+    }
+    ASSERT_TRUE(cylinder.bounds().min == Tuple::Point(-1.0f, 1.0f, -1.0f));
+    ASSERT_TRUE(cylinder.bounds().max == Tuple::Point(1.0f, 2.0f, 1.0f));
+}
+
+TEST(Cylinder_test, intersecting_the_caps_of_a_closed_cylinder) {
+    Cylinder cylinder;
+    cylinder.minimum = 1.0f;
+    cylinder.maximum = 2.0f;
+    cylinder.closed = true;
+    Tuple origins[5] = {Tuple::Point(0.0f, 3.0f, 0.0f), Tuple::Point(0.0f, 3.0f, -2.0f), Tuple::Point(0.0f, 4.0f, -2.0f),
+                        Tuple::Point(0.0f, 0.0f, -2.0f), Tuple::Point(0.0f, -1.0f, -2.0f)};
+    Tuple directions[5] = {Tuple::Vector(0.0f, -1.0f, 0.0f), Tuple::Vector(0.0f, -1.0f, 2.0f), Tuple::Vector(0.0f, -1.0f, 1.0f),
+                           Tuple::Vector(0.0f, 1.0f, 2.0f), Tuple::Vector(0.0f, 1.0f, 1.0f)};
+
+    for (int i = 0; i < 5; i++) {
+        Ray ray(origins[i], normalize(directions[i]));
+        ASSERT_EQ(cylinder.localIntersects(ray).size(), 2);
+    }
+}
+
+TEST(Cylinder_test, normal_vector_on_the_end_caps) {
+    Cylinder cylinder;
+    cylinder.minimum = 1.0f;
+    cylinder.maximum = 2.0f;
+    cylinder.closed = true;
+    ASSERT_TRUE(cylinder.localNormalAt(Tuple::Point(0.0f, 1.0f, 0.0f)) == Tuple::Vector(0.0f, -1.0f, 0.0f));
+    ASSERT_TRUE(cylinder.localNormalAt(Tuple::Point(0.5f, 1.0f, 0.0f)) == Tuple::Vector(0.0f, -1.0f, 0.0f));
+    ASSERT_TRUE(cylinder.localNormalAt(Tuple::Point(0.0f, 1.0f, 0.5f)) == Tuple::Vector(0.0f, -1.0f, 0.0f));
+    ASSERT_TRUE(cylinder.localNormalAt(Tuple::Point(0.0f, 2.0f, 0.0f)) == Tuple::Vector(0.0f, 1.0f, 0.0f));
+    ASSERT_TRUE(cylinder.localNormalAt(Tuple::Point(0.5f, 2.0f, 0.0f)) == Tuple::Vector(0.0f, 1.0f, 0.0f));
+    ASSERT_TRUE(cylinder.localNormalAt(Tuple::Point(0.0f, 2.0f, 0.5f)) == Tuple::Vector(0.0f, 1.0f, 0.0f));
+}
@@ -0,0 +1,26 @@
+#include <gtest/gtest.h>
+
+#include "Disk.h"
+#include "Ray.h"
+#include "Tuple.h"
+
+TEST(Disk_test, a_ray_hits_a_disk_within_its_radius) {
+    Disk disk;
+    Ray ray(Tuple::Point(0.5f, 2.0f, -0.5f), Tuple::Vector(0.0f, -1.0f, 0.0f));
+    std::vector<Intersection> intersections = disk.localIntersects(ray);
+    ASSERT_EQ(intersections.size(), 1);
+    ASSERT_EQ(intersections[0].t, 2.0f);
+}
+
+TEST(Disk_test, a_ray_misses_outside_the_radius_or_parallel) {
+    Disk disk;
+    ASSERT_EQ(disk.localIntersects(Ray(Tuple::Point(0.8f, 2.0f, 0.8f), Tuple::Vector(0.0f, -1.0f, 0.0f))).size(), 0);
+    ASSERT_EQ(disk.localIntersects(Ray(Tuple::Point(0.0f, 0.0f, -2.0f), Tuple::Vector(0.0f, 0.0f, 1.0f))).size(), 0);
+}
+
+TEST(Disk_test, normal_and_bounds_of_a_disk) {
+    Disk disk;
+    ASSERT_TRUE(disk.localNormalAt(Tuple::Point(0.3f, 0.0f, 0.2f)) == Tuple::Vector(0.0f, 1.0f, 0.0f));
+    ASSERT_TRUE(disk.bounds().min == Tuple::Point(-1.0f, 0.0f, -1.0f));
+    ASSERT_TRUE(disk.bounds().max == Tuple::Point(1.0f, 0.0f, 1.0f));
+}
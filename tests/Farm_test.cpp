@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <cstring>
+#include <thread>
+#include <cstdint>
+#include <stdexcept>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include "Farm.h"
+#include "Camera.h"
+#include "World.h"
+#include "Transformations.h"
+
+class Farm_test: public ::testing::Test { 
+public: 
+    World world = World::DefaultWorld();
+    Camera camera = Camera(11, 11, M_PI/2);
+
+    void SetUp() override {
+        camera.transform = viewTransformation(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Point(0.0f, 0.0f, 0.0f), Tuple::Vector(0.0f, 1.0f, 0.0f));
+    }
+
+    void expectSameImage(Canvas const &a, Canvas const &b) {
+        ASSERT_EQ(a.width, b.width);
+        ASSERT_EQ(a.height, b.height);
+        for (int y = 0; y < a.height; y++) {
+            for (int x = 0; x < a.width; x++) {
+                ASSERT_TRUE(a.pixelAt(x, y) == b.pixelAt(x, y));
+            }
+        }
+    }
+};
+
+TEST_F(Farm_test, forked_workers_assemble_the_same_image) {
+    Canvas expected = render(camera, world, RenderSettings(1));
+    Canvas farmed = renderFarm(camera, world, RenderSettings(1, 1, 3, 3), FarmSettings(3));
+
+    expectSameImage(expected, farmed);
+}
+
+#ifndef _WIN32
+static void readFully(int fd, void *data, std::size_t size) {
+    char *bytes = static_cast<char*>(data);
+    for (std::size_t got = 0; got < size; ) {
+        ssize_t n = read(fd, bytes + got, size - got);
+        ASSERT_GT(n, 0);
+        got += n;
+    }
+};
+
+//connects like a worker, takes the job and reads the first tile request into `tile`
+static int takeFirstTile(std::string const &path, std::int32_t tile[4]) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    while (connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+        usleep(1000);
+    }
+    char job[104];
+    readFully(fd, job, sizeof(job));
+    std::int32_t accepted = 1;
+    EXPECT_EQ(write(fd, &accepted, sizeof(accepted)), (ssize_t)sizeof(accepted));
+    readFully(fd, tile, 4*sizeof(std::int32_t));
+    return fd;
+};
+
+static std::string socketPath() {
+    return "/tmp/raytracer_farm_test_" + std::to_string(getpid()) + ".sock";
+};
+
+TEST_F(Farm_test, tile_of_a_disconnected_worker_is_rendered_again) {
+    std::string path = socketPath();
+
+    //first worker takes a tile and hangs up, the second one renders everything
+    std::thread workers([&]() {
+        std::int32_t tile[4];
+        close(takeFirstTile(path, tile));
+
+        runFarmWorker(path, world);
+    });
+
+    Canvas expected = render(camera, world, RenderSettings(1));
+    Canvas farmed = renderFarm(camera, world, RenderSettings(1, 1, 3, 4), FarmSettings(0, path));
+    workers.join();
+
+    expectSameImage(expected, farmed);
+}
+TEST_F(Farm_test, a_worker_returning_another_tile_is_dropped) {
+    std::string path = socketPath();
+
+    std::thread workers([&]() {
+        std::int32_t tile[4];
+        int fd = takeFirstTile(path, tile);
+        tile[0]++;
+        EXPECT_EQ(write(fd, tile, sizeof(tile)), (ssize_t)sizeof(tile));
+        //the coordinator hangs up instead of reading on
+        char byte;
+        while (read(fd, &byte, 1) > 0) {
+        }
+        close(fd);
+
+        runFarmWorker(path, world);
+    });
+
+    Canvas expected = render(camera, world, RenderSettings(1));
+    Canvas farmed = renderFarm(camera, world, RenderSettings(1, 1, 3, 4), FarmSettings(0, path));
+    workers.join();
+
+    expectSameImage(expected, farmed);
+}
+
+TEST_F(Farm_test, tile_of_a_hung_worker_times_out) {
+    std::string path = socketPath();
+
+    std::thread workers([&]() {
+        std::int32_t tile[4];
+        int fd = takeFirstTile(path, tile);
+        //never answers, until the coordinator gives up on it
+        char byte;
+        while (read(fd, &byte, 1) > 0) {
+        }
+        close(fd);
+
+        runFarmWorker(path, world);
+    });
+
+    Canvas expected = render(camera, world, RenderSettings(1));
+    Canvas farmed = renderFarm(camera, world, RenderSettings(1, 1, 3, 4), FarmSettings(0, path, 3, 200));
+    workers.join();
+
+    expectSameImage(expected, farmed);
+}
+
+TEST_F(Farm_test, workers_take_the_coordinators_camera_and_check_its_scene) {
+    std::string path = socketPath();
+    RenderSettings settings(1, 1, 3, 4);
+    settings.sceneHash = 8;
+
+    std::thread workers([&]() {
+        EXPECT_THROW(runFarmWorker(path, world, 7), std::runtime_error);
+        runFarmWorker(path, world, 8);
+    });
+
+    Canvas expected = render(camera, world, RenderSettings(1));
+    Canvas farmed = renderFarm(camera, world, settings, FarmSettings(0, path));
+    workers.join();
+
+    expectSameImage(expected, farmed);
+}
+#endif
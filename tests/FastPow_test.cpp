@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+#include "FastPow.h"
+#include "Material.h"
+#include "Light.h"
+
+static const float exponents[] = {1.0f, 2.0f, 5.0f, 10.0f, 37.5f, 200.0f, 1000.0f};
+
+TEST(FastPow_test, integer_powers_match_pow) {
+    for (int n : {0, 1, 2, 5, 10, 200, 1000}) {
+        for (int i = 0; i <= 1000; i++) {
+            float x = i / 1000.0f;
+            float exact = std::pow((double)x, (double)n);
+            ASSERT_NEAR(integerPow(x, n), exact, std::fabs(exact) * 1e-6f) << x << "^" << n;
+        }
+    }
+}
+
+TEST(FastPow_test, approximate_pow_stays_within_its_error_bound) {
+    for (float y : exponents) {
+        for (int i = 1; i <= 100000; i++) {
+            float x = i / 100000.0f;
+            double exact = std::pow((double)x, (double)y);
+            float approximate = approximatePow(x, y);
+            ASSERT_LT(std::fabs(approximate - exact), 1e-6) << x << "^" << y;
+            if (exact > 1e-30) {
+                ASSERT_LT(std::fabs(approximate - exact) / exact, 2e-5) << x << "^" << y;
+            }
+        }
+    }
+    ASSERT_LT(approximatePow(0.0f, 10.0f), 1e-30f);
+}
+
+TEST(FastPow_test, every_mode_follows_pow) {
+    for (float e : exponents) {
+        //the documented interpolation bound of the table
+        float tableError = e*(e - 1.0f) / (8.0f*(SpecularPower::tableSize - 1)*(SpecularPower::tableSize - 1)) + 1e-6f;
+        SpecularPower exact(e, PowMode::Exact);
+        SpecularPower integer(e, PowMode::Integer);
+        SpecularPower table(e, PowMode::Table);
+        SpecularPower approximate(e, PowMode::Approximate);
+
+        for (int i = 0; i <= 4096; i++) {
+            float x = i / 4096.0f;
+            float reference = std::pow((double)x, (double)e);
+            ASSERT_EQ(exact(x), std::pow(x, e));
+            ASSERT_NEAR(integer(x), reference, reference * 1e-6f + 1e-12f);
+            ASSERT_NEAR(table(x), reference, tableError) << x << "^" << e;
+            ASSERT_NEAR(approximate(x), reference, 1e-6f);
+        }
+    }
+}
+
+TEST(FastPow_test, lighting_uses_the_specular_power) {
+    Material material;
+    Light light(Tuple::Point(0.0f, 10.0f, -10.0f), Color(1.0f, 1.0f, 1.0f));
+    Tuple position = Tuple::Point(0.0f, 0.0f, 0.0f);
+    Tuple eye = Tuple::Vector(0.0f, -std::sqrt(2.0f)/2.0f, -std::sqrt(2.0f)/2.0f);
+    Tuple normal = Tuple::Vector(0.0f, 0.0f, -1.0f);
+
+    Color reference = lighting(material, material.color, light, position, eye, normal, false);
+    SpecularPower exact(material.shininess, PowMode::Exact);
+    ASSERT_TRUE(lighting(material, material.color, light, position, eye, normal, false, &exact) == reference);
+
+    SpecularPower approximate(material.shininess, PowMode::Approximate);
+    Color preview = lighting(material, material.color, light, position, eye, normal, false, &approximate);
+    ASSERT_NEAR(preview.red, reference.red, 1e-4f);
+}
+
+TEST(FastPow_test, pow_modes_by_name) {
+    ASSERT_TRUE(powModeFromName("exact") == PowMode::Exact);
+    ASSERT_TRUE(powModeFromName("integer") == PowMode::Integer);
+    ASSERT_TRUE(powModeFromName("table") == PowMode::Table);
+    ASSERT_TRUE(powModeFromName("approx") == PowMode::Approximate);
+    ASSERT_THROW(powModeFromName("fast"), std::invalid_argument);
+}
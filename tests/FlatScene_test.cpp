@@ -0,0 +1,334 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "FlatScene.h"
+#include "World.h"
+#include "Camera.h"
+#include "Scene.h"
+#include "Sphere.h"
+#include "Cube.h"
+#include "Plane.h"
+#include "Cylinder.h"
+#include "Cone.h"
+#include "Disk.h"
+#include "CSG.h"
+#include "Stripe.h"
+#include "Ring.h"
+#include "Grid.h"
+#include "Gradient.h"
+#include "Solid.h"
+#include "NoisePattern.h"
+#include "Perturb.h"
+#include "Transformations.h"
+
+//a shape the flat scene has no array for
+class TestShape : public Sphere {
+public:
+    int calls = 0;
+
+    std::vector<Intersection> localIntersects(Ray const &ray) override {
+        calls++;
+        return Sphere::localIntersects(ray);
+    };
+};
+
+class FlatScene_test: public ::testing::Test { 
+public: 
+    Sphere sphere;
+    Cube cube;
+    Plane plane;
+    TestShape other;
+    std::vector<Object*> objects;
+    std::vector<Ray> rays;
+    PatternPool pool;
+
+    void SetUp() override {
+        sphere.setTransformation(translation(1.0f, 0.5f, 0.0f) * scaling(0.5f, 1.0f, 0.5f));
+        cube.setTransformation(translation(-1.5f, 0.0f, 2.0f) * rotation_y(0.5f));
+        plane.setTransformation(translation(0.0f, -1.0f, 0.0f));
+        other.setTransformation(translation(0.0f, 2.0f, 3.0f));
+        objects = {&sphere, &cube, &plane, &other};
+
+        for (int i = 0; i < 50; i++) {
+            Tuple origin = Tuple::Point(-3.0f + i*0.13f, 0.7f - i*0.05f, -5.0f);
+            Tuple target = Tuple::Point(std::sin(i*0.7f)*2.0f, std::cos(i*0.3f), 2.0f);
+            rays.push_back(Ray(origin, normalize(target - origin)));
+        }
+    }
+};
+
+static bool byObjectThenT(Intersection const &a, Intersection const &b) {
+    return a.object->id < b.object->id || (a.object->id == b.object->id && a.t < b.t);
+};
+
+TEST_F(FlatScene_test, shapes_are_grouped_by_type) {
+    FlatScene flat(objects);
+
+    ASSERT_EQ(flat.spheres.size(), 1u);
+    ASSERT_EQ(flat.cubes.size(), 1u);
+    ASSERT_EQ(flat.planes.size(), 1u);
+    ASSERT_EQ(flat.others.size(), 1u);
+    ASSERT_EQ(flat.others[0].object, &other);
+}
+
+TEST_F(FlatScene_test, identical_materials_are_interned_once) {
+    cube.material.color = Color(0.2f, 0.3f, 0.4f);
+    FlatScene flat(objects);
+
+    ASSERT_EQ(flat.materials.size(), 2);
+    ASSERT_EQ(&flat.material(&sphere), &flat.material(&plane));
+    ASSERT_TRUE(flat.material(&cube).color == Color(0.2f, 0.3f, 0.4f));
+}
+
+//compares every intersection and normal of the flat scene with the objects', returns how many hits there were
+static int compareWithObjects(FlatScene const &flat, std::vector<Object*> const &objects, std::vector<Ray> const &rays) {
+    int hits = 0;
+    for (Ray const &ray : rays) {
+        std::vector<Intersection> expected;
+        for (Object* object : objects) {
+            std::vector<Intersection> local = object->intersects(ray);
+            expected.insert(expected.end(), local.begin(), local.end());
+        }
+        std::vector<Intersection> actual;
+        flat.intersect(ray, actual);
+
+        std::sort(expected.begin(), expected.end(), byObjectThenT);
+        std::sort(actual.begin(), actual.end(), byObjectThenT);
+        EXPECT_EQ(actual.size(), expected.size());
+        if (actual.size() != expected.size()) {
+            return hits;
+        }
+        for (std::vector<Intersection>::size_type i = 0; i < actual.size(); i++) {
+            EXPECT_EQ(actual[i].object, expected[i].object);
+            EXPECT_EQ(actual[i].t, expected[i].t);
+
+            Tuple point = position(ray, actual[i].t);
+            EXPECT_TRUE(flat.normalAt(actual[i].object, point) == actual[i].object->normalAt(point));
+            hits++;
+        }
+    }
+    return hits;
+};
+
+TEST_F(FlatScene_test, intersections_and_normals_match_the_objects) {
+    FlatScene flat(objects);
+
+    int hits = compareWithObjects(flat, objects, rays);
+    ASSERT_GT(hits, 50);
+    ASSERT_GT(other.calls, 0);
+}
+
+TEST_F(FlatScene_test, cylinders_cones_and_disks_match_the_objects) {
+    Cylinder cylinder;
+    cylinder.minimum = -0.5f;
+    cylinder.maximum = 1.0f;
+    cylinder.closed = true;
+    cylinder.setTransformation(translation(-1.0f, 0.0f, 1.0f) * rotation_z(0.4f));
+    Cone cone;
+    cone.minimum = -1.0f;
+    cone.maximum = 0.0f;
+    cone.closed = true;
+    cone.setTransformation(translation(1.0f, 0.5f, 0.5f));
+    Cone openCone;
+    openCone.setTransformation(translation(0.0f, 0.0f, 4.0f) * scaling(0.3f, 1.0f, 0.3f));
+    Disk disk;
+    disk.setTransformation(translation(0.0f, 0.0f, 1.5f) * rotation_x(1.2f) * scaling(2.0f, 1.0f, 2.0f));
+    std::vector<Object*> shapes = {&cylinder, &cone, &openCone, &disk};
+
+    FlatScene flat(shapes);
+    ASSERT_EQ(flat.cylinders.size(), 1u);
+    ASSERT_EQ(flat.cones.size(), 2u);
+    ASSERT_EQ(flat.disks.size(), 1u);
+    ASSERT_TRUE(flat.others.empty());
+
+    ASSERT_GT(compareWithObjects(flat, shapes, rays), 30);
+}
+
+TEST_F(FlatScene_test, csg_children_are_shaded_through_their_parents) {
+    Sphere ball;
+    Cube box;
+    box.setTransformation(scaling(0.8f, 0.8f, 0.8f));
+    box.material.color = Color(0.9f, 0.1f, 0.1f);
+    CSG rounded(CSGOperation::Intersection, ball, box);
+    Cylinder drill;
+    drill.setTransformation(rotation_x(M_PI/2) * scaling(0.4f, 1.0f, 0.4f));
+    CSG part(CSGOperation::Difference, rounded, drill);
+    part.setTransformation(translation(0.5f, 0.0f, 0.0f) * rotation_y(0.3f));
+    std::vector<Object*> shapes = {&part, &plane};
+
+    FlatScene flat(shapes);
+    ASSERT_EQ(flat.others.size(), 1u);
+    ASSERT_EQ(flat.members.size(), 4u);
+    ASSERT_TRUE(flat.material(&box).color == Color(0.9f, 0.1f, 0.1f));
+
+    //children keep their own type, so they go through the same paths as top level shapes
+    ASSERT_EQ(flat.csgs.size(), 2u);
+    ASSERT_EQ(flat.others[0].csg, 0);
+    ASSERT_EQ(flat.csgs[0].children[0].csg, 1);
+    ASSERT_EQ(flat.csgs[0].types[1], ShapeType::Cylinder);
+    ASSERT_EQ(flat.csgs[1].types[0], ShapeType::Sphere);
+    ASSERT_EQ(flat.csgs[1].types[1], ShapeType::Cube);
+
+    ASSERT_GT(compareWithObjects(flat, shapes, rays), 20);
+    FlatScene everything(shapes, PowMode::Exact, Acceleration::None);
+    ASSERT_GT(compareWithObjects(everything, shapes, rays), 20);
+}
+
+TEST_F(FlatScene_test, the_bvh_and_the_grid_find_what_testing_every_shape_finds) {
+    //a ground plane under a field of bounded shapes
+    std::vector<Sphere> balls(40);
+    std::vector<Cube> boxes(10);
+    std::vector<Object*> shapes = {&plane};
+    for (int i = 0; i < 40; i++) {
+        balls[i].setTransformation(translation(std::sin(i*1.3f)*3.0f, 0.3f + (i % 4)*0.4f, i*0.25f) * scaling(0.3f, 0.3f, 0.3f));
+        shapes.push_back(&balls[i]);
+    }
+    for (int i = 0; i < 10; i++) {
+        boxes[i].setTransformation(translation(std::cos(i*0.8f)*3.0f, 0.0f, i*1.0f) * rotation_y(i*0.2f) * scaling(0.25f, 0.5f, 0.25f));
+        shapes.push_back(&boxes[i]);
+    }
+    Cylinder pillar;
+    pillar.setTransformation(translation(2.0f, 0.0f, 6.0f) * scaling(0.2f, 1.0f, 0.2f));
+    shapes.push_back(&pillar);
+
+    FlatScene everything(shapes, PowMode::Exact, Acceleration::None);
+    ASSERT_TRUE(everything.bounded.empty());
+    FlatScene withGrid(shapes, PowMode::Exact, Acceleration::Grid);
+    ASSERT_GT(withGrid.grid.cells(), 1);
+    FlatScene withBVH(shapes);
+    ASSERT_FALSE(withBVH.bvh.nodes.empty());
+
+    for (FlatScene const* accelerated : {&withBVH, &withGrid}) {
+        //the plane and the cylinder, which has no ends, are tested against every ray
+        ASSERT_EQ(accelerated->unbounded.size(), 2u);
+        ASSERT_EQ(accelerated->bounded.size(), 50u);
+
+        int hits = 0;
+        for (Ray ray : rays) {
+            std::vector<Intersection> expected;
+            std::vector<Intersection> actual;
+            everything.intersect(ray, expected);
+            accelerated->intersect(ray, actual);
+            std::sort(expected.begin(), expected.end(), byObjectThenT);
+            std::sort(actual.begin(), actual.end(), byObjectThenT);
+            ASSERT_EQ(actual.size(), expected.size());
+            for (std::vector<Intersection>::size_type i = 0; i < actual.size(); i++) {
+                ASSERT_EQ(actual[i].object, expected[i].object);
+                ASSERT_EQ(actual[i].t, expected[i].t);
+            }
+            hits += actual.size();
+
+            ASSERT_EQ(accelerated->nearestHit(ray), everything.nearestHit(ray));
+            ray.tMin = 1.0f;
+            ray.tMax = 6.0f;
+            ASSERT_EQ(accelerated->nearestHit(ray), everything.nearestHit(ray));
+        }
+        ASSERT_GT(hits, 50);
+    }
+}
+
+TEST_F(FlatScene_test, nested_patterns_match_the_pattern_classes) {
+    Solid red(Color(1.0f, 0.0f, 0.0f));
+    Gradient gradient(Color(0.0f, 0.0f, 1.0f), Color(0.0f, 1.0f, 0.0f));
+    gradient.transform = scaling(0.3f, 1.0f, 1.0f);
+    Stripe stripe(red, gradient);
+    stripe.transform = rotation_z(0.4f);
+    Ring ring(pool, Color(1.0f, 1.0f, 0.0f), Color(0.2f, 0.2f, 0.2f));
+    Grid grid(stripe, ring);
+    grid.transform = translation(0.25f, 0.0f, 0.5f) * scaling(0.5f, 0.5f, 0.5f);
+    TestPattern custom;
+
+    sphere.material.setPattern(grid);
+    cube.material.setPattern(custom);
+    FlatScene flat(objects);
+
+    //red is shared by nothing else, every node appears once
+    ASSERT_EQ(flat.patterns.size(), 8u);
+
+    for (int i = 0; i < 200; i++) {
+        Tuple point = Tuple::Point(std::sin(i*1.3f)*3.0f, std::cos(i*0.9f)*2.0f, i*0.037f - 3.0f);
+        ASSERT_TRUE(flat.colorAt(&sphere, point) == sphere.colorAt(point));
+        ASSERT_TRUE(flat.colorAt(&cube, point) == cube.colorAt(point));
+    }
+    ASSERT_TRUE(flat.colorAt(&plane, Tuple::Point(0.0f, 0.0f, 0.0f)) == plane.material.color);
+}
+
+TEST_F(FlatScene_test, batched_pattern_colors_match_one_at_a_time) {
+    Solid red(Color(1.0f, 0.0f, 0.0f));
+    Gradient gradient(Color(0.0f, 0.0f, 1.0f), Color(0.0f, 1.0f, 0.0f));
+    gradient.transform = scaling(0.3f, 1.0f, 1.0f);
+    Stripe stripe(red, gradient);
+    Ring ring(pool, Color(1.0f, 1.0f, 0.0f), Color(0.2f, 0.2f, 0.2f));
+    ring.transform = rotation_x(0.7f);
+    Grid grid(stripe, ring);
+    grid.transform = scaling(0.5f, 0.5f, 0.5f);
+
+    sphere.material.setPattern(grid);
+    FlatScene flat(objects);
+
+    //identity transforms and solids cost nothing at run time
+    ASSERT_TRUE(flat.patterns[0].transformed);
+    ASSERT_FALSE(flat.patterns[1].transformed);
+    ASSERT_FALSE(flat.patterns[2].transformed);
+
+    std::vector<Tuple> points;
+    for (int i = 0; i < 500; i++) {
+        points.push_back(Tuple::Point(std::sin(i*1.3f)*3.0f, std::cos(i*0.9f)*2.0f, i*0.013f - 3.0f));
+    }
+    std::vector<Color> colors;
+    flat.colorsAt(&sphere, points, colors);
+    ASSERT_EQ(colors.size(), points.size());
+    for (std::vector<Tuple>::size_type i = 0; i < points.size(); i++) {
+        ASSERT_TRUE(colors[i] == flat.colorAt(&sphere, points[i]));
+        ASSERT_TRUE(colors[i] == sphere.colorAt(points[i]));
+    }
+
+    flat.colorsAt(&plane, points, colors);
+    ASSERT_TRUE(colors[7] == plane.material.color);
+}
+
+TEST_F(FlatScene_test, noise_patterns_compile_to_instructions) {
+    Ring ring(pool, Color(0.6f, 0.4f, 0.2f), Color(0.3f, 0.2f, 0.1f));
+    ring.transform = scaling(0.2f, 0.2f, 0.2f);
+    Perturb wood(ring, 0.3f);
+    NoisePattern marble(NoiseType::Turbulence, Color(1.0f, 1.0f, 1.0f), Color(0.1f, 0.1f, 0.2f), 5);
+    marble.transform = scaling(0.4f, 0.4f, 0.4f);
+    Stripe stripe(wood, marble);
+
+    sphere.material.setPattern(stripe);
+    FlatScene flat(objects);
+    ASSERT_EQ(flat.patterns[1].type, PatternType::Perturb);
+    ASSERT_EQ(flat.patterns[5].type, PatternType::Noise);
+
+    std::vector<Tuple> points;
+    for (int i = 0; i < 300; i++) {
+        points.push_back(Tuple::Point(std::sin(i*1.3f)*3.0f, std::cos(i*0.9f)*2.0f, i*0.013f - 3.0f));
+    }
+    std::vector<Color> colors;
+    flat.colorsAt(&sphere, points, colors);
+    for (std::vector<Tuple>::size_type i = 0; i < points.size(); i++) {
+        ASSERT_TRUE(colors[i] == flat.colorAt(&sphere, points[i]));
+        ASSERT_TRUE(colors[i] == sphere.colorAt(points[i]));
+    }
+}
+
+TEST_F(FlatScene_test, compiled_world_renders_the_same_image) {
+    std::unique_ptr<Scene> scene = Scene::DemoScene();
+    Camera camera(24, 16, scene->camera.fieldOfView);
+    camera.transform = scene->camera.transform;
+
+    //render() compiles, colorAt on the authored world does not. The cube stands on the plane, so
+    //some rays meet both at the same t and the order of equal hits matters for refraction
+    Canvas image = render(camera, scene->world, RenderSettings(1, 1, 3, 8));
+    ASSERT_FALSE(scene->world.flat);
+
+    for (int y = 0; y < camera.vsize; y++) {
+        for (int x = 0; x < camera.hsize; x++) {
+            ASSERT_TRUE(image.pixelAt(x, y) == colorAt(scene->world, camera.rayForPixel(x, y), 3));
+        }
+    }
+}
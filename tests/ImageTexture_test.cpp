@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <sstream>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "ImageTexture.h"
+#include "Canvas.h"
+#include "Sphere.h"
+#include "Scene.h"
+
+static void expectUV(void (*map)(Tuple const&, float&, float&), Tuple const &point, float u, float v) {
+    float actualU, actualV;
+    map(point, actualU, actualV);
+    EXPECT_NEAR(actualU, u, 1e-5f);
+    EXPECT_NEAR(actualV, v, 1e-5f);
+};
+
+TEST(ImageTexture_test, spherical_mapping) {
+    expectUV(sphericalMap, Tuple::Point(0.0f, 0.0f, -1.0f), 0.0f, 0.5f);
+    expectUV(sphericalMap, Tuple::Point(1.0f, 0.0f, 0.0f), 0.25f, 0.5f);
+    expectUV(sphericalMap, Tuple::Point(0.0f, 0.0f, 1.0f), 0.5f, 0.5f);
+    expectUV(sphericalMap, Tuple::Point(-1.0f, 0.0f, 0.0f), 0.75f, 0.5f);
+    expectUV(sphericalMap, Tuple::Point(0.0f, 1.0f, 0.0f), 0.5f, 1.0f);
+    expectUV(sphericalMap, Tuple::Point(0.0f, -1.0f, 0.0f), 0.5f, 0.0f);
+    expectUV(sphericalMap, Tuple::Point(std::sqrt(2.0f)/2.0f, std::sqrt(2.0f)/2.0f, 0.0f), 0.25f, 0.75f);
+}
+
+TEST(ImageTexture_test, planar_and_cubic_mapping) {
+    expectUV(planarMap, Tuple::Point(0.25f, 0.0f, 0.5f), 0.25f, 0.5f);
+    expectUV(planarMap, Tuple::Point(0.25f, 0.0f, -0.25f), 0.25f, 0.75f);
+    expectUV(planarMap, Tuple::Point(-1.75f, 3.0f, 1.25f), 0.25f, 0.25f);
+
+    //face centers land in the middle of the texture
+    expectUV(cubicMap, Tuple::Point(1.0f, 0.0f, 0.0f), 0.5f, 0.5f);
+    expectUV(cubicMap, Tuple::Point(0.0f, -1.0f, 0.0f), 0.5f, 0.5f);
+    expectUV(cubicMap, Tuple::Point(0.0f, 0.0f, -1.0f), 0.5f, 0.5f);
+    //left edge of the front (-z) face, top edge of the right (+x) face
+    expectUV(cubicMap, Tuple::Point(-1.0f, 0.0f, -1.0f), 0.0f, 0.5f);
+    expectUV(cubicMap, Tuple::Point(1.0f, 0.999f, 0.0f), 0.5f, 0.9995f);
+}
+
+TEST(ImageTexture_test, samples_texels_bilinearly_and_between_levels) {
+    Canvas image(2, 2);
+    image.writePixel(0, 0, Color(1.0f, 0.0f, 0.0f));
+    image.writePixel(1, 0, Color(0.0f, 1.0f, 0.0f));
+    image.writePixel(0, 1, Color(0.0f, 0.0f, 1.0f));
+    image.writePixel(1, 1, Color(1.0f, 1.0f, 1.0f));
+    TextureCache cache;
+    ImageTexture texture(cache, cache.add(image), UVMapping::Planar);
+
+    //texel centers, v = 0 is the bottom row
+    ASSERT_TRUE(texture.sample(0.25f, 0.75f, 0.0f) == Color(1.0f, 0.0f, 0.0f));
+    ASSERT_TRUE(texture.sample(0.75f, 0.25f, 0.0f) == Color(1.0f, 1.0f, 1.0f));
+    ASSERT_TRUE(texture.sample(0.5f, 0.75f, 0.0f) == Color(0.5f, 0.5f, 0.0f));
+
+    //the 1x1 level is the average, lod past the last level clamps to it
+    ASSERT_TRUE(texture.sample(0.1f, 0.1f, 1.0f) == Color(0.5f, 0.5f, 0.5f));
+    ASSERT_TRUE(texture.sample(0.1f, 0.1f, 7.0f) == Color(0.5f, 0.5f, 0.5f));
+    ASSERT_TRUE(texture.sample(0.25f, 0.75f, 0.5f) == Color(0.75f, 0.25f, 0.25f));
+
+    texture.lod = 1.0f;
+    ASSERT_TRUE(texture.colorAt(Tuple::Point(0.3f, 0.0f, 0.6f)) == Color(0.5f, 0.5f, 0.5f));
+}
+
+TEST(ImageTexture_test, cubic_mapping_clamps_at_face_edges) {
+    Canvas image(2, 1);
+    image.writePixel(0, 0, Color(1.0f, 0.0f, 0.0f));
+    image.writePixel(1, 0, Color(0.0f, 0.0f, 1.0f));
+    TextureCache cache;
+    int handle = cache.add(image);
+    ImageTexture cubic(cache, handle, UVMapping::Cubic);
+    ImageTexture planar(cache, handle, UVMapping::Planar);
+
+    //past the last texel center the cube face keeps its edge, a repeating texture blends in the first
+    ASSERT_TRUE(cubic.sample(0.99f, 0.5f, 0.0f) == Color(0.0f, 0.0f, 1.0f));
+    ASSERT_FALSE(planar.sample(0.99f, 0.5f, 0.0f) == Color(0.0f, 0.0f, 1.0f));
+}
+
+TEST(ImageTexture_test, scenes_load_image_textures) {
+    std::string path = ::testing::TempDir() + "image_texture_test.ppm";
+    Canvas image(4, 2);
+    image.fill(Color(0.0f, 1.0f, 0.0f));
+    writeImage(image, path, ImageFormat::PPMBinary);
+
+    std::istringstream input("sphere\npattern image " + path + " sphere\nsphere\npattern image " + path + " plane 1.5\n");
+    std::unique_ptr<Scene> scene = parseScene(input, "test", 1 << 20);
+    ASSERT_EQ(scene->textures->budget(), 1u << 20);
+    ASSERT_TRUE(scene->objects[0]->colorAt(Tuple::Point(0.0f, 0.0f, -1.0f)) == Color(0.0f, 1.0f, 0.0f));
+    ASSERT_EQ(static_cast<ImageTexture*>(scene->objects[0]->material.pattern)->lod, 0.0f);
+    ASSERT_EQ(static_cast<ImageTexture*>(scene->objects[1]->material.pattern)->lod, 1.5f);
+
+    std::istringstream missing("sphere\npattern image nowhere.ppm sphere\n");
+    ASSERT_THROW(parseScene(missing, "test"), std::runtime_error);
+    std::istringstream negative("sphere\npattern image " + path + " sphere -1\n");
+    ASSERT_THROW(parseScene(negative, "test"), std::runtime_error);
+    std::istringstream unmapped("sphere\npattern image " + path + " torus\n");
+    ASSERT_THROW(parseScene(unmapped, "test"), std::runtime_error);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "MappedImage.h"
+#include "Canvas.h"
+#include "Camera.h"
+#include "World.h"
+#include "Transformations.h"
+
+class MappedImage_test: public ::testing::Test { 
+public: 
+    World world = World::DefaultWorld();
+    Camera camera = Camera(11, 11, M_PI/2);
+    std::string path = ::testing::TempDir() + "mapped_image_test.img";
+
+    void SetUp() override {
+        camera.transform = viewTransformation(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Point(0.0f, 0.0f, 0.0f), Tuple::Vector(0.0f, 1.0f, 0.0f));
+        std::remove(path.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    std::string fileContents() {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+};
+
+TEST_F(MappedImage_test, pixels_read_back_as_written) {
+    MappedImage image(path, 3, 2, ImageFormat::PFM);
+    image.writePixel(2, 1, Color(0.5f, 2.0f, 0.25f));
+
+    ASSERT_TRUE(image.pixelAt(2, 1) == Color(0.5f, 2.0f, 0.25f));
+    ASSERT_TRUE(image.pixelAt(0, 0) == Color(0.0f, 0.0f, 0.0f));
+}
+
+TEST_F(MappedImage_test, rendering_into_a_binary_PPM_matches_the_canvas) {
+    RenderSettings settings(2, 1, 3, 4);
+    Canvas expected = render(camera, world, settings);
+    {
+        MappedImage image(path, 11, 11, ImageFormat::PPMBinary);
+        renderInto(camera, world, settings, image);
+    }
+
+    std::stringstream fromFile(fileContents());
+    std::stringstream fromCanvas;
+    writeBinaryPPM(fromCanvas, expected);
+    ASSERT_EQ(fromFile.str(), fromCanvas.str());
+
+    Canvas read = readPPM(fromFile);
+    ASSERT_EQ(read.width, 11);
+    ASSERT_EQ(read.height, 11);
+}
+
+TEST_F(MappedImage_test, rendering_into_a_PFM_matches_the_canvas) {
+    RenderSettings settings(1, 1, 3, 5);
+    Canvas expected = render(camera, world, settings);
+    {
+        MappedImage image(path, 11, 11, ImageFormat::PFM);
+        renderInto(camera, world, settings, image);
+        image.sync();
+    }
+
+    std::stringstream fromCanvas;
+    writePFM(fromCanvas, expected);
+    ASSERT_EQ(fileContents(), fromCanvas.str());
+}
+
+TEST_F(MappedImage_test, rendering_a_crop_needs_a_framebuffer_of_its_size) {
+    RenderSettings settings(1, 1, 3, 4);
+    settings.regions.push_back(RenderRegion(2, 3, 5, 4));
+
+    MappedImage wrong(path, 11, 11, ImageFormat::PFM);
+    ASSERT_THROW(renderInto(camera, world, settings, wrong), std::invalid_argument);
+
+    MappedImage image(path, 5, 4, ImageFormat::PFM);
+    renderInto(camera, world, settings, image);
+    Canvas full = render(camera, world, RenderSettings(1, 1, 3, 4));
+    ASSERT_TRUE(image.pixelAt(0, 0) == full.pixelAt(2, 3));
+    ASSERT_TRUE(image.pixelAt(4, 3) == full.pixelAt(6, 6));
+}
+
+TEST_F(MappedImage_test, only_binary_formats_can_be_mapped) {
+    ASSERT_THROW(MappedImage(path, 2, 2, ImageFormat::PPM), std::runtime_error);
+}
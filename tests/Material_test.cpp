@@ -182,7 +182,8 @@ TEST(Lighting_test, lighting_with_a_pattern_applied) {
     Sphere sphere; 
 
     Material material;
-    Stripe p = Stripe(Color(1.0f, 1.0f, 1.0f), Color(0.0f, 0.0f, 0.0f));
+    PatternPool pool;
+    Stripe &p = pool.make<Stripe>(pool, Color(1.0f, 1.0f, 1.0f), Color(0.0f, 0.0f, 0.0f));
     material.setPattern(p);
     material.ambient = 1.0f;
     material.diffuse = 0.0f;
@@ -200,3 +201,26 @@ TEST(Lighting_test, lighting_with_a_pattern_applied) {
     ASSERT_TRUE(c1 == Color(1.0f, 1.0f, 1.0f));
     ASSERT_TRUE(c2 == Color(0.0f, 0.0f, 0.0f));
 }
+
+TEST(Material_test, identical_materials_share_a_table_entry) {
+    MaterialTable table;
+    Material red(Color(1.0f, 0.0f, 0.0f));
+    Material glass;
+    glass.transparency = 1.0f;
+    glass.refractive_index = 1.5f;
+
+    int first = table.intern(red);
+    ASSERT_EQ(table.intern(glass), 1);
+    ASSERT_EQ(table.intern(Material(Color(1.0f, 0.0f, 0.0f))), first);
+    ASSERT_EQ(table.size(), 2);
+    ASSERT_EQ(table[1].refractive_index, 1.5f);
+
+    //fields operator== ignores still tell materials apart
+    Material stripes = red;
+    PatternPool pool;
+    Stripe pattern(pool, Color(1.0f, 1.0f, 1.0f), Color(0.0f, 0.0f, 0.0f));
+    stripes.setPattern(pattern);
+    ASSERT_EQ(table.intern(stripes), 2);
+    red.reflective = 0.5f;
+    ASSERT_EQ(table.intern(red), 3);
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+#include "NoisePattern.h"
+#include "Perturb.h"
+#include "Stripe.h"
+#include "Noise.h"
+#include "Transformations.h"
+#include "Stats.h"
+
+class NoisePattern_test: public ::testing::Test { 
+public: 
+    const Color black = Color(0.0f, 0.0f, 0.0f);
+    const Color white = Color(1.0f, 1.0f, 1.0f);
+    PatternPool pool;
+};
+
+TEST_F(NoisePattern_test, noise_blends_between_the_colors) {
+    NoisePattern noise(NoiseType::Perlin, black, white);
+    //no noise on the lattice is halfway between the colors
+    ASSERT_TRUE(noise.colorAt(Tuple::Point(1.0f, 2.0f, 3.0f)) == Color(0.5f, 0.5f, 0.5f));
+
+    Tuple point = Tuple::Point(0.5f, 0.5f, 0.5f);
+    float value = perlin(point)*0.5f + 0.5f;
+    ASSERT_TRUE(noise.colorAt(point) == Color(value, value, value));
+}
+
+TEST_F(NoisePattern_test, turbulence_starts_at_the_first_color) {
+    NoisePattern noise(NoiseType::Turbulence, black, white, 3);
+    ASSERT_TRUE(noise.colorAt(Tuple::Point(1.0f, 2.0f, 3.0f)) == black);
+    ASSERT_EQ(noise.value(Tuple::Point(0.3f, 0.6f, 0.2f)), turbulence(Tuple::Point(0.3f, 0.6f, 0.2f), 3));
+}
+
+TEST_F(NoisePattern_test, batched_values_match_one_at_a_time) {
+    std::vector<Tuple> points;
+    for (int i = 0; i < 37; i++) {
+        points.push_back(Tuple::Point(i*0.37f, i*-0.21f, i*0.05f + 0.5f));
+    }
+    std::vector<float> values(points.size());
+    for (NoiseType type : {NoiseType::Perlin, NoiseType::FBM, NoiseType::Turbulence}) {
+        NoisePattern noise(type, black, white, 5);
+        noise.values(points.data(), values.data(), points.size());
+        for (std::vector<Tuple>::size_type i = 0; i < points.size(); i++) {
+            ASSERT_EQ(values[i], noise.value(points[i]));
+            ASSERT_GE(values[i], 0.0f);
+            ASSERT_LE(values[i], 1.0f);
+        }
+    }
+}
+
+TEST_F(NoisePattern_test, perturb_moves_the_point_by_at_most_the_amount) {
+    for (int i = 0; i < 100; i++) {
+        Tuple point = Tuple::Point(i*0.13f, i*0.29f - 4.0f, 1.5f);
+        Tuple moved = Perturb::jitter(point, 0.25f);
+        ASSERT_LE(std::fabs(moved.x - point.x), 0.25f);
+        ASSERT_LE(std::fabs(moved.y - point.y), 0.25f);
+        ASSERT_LE(std::fabs(moved.z - point.z), 0.25f);
+        ASSERT_EQ(moved.w, 1.0f);
+    }
+    ASSERT_TRUE(Perturb::jitter(Tuple::Point(1.3f, 0.2f, 0.7f), 0.0f) == Tuple::Point(1.3f, 0.2f, 0.7f));
+}
+
+TEST_F(NoisePattern_test, perturb_looks_up_the_wrapped_pattern_at_the_jittered_point) {
+    Stripe stripe(pool, white, black);
+    stripe.transform = scaling(0.5f, 1.0f, 1.0f);
+    Perturb perturb(stripe, 0.4f);
+
+    std::vector<Tuple> points;
+    for (int i = 0; i < 50; i++) {
+        Tuple point = Tuple::Point(i*0.11f, 0.3f, i*0.07f);
+        points.push_back(point);
+        ASSERT_TRUE(perturb.colorAt(point) == stripe.colorAt(inverse(Matrix(stripe.transform)) * Perturb::jitter(point, 0.4f)));
+    }
+
+    std::vector<Tuple> jittered = points;
+    Perturb::jitter(jittered.data(), jittered.size(), 0.4f);
+    for (std::vector<Tuple>::size_type i = 0; i < points.size(); i++) {
+        ASSERT_TRUE(jittered[i] == Perturb::jitter(points[i], 0.4f));
+    }
+}
+
+#ifdef RAYTRACER_STATS
+TEST_F(NoisePattern_test, perturb_does_not_invert_the_wrapped_transform_per_lookup) {
+    Stripe stripe(pool, white, black);
+    stripe.transform = scaling(0.5f, 1.0f, 1.0f);
+    Perturb perturb(stripe, 0.4f);
+
+    std::uint64_t inversions = threadStats[Counter::MatrixInversions];
+    for (int i = 0; i < 20; i++) {
+        perturb.colorAt(Tuple::Point(i*0.11f, 0.3f, i*0.07f));
+    }
+    ASSERT_EQ(threadStats[Counter::MatrixInversions], inversions);
+}
+#endif
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+#include "Noise.h"
+
+class Noise_test: public ::testing::Test {
+public:
+    std::vector<float> x, y, z;
+
+    void SetUp() override {
+        //a count that is not a multiple of 8 takes the scalar tail as well
+        for (int i = 0; i < 1003; i++) {
+            x.push_back(std::sin(i*1.37f)*40.0f);
+            y.push_back(std::cos(i*0.71f)*25.0f - 3.0f);
+            z.push_back(i*0.031f - 11.0f);
+        }
+    }
+
+    void TearDown() override {
+        enableNoiseAVX2(true);
+    }
+};
+
+TEST_F(Noise_test, matches_the_reference_implementation) {
+    //values of Ken Perlin's Java reference, computed in double
+    ASSERT_NEAR(perlin(3.14f, 42.0f, 7.0f), 0.136919958784f, 1e-5f);
+    ASSERT_NEAR(perlin(-1.25f, 2.5f, 0.75f), -0.161218166351f, 1e-6f);
+    ASSERT_EQ(perlin(0.5f, 0.5f, 0.5f), -0.25f);
+}
+
+TEST_F(Noise_test, noise_is_zero_on_the_lattice) {
+    ASSERT_EQ(perlin(0.0f, 0.0f, 0.0f), 0.0f);
+    ASSERT_EQ(perlin(3.0f, -7.0f, 12.0f), 0.0f);
+    ASSERT_EQ(perlin(Tuple::Point(-255.0f, 256.0f, 1.0f)), 0.0f);
+}
+
+TEST_F(Noise_test, noise_stays_in_range) {
+    for (std::vector<float>::size_type i = 0; i < x.size(); i++) {
+        float value = perlin(x[i], y[i], z[i]);
+        ASSERT_LE(std::fabs(value), 1.0f);
+    }
+}
+
+TEST_F(Noise_test, batched_noise_matches_one_at_a_time) {
+    std::vector<float> values(x.size());
+    perlin(x.data(), y.data(), z.data(), values.data(), x.size());
+    for (std::vector<float>::size_type i = 0; i < x.size(); i++) {
+        ASSERT_EQ(values[i], perlin(x[i], y[i], z[i]));
+    }
+}
+
+TEST_F(Noise_test, avx2_and_scalar_paths_agree) {
+    std::vector<float> simd(x.size()), scalar(x.size());
+    enableNoiseAVX2(true);
+    perlin(x.data(), y.data(), z.data(), simd.data(), x.size());
+    enableNoiseAVX2(false);
+    ASSERT_FALSE(usingNoiseAVX2());
+    perlin(x.data(), y.data(), z.data(), scalar.data(), x.size());
+    for (std::vector<float>::size_type i = 0; i < x.size(); i++) {
+        ASSERT_EQ(simd[i], scalar[i]);
+    }
+}
+
+TEST_F(Noise_test, one_octave_of_fbm_is_the_noise) {
+    Tuple point = Tuple::Point(1.7f, -2.3f, 0.4f);
+    ASSERT_EQ(fbm(point, 1), perlin(point));
+    ASSERT_EQ(turbulence(point, 1), std::fabs(perlin(point)));
+}
+
+TEST_F(Noise_test, fbm_adds_octaves_at_rising_frequency) {
+    Tuple point = Tuple::Point(1.7f, -2.3f, 0.4f);
+    float expected = perlin(point) + 0.5f*perlin(point.x*2.0f, point.y*2.0f, point.z*2.0f) +
+                     0.25f*perlin(point.x*4.0f, point.y*4.0f, point.z*4.0f);
+    ASSERT_FLOAT_EQ(fbm(point, 3), expected);
+}
+
+TEST_F(Noise_test, batched_fbm_and_turbulence_match_one_at_a_time) {
+    std::vector<Tuple> points;
+    for (std::vector<float>::size_type i = 0; i < x.size(); i++) {
+        points.push_back(Tuple::Point(x[i], y[i], z[i]));
+    }
+    //more octaves than lanes in one pass
+    std::vector<float> values(points.size());
+    fbm(points.data(), values.data(), points.size(), 11, 1.9f, 0.6f);
+    for (std::vector<Tuple>::size_type i = 0; i < points.size(); i++) {
+        ASSERT_EQ(values[i], fbm(points[i], 11, 1.9f, 0.6f));
+    }
+    turbulence(points.data(), values.data(), points.size(), 5);
+    for (std::vector<Tuple>::size_type i = 0; i < points.size(); i++) {
+        ASSERT_EQ(values[i], turbulence(points[i], 5));
+        ASSERT_GE(values[i], 0.0f);
+    }
+}
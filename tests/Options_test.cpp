@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#include "Options.h"
+
+TEST(Options_test, defaults_render_the_demo_scene) {
+    char const* argv[] = {"RayTracer"};
+    Options options = parseOptions(1, argv);
+
+    ASSERT_TRUE(options.scenePath.empty());
+    ASSERT_EQ(options.outputPath, "render.ppm");
+    ASSERT_EQ(options.render.samples, 1);
+    ASSERT_EQ(options.render.maxBounces, 3);
+}
+
+TEST(Options_test, parses_render_knobs) {
+    char const* argv[] = {"RayTracer", "--width", "640", "--height", "480", "-t", "4", "-s", "16",
+                          "-b", "5", "--tile", "64", "-f", "ppm-binary", "-o", "out.ppm", "room.scene"};
+    Options options = parseOptions(18, argv);
+
+    ASSERT_EQ(options.scenePath, "room.scene");
+    ASSERT_EQ(options.outputPath, "out.ppm");
+    ASSERT_TRUE(options.format == ImageFormat::PPMBinary);
+    ASSERT_EQ(options.width, 640);
+    ASSERT_EQ(options.height, 480);
+    ASSERT_EQ(options.render.threads, 4);
+    ASSERT_EQ(options.render.samples, 16);
+    ASSERT_EQ(options.render.maxBounces, 5);
+    ASSERT_EQ(options.render.tileSize, 64);
+}
+
+TEST(Options_test, tiles_are_whole_blocks_of_the_canvas) {
+    char const* small[] = {"RayTracer", "--tile", "3"};
+    ASSERT_EQ(parseOptions(3, small).render.tileSize, Canvas::tileEdge);
+    char const* odd[] = {"RayTracer", "--tile", "20"};
+    ASSERT_EQ(parseOptions(3, odd).render.tileSize, 24);
+}
+
+TEST(Options_test, parses_the_specular_mode) {
+    char const* defaults[] = {"RayTracer"};
+    ASSERT_TRUE(parseOptions(1, defaults).render.specular == PowMode::Exact);
+
+    char const* argv[] = {"RayTracer", "--specular", "approx"};
+    ASSERT_TRUE(parseOptions(3, argv).render.specular == PowMode::Approximate);
+
+    char const* unknown[] = {"RayTracer", "--specular", "sloppy"};
+    ASSERT_THROW(parseOptions(3, unknown), std::invalid_argument);
+}
+
+TEST(Options_test, parses_the_acceleration) {
+    char const* defaults[] = {"RayTracer"};
+    ASSERT_TRUE(parseOptions(1, defaults).render.acceleration == Acceleration::BVH);
+
+    char const* argv[] = {"RayTracer", "--accel", "none"};
+    ASSERT_TRUE(parseOptions(3, argv).render.acceleration == Acceleration::None);
+
+    char const* grid[] = {"RayTracer", "--accel", "grid"};
+    ASSERT_TRUE(parseOptions(3, grid).render.acceleration == Acceleration::Grid);
+
+    char const* unknown[] = {"RayTracer", "--accel", "octree"};
+    ASSERT_THROW(parseOptions(3, unknown), std::invalid_argument);
+}
+
+TEST(Options_test, rejects_malformed_values) {
+    char const* notANumber[] = {"RayTracer", "--samples", "many"};
+    ASSERT_THROW(parseOptions(3, notANumber), std::invalid_argument);
+
+    char const* missing[] = {"RayTracer", "--threads"};
+    ASSERT_THROW(parseOptions(2, missing), std::invalid_argument);
+
+    char const* unknown[] = {"RayTracer", "--fast"};
+    ASSERT_THROW(parseOptions(2, unknown), std::invalid_argument);
+}
+
+TEST(Options_test, parses_crop_windows_and_merge_pieces) {
+    char const* argv[] = {"RayTracer", "--crop", "0,0,64,32", "--crop", "0,32,64,32", "--merge", "band@0,32"};
+    Options options = parseOptions(7, argv);
+
+    ASSERT_EQ(options.render.regions.size(), 2);
+    ASSERT_TRUE(options.render.regions[1] == RenderRegion(0, 32, 64, 32));
+    ASSERT_EQ(options.merge.size(), 1);
+    ASSERT_EQ(options.merge[0].path, "band");
+    ASSERT_EQ(options.merge[0].y, 32);
+
+    char const* short_crop[] = {"RayTracer", "--crop", "0,0,64"};
+    ASSERT_THROW(parseOptions(3, short_crop), std::invalid_argument);
+}
+
+TEST(Options_test, mmap_needs_a_binary_format) {
+    char const* pfm[] = {"RayTracer", "--mmap", "-f", "pfm"};
+    Options options = parseOptions(4, pfm);
+    ASSERT_TRUE(options.mapped);
+    ASSERT_EQ(options.outputPath, "render.pfm");
+
+    char const* plain[] = {"RayTracer", "--mmap"};
+    ASSERT_THROW(parseOptions(2, plain), std::invalid_argument);
+    char const* farm[] = {"RayTracer", "--mmap", "-f", "pfm", "--workers", "2"};
+    ASSERT_THROW(parseOptions(6, farm), std::invalid_argument);
+}
+
+TEST(Options_test, parses_the_tile_timeout) {
+    char const* defaults[] = {"RayTracer"};
+    ASSERT_EQ(parseOptions(1, defaults).farm.tileTimeout, 600000);
+
+    char const* argv[] = {"RayTracer", "--listen", "farm.sock", "--tile-timeout", "30"};
+    ASSERT_EQ(parseOptions(5, argv).farm.tileTimeout, 30000);
+}
+
+TEST(Options_test, checkpoints_need_a_local_render) {
+    char const* local[] = {"RayTracer", "--checkpoint", "frame.ckpt", "--resume"};
+    ASSERT_EQ(parseOptions(4, local).render.checkpointPath, "frame.ckpt");
+
+    char const* forked[] = {"RayTracer", "--checkpoint", "frame.ckpt", "--workers", "2"};
+    ASSERT_THROW(parseOptions(5, forked), std::invalid_argument);
+    char const* listening[] = {"RayTracer", "--checkpoint", "frame.ckpt", "--listen", "farm.sock"};
+    ASSERT_THROW(parseOptions(5, listening), std::invalid_argument);
+}
+
+TEST(Options_test, parses_tone_mapping) {
+    char const* argv[] = {"RayTracer", "--grade", "shot.pfm", "--tonemap", "aces", "--exposure", "-0.5", "--gamma", "2.2"};
+    Options options = parseOptions(9, argv);
+
+    ASSERT_EQ(options.gradePath, "shot.pfm");
+    ASSERT_TRUE(options.toneMap.op == ToneMapOperator::ACES);
+    ASSERT_FLOAT_EQ(options.toneMap.exposure, -0.5f);
+    ASSERT_FLOAT_EQ(options.toneMap.gamma, 2.2f);
+
+    char const* badGamma[] = {"RayTracer", "--gamma", "0"};
+    ASSERT_THROW(parseOptions(3, badGamma), std::invalid_argument);
+    char const* mapped[] = {"RayTracer", "--mmap", "-f", "ppm-binary", "--tonemap", "reinhard"};
+    ASSERT_THROW(parseOptions(6, mapped), std::invalid_argument);
+}
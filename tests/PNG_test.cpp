@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "PNG.h"
+#include "Canvas.h"
+
+//just enough of inflate to read back what writePNG produces: stored and fixed Huffman blocks
+class Inflater {
+public:
+    std::vector<unsigned char> const &in;
+    std::size_t position;
+    int bit;
+
+    Inflater(std::vector<unsigned char> const &in, std::size_t start) : in(in), position(start), bit(0) {};
+
+    std::uint32_t bits(int count) {
+        std::uint32_t value = 0;
+        for (int i = 0; i < count; i++) {
+            value |= ((in.at(position) >> bit) & 1) << i;
+            if (++bit == 8) {
+                bit = 0;
+                position++;
+            }
+        }
+        return value;
+    };
+
+    int symbol() {
+        std::uint32_t code = 0;
+        for (int length = 1; length <= 9; length++) {
+            code = (code << 1) | bits(1);
+            if (length == 7 && code <= 0x17) {
+                return 256 + code;
+            }
+            if (length == 8 && code >= 0x30 && code <= 0xBF) {
+                return code - 0x30;
+            }
+            if (length == 8 && code >= 0xC0 && code <= 0xC7) {
+                return 280 + code - 0xC0;
+            }
+            if (length == 9 && code >= 0x190) {
+                return 144 + code - 0x190;
+            }
+        }
+        throw std::runtime_error("bad code");
+    };
+
+    std::vector<unsigned char> inflate() {
+        static const int lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                           35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static const int lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static const int distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                             257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        static const int distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+        std::vector<unsigned char> out;
+        bool last = false;
+        while (!last) {
+            last = bits(1) == 1;
+            int type = bits(2);
+            if (type == 0) {
+                if (bit != 0) {
+                    bit = 0;
+                    position++;
+                }
+                int length = in.at(position) | (in.at(position + 1) << 8);
+                position += 4;
+                out.insert(out.end(), in.begin() + position, in.begin() + position + length);
+                position += length;
+            } else if (type == 1) {
+                for (int s = symbol(); s != 256; s = symbol()) {
+                    if (s < 256) {
+                        out.push_back(s);
+                        continue;
+                    }
+                    int length = lengthBase[s - 257] + bits(lengthExtra[s - 257]);
+                    int code = 0;
+                    for (int i = 0; i < 5; i++) {
+                        code = (code << 1) | bits(1);
+                    }
+                    int distance = distanceBase[code] + bits(distanceExtra[code]);
+                    for (int i = 0; i < length; i++) {
+                        out.push_back(out[out.size() - distance]);
+                    }
+                }
+            } else {
+                throw std::runtime_error("unexpected block type");
+            }
+        }
+        return out;
+    };
+};
+
+static std::uint32_t bigEndian(unsigned char const* p) {
+    return (std::uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+};
+
+class PNGChunk {
+public:
+    std::string type;
+    std::vector<unsigned char> data;
+};
+
+static std::vector<PNGChunk> readChunks(std::string const &png) {
+    std::vector<PNGChunk> chunks;
+    unsigned char const* bytes = reinterpret_cast<unsigned char const*>(png.data());
+    std::size_t position = 8;
+    while (position < png.size()) {
+        std::uint32_t length = bigEndian(bytes + position);
+        PNGChunk chunk;
+        chunk.type = png.substr(position + 4, 4);
+        chunk.data.assign(bytes + position + 8, bytes + position + 8 + length);
+        EXPECT_EQ(bigEndian(bytes + position + 8 + length), crc32(chunk.data.data(), length, crc32(bytes + position + 4, 4)));
+        chunks.push_back(chunk);
+        position += 12 + length;
+    }
+    return chunks;
+};
+
+//undoes the scanline filters
+static std::vector<unsigned char> unfilter(std::vector<unsigned char> const &data, int width, int height) {
+    int rowSize = width*3;
+    std::vector<unsigned char> pixels(rowSize*height);
+    for (int y = 0; y < height; y++) {
+        int filter = data.at(y*(rowSize + 1));
+        for (int i = 0; i < rowSize; i++) {
+            int a = i >= 3 ? pixels[y*rowSize + i - 3] : 0;
+            int b = y > 0 ? pixels[(y - 1)*rowSize + i] : 0;
+            int c = i >= 3 && y > 0 ? pixels[(y - 1)*rowSize + i - 3] : 0;
+            int predicted = 0;
+            if (filter == 1) {
+                predicted = a;
+            } else if (filter == 2) {
+                predicted = b;
+            } else if (filter == 3) {
+                predicted = (a + b) / 2;
+            } else if (filter == 4) {
+                int p = a + b - c;
+                int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+                predicted = pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+            }
+            pixels[y*rowSize + i] = data[y*(rowSize + 1) + 1 + i] + predicted;
+        }
+    }
+    return pixels;
+};
+
+TEST(PNG_test, checksums_match_the_reference_values) {
+    unsigned char const* text = reinterpret_cast<unsigned char const*>("123456789");
+    ASSERT_EQ(crc32(text, 9), 0xCBF43926u);
+    ASSERT_EQ(adler32(text, 9), 0x091E01DEu);
+    ASSERT_EQ(crc32(text + 4, 5, crc32(text, 4)), 0xCBF43926u);
+}
+
+TEST(PNG_test, adler32_of_pieces_combines_into_the_whole) {
+    std::vector<unsigned char> data(20000);
+    for (std::size_t i = 0; i < data.size(); i++) {
+        data[i] = (unsigned char)(i*7 + i/300);
+    }
+    std::uint32_t first = adler32(data.data(), 12345);
+    std::uint32_t second = adler32(data.data() + 12345, data.size() - 12345);
+
+    ASSERT_EQ(adler32Combine(first, second, data.size() - 12345), adler32(data.data(), data.size()));
+}
+
+TEST(PNG_test, stitched_stream_decodes_to_the_canvas) {
+    Canvas canvas{37, 70};
+    for (int y = 0; y < canvas.height; y++) {
+        for (int x = 0; x < canvas.width; x++) {
+            canvas.writePixel(x, y, Color(x/36.0f, (x + y) % 5 / 4.0f, y < 35 ? 0.5f : 2.0f));
+        }
+    }
+
+    //several threads -> several pieces stitched with sync flushes
+    std::stringstream out;
+    writePNG(out, canvas, 4);
+    std::string png = out.str();
+    ASSERT_EQ(png.substr(1, 3), "PNG");
+
+    std::vector<PNGChunk> chunks = readChunks(png);
+    ASSERT_EQ(chunks.front().type, "IHDR");
+    ASSERT_EQ(bigEndian(chunks.front().data.data()), 37u);
+    ASSERT_EQ(bigEndian(chunks.front().data.data() + 4), 70u);
+    ASSERT_EQ(chunks.back().type, "IEND");
+
+    std::vector<unsigned char> zlib;
+    for (PNGChunk const &chunk : chunks) {
+        if (chunk.type == "IDAT") {
+            zlib.insert(zlib.end(), chunk.data.begin(), chunk.data.end());
+        }
+    }
+    ASSERT_EQ((zlib[0]*256 + zlib[1]) % 31, 0);
+
+    Inflater inflater(zlib, 2);
+    std::vector<unsigned char> filtered = inflater.inflate();
+    ASSERT_EQ(filtered.size(), 70u*(37*3 + 1));
+    std::size_t trailer = inflater.position + (inflater.bit != 0 ? 1 : 0);
+    ASSERT_EQ(trailer + 4, zlib.size());
+    ASSERT_EQ(bigEndian(&zlib[trailer]), adler32(filtered.data(), filtered.size()));
+
+    std::vector<unsigned char> pixels = unfilter(filtered, 37, 70);
+    std::stringstream ppm;
+    writeBinaryPPM(ppm, canvas);
+    std::string expected = ppm.str().substr(ppm.str().size() - pixels.size());
+    ASSERT_TRUE(std::memcmp(pixels.data(), expected.data(), pixels.size()) == 0);
+}
+
+TEST(PNG_test, compresses_flat_images) {
+    Canvas canvas{200, 100};
+    canvas.fill(Color(0.2f, 0.4f, 0.6f));
+
+    std::stringstream out;
+    writePNG(out, canvas, 2);
+
+    ASSERT_LT(out.str().size(), 200u*100*3 / 20);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+
+#include "PatternPool.h"
+#include "Stripe.h"
+#include "Gradient.h"
+#include "Solid.h"
+#include "World.h"
+#include "Scene.h"
+#include "Transformations.h"
+
+//counts how many are alive, to check the pool destroys what it made
+class CountedPattern : public Pattern {
+public:
+    static int alive;
+
+    CountedPattern() {
+        alive++;
+    };
+    ~CountedPattern() {
+        alive--;
+    };
+
+    Color colorAt(Tuple const &point) override {
+        return {point.x, point.y, point.z};
+    };
+};
+
+int CountedPattern::alive = 0;
+
+TEST(PatternPool_test, patterns_are_destroyed_with_the_pool) {
+    {
+        PatternPool pool;
+        for (int i = 0; i < 100; i++) {
+            pool.make<CountedPattern>();
+        }
+        ASSERT_EQ(pool.size(), 100);
+        ASSERT_EQ(CountedPattern::alive, 100);
+    }
+    ASSERT_EQ(CountedPattern::alive, 0);
+}
+
+TEST(PatternPool_test, clear_reuses_the_blocks) {
+    PatternPool pool;
+    for (int i = 0; i < 100; i++) {
+        pool.make<CountedPattern>();
+    }
+    int blocks = pool.blocks();
+
+    pool.clear();
+    ASSERT_EQ(pool.size(), 0);
+    ASSERT_EQ(CountedPattern::alive, 0);
+
+    for (int i = 0; i < 100; i++) {
+        pool.make<CountedPattern>();
+    }
+    ASSERT_EQ(pool.blocks(), blocks);
+}
+
+TEST(PatternPool_test, one_material_is_contiguous) {
+    PatternPool pool;
+    Solid &red = pool.make<Solid>(Color(1.0f, 0.0f, 0.0f));
+    Gradient &gradient = pool.make<Gradient>(Color(0.0f, 0.0f, 1.0f), Color(0.0f, 1.0f, 0.0f));
+    Stripe &stripe = pool.make<Stripe>(red, gradient);
+
+    std::uintptr_t first = reinterpret_cast<std::uintptr_t>(&red);
+    std::uintptr_t last = reinterpret_cast<std::uintptr_t>(&stripe) + sizeof(Stripe);
+    ASSERT_EQ(pool.blocks(), 1);
+    ASSERT_LE(last - first, sizeof(Solid) + sizeof(Gradient) + sizeof(Stripe) + 2*alignof(Stripe));
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(&stripe) % alignof(Stripe), 0u);
+    ASSERT_EQ(pool[2], &stripe);
+}
+
+TEST(PatternPool_test, color_children_are_made_in_the_pool) {
+    PatternPool pool;
+    Stripe &stripe = pool.make<Stripe>(pool, Color(1.0f, 1.0f, 1.0f), Color(0.0f, 0.0f, 0.0f));
+    ASSERT_EQ(pool.size(), 3);
+    ASSERT_EQ(pool[0], stripe.patternA);
+    ASSERT_EQ(pool[1], stripe.patternB);
+    ASSERT_TRUE(static_cast<Solid*>(stripe.patternB)->color == Color(0.0f, 0.0f, 0.0f));
+
+    //the stripe, its children and their transforms share one block
+    std::uintptr_t first = reinterpret_cast<std::uintptr_t>(&stripe);
+    std::uintptr_t last = reinterpret_cast<std::uintptr_t>(stripe.patternB) + sizeof(Solid);
+    ASSERT_EQ(pool.blocks(), 1);
+    ASSERT_LE(last - first, sizeof(Stripe) + 2*sizeof(Solid) + 2*alignof(Solid));
+}
+
+TEST(PatternPool_test, transforms_are_stored_in_the_pattern) {
+    PatternPool pool;
+    Solid &solid = pool.make<Solid>(Color(1.0f, 0.0f, 0.0f));
+    solid.transform = scaling(2.0f, 2.0f, 2.0f);
+    ASSERT_EQ(sizeof(PatternTransform), 32*sizeof(float));
+    ASSERT_EQ(solid.transform.values[0], 2.0f);
+    ASSERT_EQ(solid.transform.values[15], 1.0f);
+    ASSERT_TRUE(solid.transform == scaling(2.0f, 2.0f, 2.0f));
+}
+
+TEST(PatternPool_test, copies_of_a_world_share_its_patterns) {
+    std::unique_ptr<Scene> scene = Scene::DemoScene();
+    World copy = scene->world;
+    ASSERT_EQ(copy.patterns, scene->world.patterns);
+    //the grid with its two Solid children, and the gradient
+    ASSERT_EQ(scene->world.patterns->size(), 4);
+}
@@ -49,4 +49,19 @@ TEST_F(Pattern_test, pattern_with_both_pattern_and_object_transformation) {
     sphere.material.setPattern(*pattern);
 
     ASSERT_TRUE(sphere.colorAt(Tuple::Point(2.5f, 3.0f, 3.5f)) ==  Color(0.75f, 0.5f, 0.25f));
-}
\ No newline at end of file
+}
+
+TEST_F(Pattern_test, the_inverse_is_kept_with_the_transform) {
+    TestPattern pattern;
+    Matrix transform = translation(0.5f, 1.0f, 1.5f) * rotation_y(0.3f) * scaling(2.0f, 1.0f, 0.5f);
+    pattern.transform = transform;
+
+    Tuple point = Tuple::Point(0.7f, -1.2f, 3.1f);
+    ASSERT_TRUE(inverse(pattern.transform) == inverse(transform));
+    Tuple expected = inverse(transform) * point;
+    Tuple local = pattern.transform.toPattern(point);
+    ASSERT_EQ(local.x, expected.x);
+    ASSERT_EQ(local.y, expected.y);
+    ASSERT_EQ(local.z, expected.z);
+    ASSERT_EQ(local.w, expected.w);
+}
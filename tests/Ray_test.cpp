@@ -151,3 +151,32 @@ TEST(Ray_test, intersect_a_translated_sphere_with_a_ray) {
 
     ASSERT_EQ(intersections.size(), 0);
 }
+
+TEST(Ray_test, a_ray_precomputes_its_reciprocal_direction_and_signs) {
+    Ray ray(Tuple::Point(0.0f, 0.0f, 0.0f), Tuple::Vector(2.0f, -4.0f, 0.0f));
+
+    ASSERT_EQ(ray.invDirection.x, 0.5f);
+    ASSERT_EQ(ray.invDirection.y, -0.25f);
+    ASSERT_EQ(ray.invDirection.z, std::numeric_limits<float>::infinity());
+    ASSERT_EQ(ray.sign[0], 0);
+    ASSERT_EQ(ray.sign[1], 1);
+    ASSERT_EQ(ray.sign[2], 0);
+
+    ASSERT_EQ(ray.tMin, 0.0f);
+    ASSERT_EQ(ray.tMax, std::numeric_limits<float>::infinity());
+    ASSERT_EQ(ray.depth, 0);
+    ASSERT_TRUE(ray.type == RayType::Camera);
+}
+
+TEST(Ray_test, transforming_a_ray_keeps_its_tags_and_range) {
+    Ray ray(Tuple::Point(1.0f, 2.0f, 3.0f), Tuple::Vector(0.0f, 1.0f, 0.0f), RayType::Reflection, 2);
+    ray.tMax = 10.0f;
+
+    Ray result = transformRay(ray, scaling(2.0f, 4.0f, 6.0f));
+
+    ASSERT_TRUE(result.direction == Tuple::Vector(0.0f, 4.0f, 0.0f));
+    ASSERT_EQ(result.invDirection.y, 0.25f);
+    ASSERT_EQ(result.tMax, 10.0f);
+    ASSERT_EQ(result.depth, 2);
+    ASSERT_TRUE(result.type == RayType::Reflection);
+}
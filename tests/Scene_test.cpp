@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+
+#include "Scene.h"
+#include "NoisePattern.h"
+#include "Perturb.h"
+#include "Transformations.h"
+#include "Sphere.h"
+#include "Cylinder.h"
+#include "Cone.h"
+#include "CSG.h"
+#include "Plane.h"
+
+TEST(Scene_test, parses_camera_light_and_objects) {
+    std::istringstream input(
+        "# a comment\n"
+        "camera 40 20 1.5\n"
+        "light -10 10 -10  1 0.5 1\n"
+        "sphere\n"
+        "color 0.8 1 0.6\n"
+        "diffuse 0.7\n"
+        "plane\n"
+        "reflective 0.5 # trailing comment\n");
+
+    std::unique_ptr<Scene> scene = parseScene(input, "test");
+
+    ASSERT_EQ(scene->camera.hsize, 40);
+    ASSERT_EQ(scene->camera.vsize, 20);
+    ASSERT_EQ(scene->camera.fieldOfView, 1.5f);
+    ASSERT_TRUE(scene->world.light.position == Tuple::Point(-10.0f, 10.0f, -10.0f));
+    ASSERT_TRUE(scene->world.light.intensity == Color(1.0f, 0.5f, 1.0f));
+
+    ASSERT_EQ(scene->world.objects.size(), 2);
+    ASSERT_TRUE(dynamic_cast<Sphere*>(scene->world.objects[0]) != nullptr);
+    ASSERT_TRUE(scene->world.objects[0]->material.color == Color(0.8f, 1.0f, 0.6f));
+    ASSERT_EQ(scene->world.objects[0]->material.diffuse, 0.7f);
+    ASSERT_TRUE(dynamic_cast<Plane*>(scene->world.objects[1]) != nullptr);
+    ASSERT_EQ(scene->world.objects[1]->material.reflective, 0.5f);
+}
+
+TEST(Scene_test, the_hash_tells_scenes_apart) {
+    std::istringstream a("sphere\ncolor 1 0 0\n");
+    std::istringstream same("sphere\ncolor 1 0 0\n");
+    std::istringstream other("sphere\ncolor 1 0 0.5\n");
+
+    std::uint64_t hash = parseScene(a, "a")->hash;
+    ASSERT_EQ(parseScene(same, "same")->hash, hash);
+    ASSERT_NE(parseScene(other, "other")->hash, hash);
+}
+
+TEST(Scene_test, transformations_are_applied_in_written_order) {
+    std::istringstream input(
+        "cube\n"
+        "scale 2 2 2\n"
+        "translate 1 0 0\n");
+
+    std::unique_ptr<Scene> scene = parseScene(input, "test");
+
+    ASSERT_TRUE(scene->world.objects[0]->transform == translation(1.0f, 0.0f, 0.0f) * scaling(2.0f, 2.0f, 2.0f));
+}
+
+TEST(Scene_test, patterns_are_owned_by_the_world) {
+    std::istringstream input(
+        "sphere\n"
+        "pattern stripe 1 1 1  0 0 0\n"
+        "pattern-scale 0.5 0.5 0.5\n");
+
+    std::unique_ptr<Scene> scene = parseScene(input, "test");
+
+    //the stripe's two colors are Solid children made before it
+    PatternPool &patterns = *scene->world.patterns;
+    ASSERT_EQ(patterns.size(), 3);
+    ASSERT_EQ(scene->world.objects[0]->material.pattern, patterns[2]);
+    ASSERT_TRUE(patterns[2]->transform == scaling(0.5f, 0.5f, 0.5f));
+}
+
+TEST(Scene_test, perturb_wraps_the_pattern_so_far) {
+    std::istringstream input(
+        "sphere\n"
+        "pattern fbm 1 1 1  0 0 0 6\n"
+        "pattern-perturb 0.2\n"
+        "pattern-scale 0.5 0.5 0.5\n");
+
+    std::unique_ptr<Scene> scene = parseScene(input, "test");
+
+    PatternPool &patterns = *scene->world.patterns;
+    ASSERT_EQ(patterns.size(), 2);
+    NoisePattern* noise = dynamic_cast<NoisePattern*>(patterns[0]);
+    Perturb* perturb = dynamic_cast<Perturb*>(patterns[1]);
+    ASSERT_NE(noise, nullptr);
+    ASSERT_NE(perturb, nullptr);
+    ASSERT_EQ(noise->type, NoiseType::FBM);
+    ASSERT_EQ(noise->octaves, 6);
+    ASSERT_EQ(perturb->pattern, noise);
+    ASSERT_EQ(perturb->amount, 0.2f);
+    ASSERT_EQ(scene->world.objects[0]->material.pattern, perturb);
+    ASSERT_TRUE(perturb->transform == scaling(0.5f, 0.5f, 0.5f));
+}
+
+TEST(Scene_test, cylinders_and_cones_take_an_extent) {
+    std::istringstream input(
+        "cylinder\n"
+        "minimum 0\n"
+        "maximum 2.5\n"
+        "closed\n"
+        "cone\n"
+        "maximum 1\n"
+        "disk\n");
+
+    std::unique_ptr<Scene> scene = parseScene(input, "test");
+
+    ASSERT_EQ(scene->world.objects.size(), 3);
+    Cylinder* cylinder = dynamic_cast<Cylinder*>(scene->world.objects[0]);
+    Cone* cone = dynamic_cast<Cone*>(scene->world.objects[1]);
+    ASSERT_NE(cylinder, nullptr);
+    ASSERT_NE(cone, nullptr);
+    ASSERT_EQ(cylinder->minimum, 0.0f);
+    ASSERT_EQ(cylinder->maximum, 2.5f);
+    ASSERT_TRUE(cylinder->closed);
+    ASSERT_EQ(cone->maximum, 1.0f);
+    ASSERT_FALSE(cone->closed);
+
+    std::istringstream sphere("sphere\nclosed\n");
+    ASSERT_THROW(parseScene(sphere, "test"), std::runtime_error);
+}
+
+TEST(Scene_test, csg_combines_the_two_objects_above) {
+    std::istringstream input(
+        "sphere\n"
+        "cube\n"
+        "scale 0.5 0.5 0.5\n"
+        "difference\n"
+        "translate 0 1 0\n"
+        "plane\n");
+
+    std::unique_ptr<Scene> scene = parseScene(input, "test");
+
+    ASSERT_EQ(scene->world.objects.size(), 2);
+    CSG* csg = dynamic_cast<CSG*>(scene->world.objects[0]);
+    ASSERT_NE(csg, nullptr);
+    ASSERT_EQ(csg->operation, CSGOperation::Difference);
+    ASSERT_NE(dynamic_cast<Sphere*>(csg->left), nullptr);
+    ASSERT_TRUE(csg->right->transform == scaling(0.5f, 0.5f, 0.5f));
+    ASSERT_TRUE(csg->transform == translation(0.0f, 1.0f, 0.0f));
+    ASSERT_EQ(scene->objects.size(), 4);
+
+    std::istringstream lonely("sphere\nunion\n");
+    ASSERT_THROW(parseScene(lonely, "test"), std::runtime_error);
+
+    //shading reads the children's materials, the node's would be ignored
+    std::istringstream colored("sphere\ncube\nunion\ncolor 1 0 0\n");
+    ASSERT_THROW(parseScene(colored, "test"), std::runtime_error);
+    std::istringstream patterned("sphere\ncube\nintersection\npattern-scale 2 2 2\n");
+    ASSERT_THROW(parseScene(patterned, "test"), std::runtime_error);
+}
+
+TEST(Scene_test, errors_report_the_line) {
+    std::istringstream input(
+        "sphere\n"
+        "wobble 1\n");
+
+    try {
+        parseScene(input, "broken.scene");
+        FAIL();
+    } catch (std::runtime_error const &e) {
+        ASSERT_EQ(std::string(e.what()), "broken.scene:2: unknown statement 'wobble'");
+    }
+}
+
+TEST(Scene_test, camera_sizes_are_positive_integers) {
+    for (std::string size : {"0 20", "40 -3", "40.5 20", "1e3 20", "40 big", "40"}) {
+        std::istringstream input("\ncamera " + size + " 1.5\n");
+        try {
+            parseScene(input, "size.scene");
+            FAIL() << size;
+        } catch (std::runtime_error const &e) {
+            ASSERT_EQ(std::string(e.what()).substr(0, 13), "size.scene:2:") << size;
+        }
+    }
+
+    std::istringstream fractional("camera 40.5 20 1.5\n");
+    try {
+        parseScene(fractional, "size.scene");
+        FAIL();
+    } catch (std::runtime_error const &e) {
+        ASSERT_EQ(std::string(e.what()), "size.scene:1: camera width expects an integer, got '40.5'");
+    }
+}
+
+TEST(Scene_test, demo_scene_has_four_objects) {
+    std::unique_ptr<Scene> scene = Scene::DemoScene();
+
+    ASSERT_EQ(scene->world.objects.size(), 4);
+    ASSERT_EQ(scene->camera.hsize, 1024);
+    ASSERT_EQ(scene->camera.vsize, 720);
+}
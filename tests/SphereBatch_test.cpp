@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "SphereBatch.h"
+#include "FlatScene.h"
+#include "Sphere.h"
+#include "Plane.h"
+#include "Transformations.h"
+
+class SphereBatch_test: public ::testing::Test { 
+public: 
+    //20 spheres: two full batches of 8 and a scalar tail
+    std::vector<std::unique_ptr<Sphere>> spheres;
+    SphereBatch batch;
+    std::vector<Ray> rays;
+
+    void SetUp() override {
+        for (int i = 0; i < 20; i++) {
+            Sphere* sphere = new Sphere();
+            sphere->setTransformation(translation(std::sin(i*1.7f)*4.0f, std::cos(i*0.9f)*2.0f, i*0.5f) *
+                                      rotation_z(i*0.3f) * scaling(0.3f + (i % 4)*0.2f, 0.5f, 0.4f + (i % 3)*0.3f) *
+                                      shearing(0.1f*(i % 2), 0.0f, 0.0f, 0.0f, 0.0f, 0.0f));
+            spheres.emplace_back(sphere);
+            batch.add(sphere, inverse(sphere->transform));
+        }
+        for (int i = 0; i < 200; i++) {
+            Tuple origin = Tuple::Point(std::sin(i*0.37f)*5.0f, std::cos(i*0.23f)*3.0f, -8.0f + (i % 5));
+            Tuple target = Tuple::Point(std::sin(i*0.11f)*4.0f, std::cos(i*0.53f)*2.0f, 5.0f);
+            rays.push_back(Ray(origin, normalize(target - origin)));
+        }
+    }
+
+    void TearDown() override {
+        SphereBatch::enableAVX(true);
+    }
+
+    void expectSameAsSpheres() {
+        int hits = 0;
+        for (Ray const &ray : rays) {
+            std::vector<Intersection> expected;
+            for (auto const &sphere : spheres) {
+                std::vector<Intersection> local = sphere->intersects(ray);
+                expected.insert(expected.end(), local.begin(), local.end());
+            }
+            std::vector<Intersection> actual;
+            batch.intersect(ray, actual);
+
+            ASSERT_EQ(actual.size(), expected.size());
+            for (std::vector<Intersection>::size_type i = 0; i < actual.size(); i++) {
+                ASSERT_EQ(actual[i].object, expected[i].object);
+                ASSERT_EQ(actual[i].t, expected[i].t);
+            }
+
+            float nearest = expected.empty() ? std::numeric_limits<float>::infinity() : hit(expected).t;
+            ASSERT_EQ(batch.nearest(ray), nearest);
+            hits += expected.size();
+        }
+        ASSERT_GT(hits, 100);
+    }
+};
+
+TEST_F(SphereBatch_test, matches_the_sphere_class) {
+    expectSameAsSpheres();
+}
+
+TEST_F(SphereBatch_test, scalar_path_matches_the_sphere_class) {
+    SphereBatch::enableAVX(false);
+    ASSERT_FALSE(SphereBatch::usingAVX());
+    expectSameAsSpheres();
+}
+
+TEST_F(SphereBatch_test, flat_scene_nearest_hit_is_what_hit_picks) {
+    Plane floor;
+    floor.setTransformation(translation(0.0f, -1.5f, 0.0f));
+    std::vector<Object*> objects = {&floor};
+    for (auto const &sphere : spheres) {
+        objects.push_back(sphere.get());
+    }
+    FlatScene flat(objects, PowMode::Exact, Acceleration::None);
+    ASSERT_EQ(flat.sphereBatch.size(), 20);
+    FlatScene withBVH(objects);
+    ASSERT_EQ(withBVH.sphereBatch.size(), 0);
+
+    for (Ray const &ray : rays) {
+        std::vector<Intersection> intersections;
+        flat.intersect(ray, intersections);
+        float expected = intersections.empty() ? std::numeric_limits<float>::infinity() : hit(intersections).t;
+        ASSERT_EQ(flat.nearestHit(ray), expected);
+        ASSERT_EQ(withBVH.nearestHit(ray), expected);
+    }
+}
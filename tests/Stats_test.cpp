@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <sstream>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "Stats.h"
+#include "Camera.h"
+#include "World.h"
+#include "Transformations.h"
+
+TEST(Stats_test, merge_adds_counters) {
+    RenderStats a, b;
+    a.reset();
+    b.reset();
+    a.counters[(int)Counter::ShadowRays] = 2;
+    b.counters[(int)Counter::ShadowRays] = 3;
+    b.counters[(int)Counter::PrimaryRays] = 1;
+
+    a.merge(b);
+
+    ASSERT_EQ(a[Counter::ShadowRays], 5);
+    ASSERT_EQ(a[Counter::PrimaryRays], 1);
+    ASSERT_EQ(a.rays(), 6);
+}
+
+TEST(Stats_test, json_lists_every_counter) {
+    RenderStats stats;
+    stats.reset();
+    stats.counters[(int)Counter::LightingCalls] = 7;
+
+    std::stringstream json;
+    writeStatsJSON(json, stats);
+
+    ASSERT_EQ(json.str(), "{\"primary_rays\": 0, \"shadow_rays\": 0, \"reflection_rays\": 0, \"refraction_rays\": 0, "
+                          "\"intersection_tests\": 0, \"matrix_inversions\": 0, \"lighting_calls\": 7, \"pattern_evaluations\": 0, "
+                          "\"texture_tile_loads\": 0}\n");
+}
+
+#ifdef RAYTRACER_STATS
+TEST(Stats_test, render_merges_the_counters_of_every_thread) {
+    World world = World::DefaultWorld();
+    Camera camera(11, 11, M_PI/2);
+    camera.transform = viewTransformation(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Point(0.0f, 0.0f, 0.0f), Tuple::Vector(0.0f, 1.0f, 0.0f));
+
+    //every object against every ray, which the counts below rely on
+    RenderSettings settings(3, 2, 3, 4);
+    settings.acceleration = Acceleration::None;
+    render(camera, world, settings);
+    RenderStats stats = renderStats();
+
+    ASSERT_EQ(stats[Counter::PrimaryRays], 11*11*2);
+    ASSERT_EQ(stats[Counter::LightingCalls], stats[Counter::ShadowRays]);
+    ASSERT_EQ(stats[Counter::IntersectionTests], world.objects.size() * (stats[Counter::PrimaryRays] + stats[Counter::ShadowRays]));
+    ASSERT_GT(stats[Counter::MatrixInversions], 0);
+}
+#endif
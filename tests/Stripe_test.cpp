@@ -10,10 +10,11 @@ class Stripe_test: public ::testing::Test {
 public: 
     const Color black = Color(0.0f, 0.0f, 0.0f);
     const Color white = Color(1.0f, 1.0f, 1.0f);
+    PatternPool pool;
 };
 
 TEST_F(Stripe_test, stripe_pattern_is_constant_in_y) {
-    Stripe stripe(white, black);
+    Stripe stripe(pool, white, black);
 
     ASSERT_TRUE(stripe.colorAt(Tuple::Point(0.0f, 0.0f, 0.0f)) == white);
     ASSERT_TRUE(stripe.colorAt(Tuple::Point(0.0f, 1.0f, 0.0f)) == white);
@@ -21,7 +22,7 @@ TEST_F(Stripe_test, stripe_pattern_is_constant_in_y) {
 }
 
 TEST_F(Stripe_test, stripe_pattern_is_constant_in_z) {
-    Stripe stripe(white, black);
+    Stripe stripe(pool, white, black);
 
     ASSERT_TRUE(stripe.colorAt(Tuple::Point(0.0f, 0.0f, 0.0f)) == white);
     ASSERT_TRUE(stripe.colorAt(Tuple::Point(0.0f, 0.0f, 1.0f)) == white);
@@ -29,7 +30,7 @@ TEST_F(Stripe_test, stripe_pattern_is_constant_in_z) {
 }
 
 TEST_F(Stripe_test, stripe_pattern_alternates_in_x) {
-    Stripe stripe(white, black);
+    Stripe stripe(pool, white, black);
 
     ASSERT_TRUE(stripe.colorAt(Tuple::Point(0.0f, 0.0f, 0.0f)) == white);
     ASSERT_TRUE(stripe.colorAt(Tuple::Point(0.9f, 0.0f, 0.0f)) == white);
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TextureCache.h"
+#include "Canvas.h"
+
+class TextureCache_test: public ::testing::Test { 
+public: 
+    Canvas image = Canvas(70, 40);
+
+    void SetUp() override {
+        for (int y = 0; y < image.height; y++) {
+            for (int x = 0; x < image.width; x++) {
+                image.writePixel(x, y, Color(x / 70.0f, y / 40.0f, (x + y) % 2));
+            }
+        }
+    }
+};
+
+TEST_F(TextureCache_test, builds_the_mip_chain) {
+    TextureCache cache;
+    int texture = cache.add(image);
+
+    //70x40, 35x20, 18x10, 9x5, 5x3, 3x2, 2x1, 1x1
+    ASSERT_EQ(cache.levels(texture), 8);
+    ASSERT_EQ(cache.width(texture, 2), 18);
+    ASSERT_EQ(cache.height(texture, 2), 10);
+    ASSERT_EQ(cache.width(texture, 7), 1);
+
+    for (int y = 0; y < image.height; y++) {
+        for (int x = 0; x < image.width; x++) {
+            ASSERT_TRUE(cache.texel(texture, 0, x, y) == image.pixelAt(x, y));
+        }
+    }
+    Color average = (image.pixelAt(2, 4) + image.pixelAt(3, 4) + image.pixelAt(2, 5) + image.pixelAt(3, 5)) * 0.25f;
+    ASSERT_TRUE(cache.texel(texture, 1, 1, 2) == average);
+}
+
+TEST_F(TextureCache_test, texel_coordinates_wrap) {
+    TextureCache cache;
+    int texture = cache.add(image);
+
+    ASSERT_TRUE(cache.texel(texture, 0, -1, 0) == image.pixelAt(69, 0));
+    ASSERT_TRUE(cache.texel(texture, 0, 70, 41) == image.pixelAt(0, 1));
+}
+
+TEST_F(TextureCache_test, footprints_wrap_or_clamp_at_the_edges) {
+    TextureCache cache;
+    int texture = cache.add(image);
+    Color texels[4];
+
+    //straddles the tiles at x = 32 and y = 32
+    cache.footprint(texture, 0, 31, 31, true, texels);
+    ASSERT_TRUE(texels[0] == image.pixelAt(31, 31));
+    ASSERT_TRUE(texels[1] == image.pixelAt(32, 31));
+    ASSERT_TRUE(texels[2] == image.pixelAt(31, 32));
+    ASSERT_TRUE(texels[3] == image.pixelAt(32, 32));
+    ASSERT_EQ(cache.tileLoads(), 4u);
+
+    cache.footprint(texture, 0, 69, 39, true, texels);
+    ASSERT_TRUE(texels[1] == image.pixelAt(0, 39));
+    ASSERT_TRUE(texels[3] == image.pixelAt(0, 0));
+
+    cache.footprint(texture, 0, 69, 39, false, texels);
+    ASSERT_TRUE(texels[1] == image.pixelAt(69, 39));
+    ASSERT_TRUE(texels[3] == image.pixelAt(69, 39));
+    cache.footprint(texture, 0, -1, 0, false, texels);
+    ASSERT_TRUE(texels[0] == image.pixelAt(0, 0));
+}
+
+TEST_F(TextureCache_test, threads_share_a_sharded_cache) {
+    Canvas large(512, 512, CanvasLayout::RowMajor);
+    for (int y = 0; y < large.height; y++) {
+        for (int x = 0; x < large.width; x++) {
+            large.writePixel(x, y, Color(x / 512.0f, y / 512.0f, 0.5f));
+        }
+    }
+    TextureCache cache;
+    int texture = cache.add(large);
+
+    std::vector<std::thread> threads;
+    std::vector<int> wrong(4, 0);
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            for (int y = t; y < large.height; y += 3) {
+                for (int x = 0; x < large.width; x += 5) {
+                    wrong[t] += !(cache.texel(texture, 0, x, y) == large.pixelAt(x, y));
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (int count : wrong) {
+        ASSERT_EQ(count, 0);
+    }
+    //the 16x16 tiles of level 0 fit, a thread reading one another just read keeps the first copy
+    ASSERT_EQ(cache.resident(), 256u*TextureCache::tileEdge*TextureCache::tileEdge*3*sizeof(float));
+}
+
+TEST_F(TextureCache_test, stays_within_its_budget) {
+    std::size_t tileBytes = TextureCache::tileEdge*TextureCache::tileEdge*3*sizeof(float);
+    TextureCache cache(2*tileBytes);
+    int texture = cache.add(image);
+
+    //level 0 is 3x2 tiles, visit all of them twice
+    for (int pass = 0; pass < 2; pass++) {
+        for (int y = 0; y < image.height; y += TextureCache::tileEdge) {
+            for (int x = 0; x < image.width; x += TextureCache::tileEdge) {
+                ASSERT_TRUE(cache.texel(texture, 0, x, y) == image.pixelAt(x, y));
+                ASSERT_LE(cache.resident(), 2*tileBytes);
+            }
+        }
+    }
+    //a walk over all six evicts every tile before it comes back to it
+    ASSERT_EQ(cache.tileLoads(), 12u);
+
+    //hits do not load again
+    cache.texel(texture, 0, 69, 39);
+    cache.texel(texture, 0, 68, 38);
+    ASSERT_EQ(cache.tileLoads(), 12u);
+}
+
+TEST_F(TextureCache_test, streamed_loads_match_images_in_memory) {
+    //more than one band of rows, with odd sizes down the chain
+    Canvas large(101, 77);
+    for (int y = 0; y < large.height; y++) {
+        for (int x = 0; x < large.width; x++) {
+            large.writePixel(x, y, Color(x / 100.0f, y / 76.0f, (x*y) % 3));
+        }
+    }
+    TextureCache cache;
+    int inMemory = cache.add(large);
+
+    for (ImageFormat format : {ImageFormat::PFM, ImageFormat::PPMBinary}) {
+        std::string path = ::testing::TempDir() + "texture_cache_stream" + imageFormatExtension(format);
+        writeImage(large, path, format);
+        int expected = format == ImageFormat::PFM ? inMemory : cache.add(readImage(path));
+        int streamed = cache.load(path);
+        std::remove(path.c_str());
+
+        ASSERT_EQ(cache.levels(streamed), cache.levels(expected));
+        for (int level = 0; level < cache.levels(streamed); level++) {
+            for (int y = 0; y < cache.height(streamed, level); y++) {
+                for (int x = 0; x < cache.width(streamed, level); x++) {
+                    Color a = cache.texel(streamed, level, x, y);
+                    Color b = cache.texel(expected, level, x, y);
+                    ASSERT_EQ(a.red, b.red);
+                    ASSERT_EQ(a.green, b.green);
+                    ASSERT_EQ(a.blue, b.blue);
+                }
+            }
+        }
+    }
+}
+
+TEST_F(TextureCache_test, loads_images_once_and_cleans_up) {
+    std::string path = ::testing::TempDir() + "texture_cache_test.ppm";
+    writeImage(image, path, ImageFormat::PPMBinary);
+
+    {
+        TextureCache cache;
+        int texture = cache.load(path);
+        ASSERT_EQ(cache.load(path), texture);
+        ASSERT_EQ(cache.width(texture, 0), 70);
+        ASSERT_NEAR(cache.texel(texture, 0, 35, 20).red, 0.5f, 1.0f/255.0f);
+    }
+    std::remove(path.c_str());
+
+    TextureCache cache;
+    ASSERT_THROW(cache.load(path), std::runtime_error);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+
+#include "ToneMap.h"
+#include "Canvas.h"
+
+TEST(ToneMap_test, default_settings_leave_the_canvas_alone) {
+    Canvas canvas{2, 1};
+    canvas.writePixel(0, 0, Color(4.0f, 0.5f, -1.0f));
+
+    ToneMapSettings settings;
+    ASSERT_TRUE(settings.identity());
+    toneMap(canvas, settings);
+
+    ASSERT_TRUE(canvas.pixelAt(0, 0) == Color(4.0f, 0.5f, -1.0f));
+}
+
+TEST(ToneMap_test, exposure_is_in_stops) {
+    Canvas canvas{1, 1};
+    canvas.writePixel(0, 0, Color(0.25f, 0.5f, 1.0f));
+
+    toneMap(canvas, ToneMapSettings(ToneMapOperator::None, 1.0f));
+
+    ASSERT_TRUE(canvas.pixelAt(0, 0) == Color(0.5f, 1.0f, 2.0f));
+}
+
+TEST(ToneMap_test, reinhard_compresses_highlights_below_one) {
+    Canvas canvas{1, 1};
+    canvas.writePixel(0, 0, Color(1.0f, 3.0f, 1000.0f));
+
+    toneMap(canvas, ToneMapSettings(ToneMapOperator::Reinhard));
+
+    Color color = canvas.pixelAt(0, 0);
+    ASSERT_FLOAT_EQ(color.red, 0.5f);
+    ASSERT_FLOAT_EQ(color.green, 0.75f);
+    ASSERT_LT(color.blue, 1.0f);
+}
+
+TEST(ToneMap_test, aces_maps_black_to_black_and_saturates) {
+    Canvas canvas{1, 1};
+    canvas.writePixel(0, 0, Color(0.0f, 0.18f, 100.0f));
+
+    toneMap(canvas, ToneMapSettings(ToneMapOperator::ACES));
+
+    Color color = canvas.pixelAt(0, 0);
+    ASSERT_FLOAT_EQ(color.red, 0.0f);
+    ASSERT_NEAR(color.green, 0.267f, 0.001f);
+    ASSERT_FLOAT_EQ(color.blue, 1.0f);
+}
+
+TEST(ToneMap_test, gamma_encodes_after_the_operator) {
+    Canvas canvas{1, 1};
+    canvas.writePixel(0, 0, Color(0.25f, 1.0f, 0.0f));
+
+    toneMap(canvas, ToneMapSettings(ToneMapOperator::None, 0.0f, 2.0f));
+
+    ASSERT_TRUE(canvas.pixelAt(0, 0) == Color(0.5f, 1.0f, 0.0f));
+}
+
+TEST(ToneMap_test, a_PFM_render_can_be_graded_after_the_fact) {
+    Canvas canvas{2, 2};
+    canvas.writePixel(1, 0, Color(2.0f, 0.5f, 8.0f));
+
+    std::stringstream pfm;
+    writePFM(pfm, canvas);
+    Canvas graded = readPFM(pfm);
+    toneMap(graded, ToneMapSettings(ToneMapOperator::Reinhard, -1.0f));
+
+    Color color = graded.pixelAt(1, 0);
+    ASSERT_FLOAT_EQ(color.red, 0.5f);
+    ASSERT_FLOAT_EQ(color.green, 0.2f);
+    ASSERT_FLOAT_EQ(color.blue, 0.8f);
+}
+
+TEST(ToneMap_test, operator_names) {
+    ASSERT_TRUE(toneMapOperatorFromName("aces") == ToneMapOperator::ACES);
+    ASSERT_TRUE(toneMapOperatorFromName("reinhard") == ToneMapOperator::Reinhard);
+    ASSERT_THROW(toneMapOperatorFromName("filmic"), std::invalid_argument);
+}
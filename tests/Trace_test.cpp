@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "Trace.h"
+#include "Camera.h"
+#include "World.h"
+#include "Transformations.h"
+
+static int count(std::string const &text, std::string const &needle) {
+    int n = 0;
+    for (std::string::size_type i = text.find(needle); i != std::string::npos; i = text.find(needle, i + 1)) {
+        n++;
+    }
+    return n;
+}
+
+TEST(Trace_test, disabled_spans_are_not_recorded) {
+    enableTracing(false);
+    clearTrace();
+    {
+        TraceSpan span("ignored");
+    }
+
+    std::stringstream trace;
+    writeTrace(trace);
+    ASSERT_EQ(count(trace.str(), "ignored"), 0);
+}
+
+TEST(Trace_test, render_records_one_span_per_tile) {
+    World world = World::DefaultWorld();
+    Camera camera(10, 6, M_PI/2);
+    camera.transform = viewTransformation(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Point(0.0f, 0.0f, 0.0f), Tuple::Vector(0.0f, 1.0f, 0.0f));
+
+    enableTracing(true);
+    clearTrace();
+    render(camera, world, RenderSettings(2, 1, 3, 4));
+    enableTracing(false);
+
+    std::stringstream trace;
+    writeTrace(trace);
+    std::string json = trace.str();
+
+    ASSERT_EQ(json.find("{\"traceEvents\": ["), 0);
+    ASSERT_EQ(count(json, "\"name\": \"tile\""), 6);
+    ASSERT_EQ(count(json, "\"name\": \"render\""), 1);
+    ASSERT_EQ(count(json, "\"name\": \"acceleration build\""), 1);
+    ASSERT_EQ(count(json, "\"ph\": \"X\""), 8);
+    ASSERT_EQ(count(json, "\"x\": 4, \"y\": 4"), 1);
+}
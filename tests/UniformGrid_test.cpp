@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "UniformGrid.h"
+
+//a 10x10x10 block of unit cubes one apart, the voxel-like case the grid is meant for
+static std::vector<Bounds> voxels() {
+    std::vector<Bounds> boxes;
+    for (int z = 0; z < 10; z++) {
+        for (int y = 0; y < 10; y++) {
+            for (int x = 0; x < 10; x++) {
+                Tuple corner = Tuple::Point(x*2.0f, y*2.0f, z*2.0f);
+                boxes.push_back(Bounds(corner, corner + Tuple::Vector(1.0f, 1.0f, 1.0f)));
+            }
+        }
+    }
+    return boxes;
+};
+
+TEST(UniformGrid_test, an_empty_grid_visits_nothing) {
+    UniformGrid grid;
+    grid.build({});
+    ASSERT_EQ(grid.cells(), 1);
+
+    int visits = 0;
+    float tMax = std::numeric_limits<float>::infinity();
+    grid.traverse(Ray(Tuple::Point(0, 0, 0), Tuple::Vector(0, 0, 1)), 0.0f, tMax, [&visits](int) { visits++; });
+    ASSERT_EQ(visits, 0);
+}
+
+TEST(UniformGrid_test, the_resolution_follows_the_primitive_count) {
+    UniformGrid grid;
+    grid.build(voxels());
+
+    ASSERT_GE(grid.cells(), 1000);
+    ASSERT_LE(grid.cells(), 4*UniformGrid::cellsPerPrimitive*1000);
+    ASSERT_EQ(grid.resolution[0], grid.resolution[1]);
+    ASSERT_EQ(grid.resolution[1], grid.resolution[2]);
+    ASSERT_EQ(grid.cellStart.back(), (int)grid.cellPrimitives.size());
+}
+
+TEST(UniformGrid_test, traversal_visits_every_box_the_ray_passes_through_once) {
+    std::vector<Bounds> boxes = voxels();
+    UniformGrid grid;
+    grid.build(boxes);
+
+    float const infinity = std::numeric_limits<float>::infinity();
+    for (int i = 0; i < 100; i++) {
+        Tuple origin = Tuple::Point(-5.0f + i*0.3f, std::sin(i*0.1f)*4.0f + 8.0f, -10.0f);
+        Tuple target = Tuple::Point(std::cos(i*0.7f)*8.0f + 10.0f, std::sin(i*0.5f)*8.0f + 10.0f, 30.0f);
+        Ray ray(origin, normalize(target - origin));
+
+        std::vector<int> visited;
+        grid.traverse(ray, -infinity, infinity, [&visited](int primitive) { visited.push_back(primitive); });
+
+        for (std::vector<Bounds>::size_type j = 0; j < boxes.size(); j++) {
+            float tmin, tmax;
+            if (slabIntersect(boxes[j], ray, tmin, tmax)) {
+                ASSERT_NE(std::find(visited.begin(), visited.end(), (int)j), visited.end());
+            }
+        }
+        //mailboxing: boxes overlapping several cells come up once
+        std::sort(visited.begin(), visited.end());
+        ASSERT_EQ(std::adjacent_find(visited.begin(), visited.end()), visited.end());
+    }
+}
+
+TEST(UniformGrid_test, axis_aligned_rays_walk_one_row_of_cells) {
+    std::vector<Bounds> boxes = voxels();
+    UniformGrid grid;
+    grid.build(boxes);
+
+    float const infinity = std::numeric_limits<float>::infinity();
+    std::vector<int> visited;
+    grid.traverse(Ray(Tuple::Point(0.5f, 0.5f, -5.0f), Tuple::Vector(0.0f, 0.0f, 1.0f)), 0.0f, infinity,
+                  [&visited](int primitive) { visited.push_back(primitive); });
+
+    //the ten cubes of the x = 0, y = 0 column
+    for (int z = 0; z < 10; z++) {
+        ASSERT_NE(std::find(visited.begin(), visited.end(), z*100), visited.end());
+    }
+    ASSERT_LT(visited.size(), 40u);
+}
+
+TEST(UniformGrid_test, shrinking_tmax_stops_the_walk) {
+    std::vector<Bounds> boxes = voxels();
+    UniformGrid grid;
+    grid.build(boxes);
+
+    Ray ray(Tuple::Point(0.5f, 0.5f, -5.0f), Tuple::Vector(0.0f, 0.0f, 1.0f));
+    float nearest = std::numeric_limits<float>::infinity();
+    std::vector<int> visited;
+    grid.traverse(ray, 0.0f, nearest, [&](int primitive) {
+        visited.push_back(primitive);
+        float tmin, tmax;
+        if (slabIntersect(boxes[primitive], ray, tmin, tmax)) {
+            nearest = std::min(nearest, tmin);
+        }
+    });
+    ASSERT_EQ(nearest, 5.0f);
+    ASSERT_EQ(std::find(visited.begin(), visited.end(), 900), visited.end());
+}
+
+TEST(UniformGrid_test, flat_scenes_still_get_cells) {
+    //a floor of tiles, all with zero height
+    std::vector<Bounds> boxes;
+    for (int i = 0; i < 100; i++) {
+        Tuple corner = Tuple::Point((i % 10)*1.0f, 0.0f, (i / 10)*1.0f);
+        boxes.push_back(Bounds(corner, corner + Tuple::Vector(0.9f, 0.0f, 0.9f)));
+    }
+    UniformGrid grid;
+    grid.build(boxes);
+    ASSERT_GT(grid.resolution[0], 1);
+    ASSERT_GT(grid.resolution[2], 1);
+
+    std::vector<int> visited;
+    float tMax = std::numeric_limits<float>::infinity();
+    grid.traverse(Ray(Tuple::Point(3.5f, 2.0f, 4.5f), Tuple::Vector(0.0f, -1.0f, 0.0f)), 0.0f, tMax,
+                  [&visited](int primitive) { visited.push_back(primitive); });
+    ASSERT_NE(std::find(visited.begin(), visited.end(), 43), visited.end());
+}
@@ -161,6 +161,28 @@ TEST(World_test, color_with_intersection_behind_the_ray) {
     ASSERT_TRUE(result == inner->material.color);
 }
 
+TEST(World_test, color_skips_hits_before_the_rays_tMin) {
+    World world = World::DefaultWorld();
+    for (Object* object : world.objects) {
+        object->material.ambient = 1.0f;
+        object->material.diffuse = 0.0f;
+        object->material.specular = 0.0f;
+    }
+    Object* outer = world.objects[0];
+    Object* inner = world.objects[1];
+
+    //the outer sphere is met at t = 4, the inner one at 4.5
+    Ray ray(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Vector(0.0f, 0.0f, 1.0f));
+    ASSERT_TRUE(colorAt(world, ray, 0) == outer->material.color);
+    ray.tMin = 4.2f;
+    ASSERT_TRUE(colorAt(world, ray, 0) == inner->material.color);
+
+    world.compile();
+    ASSERT_TRUE(colorAt(world, ray, 0) == inner->material.color);
+    ray.tMin = 0.0f;
+    ASSERT_TRUE(colorAt(world, ray, 0) == outer->material.color);
+}
+
 TEST(World_test, there_is_no_shadow_when_nothing_is_collinear_with_point_and_light) {
     World world = World::DefaultWorld();
     Tuple point = Tuple::Point(0.0f, 10.0f, 0.0f);
@@ -189,6 +211,22 @@ TEST(World_test, there_is_no_shadown_when_object_is_behind_the_point) {
     ASSERT_FALSE(world.isShadow(point));
 }
 
+TEST(World_test, a_shadow_ray_only_counts_hits_within_its_range) {
+    World world = World::DefaultWorld();
+    Ray ray(Tuple::Point(0.0f, 0.0f, -5.0f), Tuple::Vector(0.0f, 0.0f, 1.0f), RayType::Shadow);
+
+    ray.tMax = 3.0f;
+    ASSERT_FALSE(world.isShadow(ray));
+    ray.tMax = 5.0f;
+    ASSERT_TRUE(world.isShadow(ray));
+
+    world.compile();
+    ray.tMax = 3.0f;
+    ASSERT_FALSE(world.isShadow(ray));
+    ray.tMax = 5.0f;
+    ASSERT_TRUE(world.isShadow(ray));
+}
+
 TEST(World_test, reflected_color_for_non_reflective_material) {
     World world = World::DefaultWorld();
 